@@ -141,6 +141,15 @@ def create_mem_ctrl(cls, r, i, nbr_mem_ctrls, intlv_bits, intlv_size):
                                       intlvMatch = i)
     return ctrl
 
+def channel_quantum(options):
+    """The simulation quantum when the memory channels are on event
+    queues of their own: the latency of crossing into a channel, which
+    is the lookahead between the queues. The global frequency has to be
+    fixed before calling this."""
+
+    latency = m5.util.convert.anyToLatency(options.mem_crossing_latency)
+    return m5.ticks.fromSeconds(latency)
+
 def config_mem(options, system):
     """
     Create the memory controllers based on the options and attach them.
@@ -162,6 +171,8 @@ def config_mem(options, system):
                                          None)
     opt_elastic_trace_en = getattr(options, "elastic_trace_en", False)
     opt_mem_ranks = getattr(options, "mem_ranks", None)
+    opt_mem_channel_group = getattr(options, "mem_channel_group", False)
+    opt_mem_channel_eventqs = getattr(options, "mem_channel_eventqs", False)
 
     if opt_mem_type == "HMC_2500_1x32":
         HMChost = HMC.config_hmc_host_ctrl(options, system)
@@ -230,6 +241,25 @@ def config_mem(options, system):
 
     subsystem.mem_ctrls = mem_ctrls
 
+    # Optionally let a channel group per range own the channels, and
+    # connect the group to the membus instead, possibly with each
+    # channel on an event queue of its own
+    if opt_mem_channel_group and opt_mem_type != "HMC_2500_1x32":
+        groups = []
+        for i in xrange(0, len(mem_ctrls), nbr_mem_ctrls):
+            group = m5.objects.ChannelGroup()
+            group.attachChannels(mem_ctrls[i:i + nbr_mem_ctrls])
+            group.port = xbar.master
+            if opt_mem_channel_eventqs:
+                group.crossing_latency = options.mem_crossing_latency
+            groups.append(group)
+        subsystem.mem_channel_groups = groups
+
+        if opt_mem_channel_eventqs:
+            for i, mem_ctrl in enumerate(mem_ctrls):
+                mem_ctrl.eventq_index = i + 1
+        return
+
     # Connect the controllers to the membus
     for i in xrange(len(subsystem.mem_ctrls)):
         if opt_mem_type == "HMC_2500_1x32":
@@ -84,6 +84,17 @@ def addNoISAOptions(parser):
                       help = "number of memory channels")
     parser.add_option("--mem-ranks", type="int", default=None,
                       help = "number of memory ranks per channel")
+    parser.add_option("--mem-channel-group", action="store_true",
+                      help = "route to the memory channels using a "
+                      "channel group rather than the memory bus")
+    parser.add_option("--mem-channel-eventqs", action="store_true",
+                      help = "put each memory channel of a channel group "
+                      "on an event queue of its own")
+    parser.add_option("--mem-crossing-latency", type="string",
+                      default="10ns",
+                      help = "latency of a request crossing into a channel "
+                      "on an event queue of its own, also used as the "
+                      "simulation quantum")
     parser.add_option("--mem-size", action="store", type="string",
                       default="512MB",
                       help="Specify the physical memory size (single memory)")
@@ -592,6 +592,13 @@ def run(options, root, testsys, cpu_class):
     if options.take_simpoint_checkpoints != None:
         simpoints, interval_length = parseSimpointAnalysisFile(options, testsys)
 
+    # memory channels on event queues of their own synchronise once per
+    # crossing latency
+    if getattr(options, "mem_channel_group", False) and \
+           getattr(options, "mem_channel_eventqs", False):
+        m5.ticks.fixGlobalFrequency()
+        root.sim_quantum = MemConfig.channel_quantum(options)
+
     checkpoint_dir = None
     if options.checkpoint_restore:
         cpt_starttick, checkpoint_dir = findCptDir(options, cptdir, testsys)
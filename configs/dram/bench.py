@@ -0,0 +1,266 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import argparse
+import json
+import os
+import time
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+
+addToPath('../')
+
+from common import MemConfig
+
+# This script characterises the DRAM controller models in a closed
+# loop, by sweeping the offered bandwidth of a traffic generator
+# across a number of traffic patterns, and recording the loaded
+# latency, the achieved bandwidth, the row-hit rates and the per-bank
+# utilisation, as well as the host time spent simulating each
+# state. One system is created per memory type, and the memory types
+# take turns, with only one generating traffic at a time while the
+# others are idle, so that the host time of each state belongs to a
+# single memory type. The results are written to a JSON file in the
+# output directory for regression testing of the memory models and the
+# simulation speed.
+
+parser = argparse.ArgumentParser(
+  formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+
+# the DRAMCtrl base class has no timings of its own, and is left out
+dram_names = sorted([name for name in MemConfig.mem_names()
+                     if issubclass(MemConfig.get(name), DRAMCtrl) and
+                     MemConfig.get(name) is not DRAMCtrl])
+
+parser.add_argument("--mem-types", default="all",
+                    help="space-separated list of DRAMCtrl subclasses "
+                    "to characterise, or \"all\" for: %s" %
+                    " ".join(dram_names))
+
+parser.add_argument("--modes", default="LINEAR RANDOM DRAM DRAM_ROTATE",
+                    help="space-separated list of traffic generator modes")
+
+parser.add_argument("--load-list", default="1 1.25 1.5 2 3 4 8 16",
+                    help="a list of multipliers for the inter-transaction "
+                    "time, 1 offering the peak bandwidth of the memory")
+
+parser.add_argument("--rd-perc", type=int, default=100,
+                    help="Percentage of read commands")
+
+parser.add_argument("--period", type=int, default=100000000,
+                    help="time in ps spent in each traffic state")
+
+parser.add_argument("--json", default="dram_bench.json",
+                    help="name of the results file in the output directory")
+
+args = parser.parse_args()
+
+if args.mem_types == "all":
+    mem_types = dram_names
+else:
+    mem_types = args.mem_types.split()
+    for name in mem_types:
+        if name not in dram_names:
+            fatal("%s is not a DRAMCtrl subclass" % name)
+
+modes = args.modes.split()
+for mode in modes:
+    if mode not in ["LINEAR", "RANDOM", "DRAM", "DRAM_ROTATE"]:
+        fatal("Unsupported traffic generator mode %s" % mode)
+
+loads = [float(m) for m in args.load_list.split()]
+if len(loads) == 0:
+    fatal("String for load-list detected empty")
+
+# we are fine with 256 MB memory, use the entire range
+mem_range = AddrRange('256MB')
+max_addr = mem_range.end
+
+root = Root(full_system = False)
+
+# the number of traffic states per memory type, with the memory types
+# running one after the other
+nbr_states = len(modes) * len(loads)
+
+# the traffic states of each memory type, in the order they are
+# visited, and the total number of banks of each memory type
+states = {}
+banks = {}
+
+for index, name in enumerate(mem_types):
+    # each memory type gets a system of its own, with a single channel
+    # to match the assumptions in the DRAM traffic generator
+    system = System(membus = IOXBar(width = 32))
+    system.clk_domain = SrcClockDomain(clock = '2.0GHz',
+                                       voltage_domain =
+                                       VoltageDomain(voltage = '1V'))
+    system.mem_ranges = [mem_range]
+    system.mmap_using_noreserve = True
+    system.mem_mode = 'timing'
+
+    # there is no point slowing things down by saving any data
+    ctrl = MemConfig.get(name)(range = mem_range, null = True,
+                               addr_mapping = "RoRaBaCoCh")
+    system.mem_ctrl = ctrl
+    system.mem_ctrl.port = system.membus.master
+
+    nbr_banks = int(ctrl.banks_per_rank.value)
+    nbr_ranks = int(ctrl.ranks_per_channel.value)
+    burst_size = int((ctrl.devices_per_rank.value *
+                      ctrl.device_bus_width.value *
+                      ctrl.burst_length.value) / 8)
+    page_size = int(ctrl.devices_per_rank.value *
+                    ctrl.device_rowbuffer_size.value)
+    stride_size = min(512, page_size)
+    banks[name] = nbr_banks * nbr_ranks
+
+    # the inter-transaction time matching the peak bandwidth of the
+    # memory, the parameter is in seconds and we need it in ticks (ps)
+    itt_min = ctrl.tBURST.value * 1000000000000
+
+    cfg_file_name = os.path.join(m5.options.outdir, "bench_%s.cfg" % name)
+    cfg_file = open(cfg_file_name, 'w')
+
+    # stay idle while the memory types before this one are
+    # characterised
+    first_state = 0
+    if index > 0:
+        cfg_file.write("STATE 0 %d IDLE\n" % (index * nbr_states *
+                                              args.period))
+        first_state = 1
+
+    states[name] = []
+    for mode in modes:
+        for load in loads:
+            itt = int(itt_min * load)
+            line = "STATE %d %d %s %d 0 %d %d %d %d 0" % \
+                (first_state + len(states[name]), args.period, mode,
+                 args.rd_perc, max_addr, burst_size, itt, itt)
+            if mode in ["DRAM", "DRAM_ROTATE"]:
+                # use all banks and ranks, with RoRaBaCoCh mapping
+                line += " %d %d %d %d 1 %d" % \
+                    (stride_size, page_size, nbr_banks, nbr_banks,
+                     nbr_ranks)
+            cfg_file.write(line + "\n")
+            states[name].append({ "mode" : mode, "itt" : itt,
+                                  "offered_bw" : burst_size * 1e12 / itt })
+
+    # and stay idle once done
+    last_state = first_state + len(states[name])
+    cfg_file.write("STATE %d %d IDLE\n" % (last_state, args.period))
+
+    cfg_file.write("INIT 0\n")
+    for state in range(1, last_state + 1):
+        cfg_file.write("TRANSITION %d %d 1\n" % (state - 1, state))
+    cfg_file.write("TRANSITION %d %d 1\n" % (last_state, last_state))
+    cfg_file.close()
+
+    # the monitor measures the latency seen by the generator
+    system.tgen = TrafficGen(config_file = cfg_file_name)
+    system.monitor = CommMonitor()
+    system.tgen.port = system.monitor.slave
+    system.monitor.master = system.membus.slave
+
+    # connect the system port even if it is not used
+    system.system_port = system.membus.slave
+
+    setattr(root, name.lower(), system)
+
+m5.instantiate()
+
+# go through the states of each memory type one by one, and dump and
+# reset the stats at the end of each of them, timing the host as we go
+nbr_dumps = len(mem_types) * nbr_states
+host_seconds = []
+for state in range(nbr_dumps):
+    start = time.time()
+    m5.simulate(args.period)
+    host_seconds.append(time.time() - start)
+    m5.stats.dump()
+    m5.stats.reset()
+
+def parse_dumps(filename):
+    """Return a list with a dictionary of the stats of each dump."""
+    dumps = []
+    for line in open(filename):
+        if line.startswith("---------- Begin"):
+            dumps.append({})
+        elif dumps and not line.startswith("-") and line.strip():
+            fields = line.split()
+            try:
+                dumps[-1][fields[0]] = float(fields[1])
+            except ValueError:
+                pass
+    return dumps
+
+dumps = parse_dumps(os.path.join(m5.options.outdir, "stats.txt"))
+if len(dumps) < nbr_dumps:
+    fatal("Expected %d stats dumps, found %d" % (nbr_dumps, len(dumps)))
+dumps = dumps[-nbr_dumps:]
+
+results = { "period" : args.period, "rd_perc" : args.rd_perc,
+            "mem_types" : {} }
+
+for index, name in enumerate(mem_types):
+    prefix = name.lower()
+    first_dump = index * nbr_states
+    for state, stats, seconds in \
+            zip(states[name], dumps[first_dump:first_dump + nbr_states],
+                host_seconds[first_dump:first_dump + nbr_states]):
+        def stat(s):
+            # stats flagged nozero are not printed when zero
+            return stats.get("%s.%s" % (prefix, s), 0.0)
+        bank_bursts = [stat("mem_ctrl.perBankRdBursts::%d" % b) +
+                       stat("mem_ctrl.perBankWrBursts::%d" % b)
+                       for b in range(banks[name])]
+        total_bursts = sum(bank_bursts)
+        state.update({
+            "achieved_bw" : stat("mem_ctrl.avgRdBW") +
+                            stat("mem_ctrl.avgWrBW"),
+            "bus_util" : stat("mem_ctrl.busUtil"),
+            "read_latency" : stat("monitor.readLatencyHist::mean"),
+            "write_latency" : stat("monitor.writeLatencyHist::mean"),
+            "mem_access_latency" : stat("mem_ctrl.avgMemAccLat"),
+            "read_row_hit_rate" : stat("mem_ctrl.readRowHitRate"),
+            "write_row_hit_rate" : stat("mem_ctrl.writeRowHitRate"),
+            "bank_util" : [b / total_bursts if total_bursts else 0.0
+                           for b in bank_bursts],
+            # the other memory types are idle, with only their
+            # refresh left to simulate
+            "host_seconds" : seconds,
+            "sim_ticks_per_host_second" :
+                args.period / seconds if seconds > 0 else 0.0,
+            })
+    results["mem_types"][name] = { "states" : states[name] }
+
+json_file = open(os.path.join(m5.options.outdir, args.json), 'w')
+json.dump(results, json_file, indent = 2, sort_keys = True)
+json_file.close()
+
+print("DRAM characterisation of %s written to %s" %
+      (" ".join(mem_types), args.json))
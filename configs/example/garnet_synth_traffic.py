@@ -36,6 +36,7 @@ addToPath('../')
 
 from common import Options
 from ruby import Ruby
+from network import Network
 
 # Get paths we might need.  It's expected this file is in m5/configs/example.
 config_path = os.path.dirname(os.path.abspath(__file__))
@@ -48,7 +49,7 @@ Options.addNoISAOptions(parser)
 parser.add_option("--synthetic", type="choice", default="uniform_random",
                   choices=['uniform_random', 'tornado', 'bit_complement', \
                            'bit_reverse', 'bit_rotation', 'neighbor', \
-                            'shuffle', 'transpose'])
+                            'shuffle', 'transpose', 'hotspot'])
 
 parser.add_option("-i", "--injectionrate", type="float", default=0.1,
                   metavar="I",
@@ -75,6 +76,13 @@ parser.add_option("--single-dest-id", type="int", default=-1,
                   help="Only send to this destination.\
                         Set to -1 to disable.")
 
+parser.add_option("--hotspot-dest-id", type="int", default=0,
+                  help="Destination of the hotspot for hotspot traffic.")
+
+parser.add_option("--hotspot-fraction", type="float", default=0.2,
+                  help="Fraction of the hotspot traffic that is sent to\
+                        the hotspot, the rest is uniform random.")
+
 parser.add_option("--inj-vnet", type="int", default=-1,
                   help="Only inject in this vnet (0, 1 or 2).\
                         0 and 1 are 1-flit, 2 is 5-flit.\
@@ -107,6 +115,8 @@ cpus = [ GarnetSyntheticTraffic(
                      single_dest=options.single_dest_id,
                      sim_cycles=options.sim_cycles,
                      traffic_type=options.synthetic,
+                     hotspot_dest=options.hotspot_dest_id,
+                     hotspot_fraction=options.hotspot_fraction,
                      inj_rate=options.injectionrate,
                      inj_vnet=options.inj_vnet,
                      precision=options.precision,
@@ -147,6 +157,11 @@ root.system.mem_mode = 'timing'
 # Not much point in this being higher than the L1 latency
 m5.ticks.setGlobalFrequency('1ns')
 
+# The partitions of a parallel network synchronise once per link latency
+if options.network_partitions > 1:
+    m5.ticks.fixGlobalFrequency()
+    root.sim_quantum = Network.partition_quantum(options)
+
 # instantiate configuration
 m5.instantiate()
 
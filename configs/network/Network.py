@@ -65,7 +65,9 @@ def define_options(parser):
                       help="""routing algorithm in network.
                             0: weight-based table
                             1: XY (for Mesh. see garnet2.0/RoutingUnit.cc)
-                            2: Custom (see garnet2.0/RoutingUnit.cc""")
+                            2: Custom (see garnet2.0/RoutingUnit.cc
+                            3: West-first adaptive (for Mesh)
+                            4: Odd-even adaptive (for Mesh)""")
     parser.add_option("--network-fault-model", action="store_true",
                       default=False,
                       help="""enable network fault model:
@@ -73,6 +75,12 @@ def define_options(parser):
     parser.add_option("--garnet-deadlock-threshold", action="store",
                       type="int", default=50000,
                       help="network-level deadlock threshold.")
+    parser.add_option("--network-partitions", action="store", type="int",
+                      default=1,
+                      help="""number of event queues to spread the garnet
+                            routers over. Needs a simulation quantum no
+                            larger than the link latency, see
+                            partition_quantum().""")
 
 
 def create_network(options, ruby):
@@ -120,3 +128,42 @@ def init_network(options, network, InterfaceClass):
         assert(options.network == "garnet2.0")
         network.enable_fault_model = True
         network.fault_model = FaultModel()
+
+    if options.network_partitions > 1:
+        assert(options.network == "garnet2.0")
+        partition_network(options, network)
+
+def partition_network(options, network):
+    """Spread the routers over event queues 1..N in blocks of consecutive
+    router ids, which are blocks of rows in a mesh. The network
+    interfaces stay on the event queue of their controllers. Every link
+    runs on the event queue of the unit that feeds it, so only the link
+    buffers are shared between the queues."""
+
+    routers = sorted(network.routers, key=lambda r: r.router_id)
+    partitions = min(options.network_partitions, len(routers))
+    per_partition = int(math.ceil(len(routers) / float(partitions)))
+
+    partition = {}
+    for i, router in enumerate(routers):
+        router.eventq_index = 1 + i / per_partition
+        partition[router.router_id] = router.eventq_index
+
+    for link in network.int_links:
+        link.network_link.eventq_index = partition[link.src_node.router_id]
+        link.credit_link.eventq_index = partition[link.dst_node.router_id]
+
+    for link in network.ext_links:
+        router_queue = partition[link.int_node.router_id]
+        link.network_links[0].eventq_index = 0
+        link.credit_links[0].eventq_index = router_queue
+        link.network_links[1].eventq_index = router_queue
+        link.credit_links[1].eventq_index = 0
+
+def partition_quantum(options):
+    """The simulation quantum of a partitioned network: the latency of a
+    link, which is the lookahead between the partitions. The global
+    frequency has to be fixed before calling this."""
+
+    period = m5.util.convert.anyToLatency(options.ruby_clock)
+    return m5.ticks.fromSeconds(period * options.link_latency)
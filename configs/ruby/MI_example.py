@@ -31,6 +31,7 @@ import math
 import m5
 from m5.objects import *
 from m5.defines import buildEnv
+from functools import partial
 from Ruby import create_topology, create_directories
 from Ruby import send_evicts
 
@@ -40,7 +41,10 @@ from Ruby import send_evicts
 class L1Cache(RubyCache): pass
 
 def define_options(parser):
-    return
+    parser.add_option("--dir-entries", type="int", default=16384,
+          help="MI_example: entries of each sparse directory")
+    parser.add_option("--dir-assoc", type="int", default=16,
+          help="MI_example: associativity of the sparse directories")
 
 def create_system(options, full_system, system, dma_ports, ruby_system):
 
@@ -125,8 +129,16 @@ def create_system(options, full_system, system, dma_ports, ruby_system):
                                           clk_domain=ruby_system.clk_domain,
                                           clk_divider=3)
 
+    # The directory keeps entries only for the cached lines, and indexes
+    # its sets with the address bits above those that pick the directory
+    dir_bits = int(math.log(options.num_dirs, 2))
+    sparse_directory = partial(RubySparseDirectory,
+                               size = options.dir_entries,
+                               assoc = options.dir_assoc,
+                               start_index_bit = block_size_bits + dir_bits)
+
     dir_cntrl_nodes = create_directories(options, system.mem_ranges,
-                                         ruby_system)
+                                         ruby_system, sparse_directory)
     for dir_cntrl in dir_cntrl_nodes:
         # Connect the directory controllers and the network
         dir_cntrl.requestToDir = MessageBuffer(ordered = True)
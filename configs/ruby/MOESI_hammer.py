@@ -114,6 +114,9 @@ def create_system(options, full_system, system, dma_ports, ruby_system):
                                 ruby_system=ruby_system)
 
         l1_cntrl.sequencer = cpu_seq
+        # Without a probe filter the directory does not track sharers, so
+        # restored lines can be written straight into the caches
+        l1_cntrl.direct_restore = not (options.pf_on or options.dir_on)
         if options.recycle_latency:
             l1_cntrl.recycle_latency = options.recycle_latency
 
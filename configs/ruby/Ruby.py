@@ -196,7 +196,11 @@ def create_system(options, full_system, system, piobus = None, dma_ports = []):
         ruby.phys_mem = SimpleMemory(range=system.mem_ranges[0],
                                      in_addr_map=False)
 
-def create_directories(options, mem_ranges, ruby_system):
+def create_directories(options, mem_ranges, ruby_system,
+                       directory_class = RubyDirectoryMemory):
+    """Create a directory controller per directory, each holding a
+    directory made by calling directory_class."""
+
     dir_cntrl_nodes = []
     if options.numa_high_bit:
         numa_bit = options.numa_high_bit
@@ -219,7 +223,7 @@ def create_directories(options, mem_ranges, ruby_system):
 
         dir_cntrl = Directory_Controller()
         dir_cntrl.version = i
-        dir_cntrl.directory = RubyDirectoryMemory()
+        dir_cntrl.directory = directory_class()
         dir_cntrl.ruby_system = ruby_system
         dir_cntrl.addr_ranges = dir_ranges
 
@@ -89,6 +89,8 @@ GarnetSyntheticTraffic::GarnetSyntheticTraffic(const Params *p)
       singleSender(p->single_sender),
       singleDest(p->single_dest),
       trafficType(p->traffic_type),
+      hotspotDest(p->hotspot_dest),
+      hotspotFraction(p->hotspot_fraction),
       injRate(p->inj_rate),
       injVnet(p->inj_vnet),
       precision(p->precision),
@@ -224,6 +226,14 @@ GarnetSyntheticTraffic::generatePkt()
             destination = source/2;
         else // (source%2 == 1)
             destination = ((source/2) + (num_destinations/2));
+    } else if (traffic == HOTSPOT_) {
+        // A fraction of the packets goes to the hotspot, the rest is
+        // uniform random
+        if (random_mt.random<double>() < hotspotFraction)
+            destination = hotspotDest;
+        else
+            destination = random_mt.random<unsigned>(0,
+                                                     num_destinations - 1);
     } else if (traffic == NEIGHBOR_) {
             dest_x = (src_x + 1) % radix;
             dest_y = src_y;
@@ -331,6 +341,7 @@ GarnetSyntheticTraffic::initTrafficType()
     trafficStringToEnum["bit_complement"] = BIT_COMPLEMENT_;
     trafficStringToEnum["bit_reverse"] = BIT_REVERSE_;
     trafficStringToEnum["bit_rotation"] = BIT_ROTATION_;
+    trafficStringToEnum["hotspot"] = HOTSPOT_;
     trafficStringToEnum["neighbor"] = NEIGHBOR_;
     trafficStringToEnum["shuffle"] = SHUFFLE_;
     trafficStringToEnum["tornado"] = TORNADO_;
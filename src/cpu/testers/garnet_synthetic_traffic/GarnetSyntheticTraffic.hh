@@ -45,11 +45,12 @@
 enum TrafficType {BIT_COMPLEMENT_ = 0,
                   BIT_REVERSE_ = 1,
                   BIT_ROTATION_ = 2,
-                  NEIGHBOR_ = 3,
-                  SHUFFLE_ = 4,
-                  TORNADO_ = 5,
-                  TRANSPOSE_ = 6,
-                  UNIFORM_RANDOM_ = 7,
+                  HOTSPOT_ = 3,
+                  NEIGHBOR_ = 4,
+                  SHUFFLE_ = 5,
+                  TORNADO_ = 6,
+                  TRANSPOSE_ = 7,
+                  UNIFORM_RANDOM_ = 8,
                   NUM_TRAFFIC_PATTERNS_};
 
 class Packet;
@@ -126,6 +127,8 @@ class GarnetSyntheticTraffic : public MemObject
 
     std::string trafficType; // string
     TrafficType traffic; // enum from string
+    int hotspotDest;
+    double hotspotFraction;
     double injRate;
     int injVnet;
     int precision;
@@ -45,6 +45,9 @@ class GarnetSyntheticTraffic(MemObject):
     single_dest = Param.Int(-1, "Send only to this dest. \
                                  Default depends on traffic_type")
     traffic_type = Param.String("uniform_random", "Traffic type")
+    hotspot_dest = Param.Int(0, "Hotspot destination of hotspot traffic")
+    hotspot_fraction = Param.Float(0.2, "Fraction of hotspot traffic \
+                                         sent to the hotspot")
     inj_rate = Param.Float(0.1, "Packet injection rate")
     inj_vnet = Param.Int(-1, "Vnet to inject in. \
                               0 and 1 are 1-flit, 2 is 5-flit. \
@@ -67,3 +67,13 @@ class AbstractMemory(MemObject):
     # configuration information about the physical memory layout to
     # the kernel, e.g. using ATAG or ACPI
     conf_table_reported = Param.Bool(True, "Report to configuration table")
+
+    # Record the accesses reaching the memory in a packet trace that
+    # can be replayed using the TraceGen, disabled by default. The
+    # SimpleMemory records every request, and the DRAMCtrl records
+    # every burst along with the rank, bank and row it maps to, both
+    # as they arrive, other memories do not support tracing
+    trace_file = Param.String("", "Access trace output file")
+    trace_compress = Param.Bool(True, "Enable trace compression")
+    trace_block_size = Param.MemorySize('1MB', "Size of the compressed "
+                                        "blocks of the access trace")
@@ -0,0 +1,64 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from MemObject import MemObject
+
+# The channel group is a front-end owning a number of memory channels
+# with interleaved address ranges, and it routes each request straight
+# to its channel based on the interleaving bits, without the latency
+# and layers of a crossbar. The channels may be placed on event queues
+# of their own, e.g. for channel i of a group on queue 0:
+#
+#   ctrl.eventq_index = i + 1
+#
+# in which case requests and responses cross between the queues with
+# a latency of at least the simulation quantum, and the channels are
+# simulated in parallel. The channels are attached using
+# attachChannels, which also connects their ports.
+class ChannelGroup(MemObject):
+    type = 'ChannelGroup'
+    cxx_header = "mem/channel_group.hh"
+
+    port = SlavePort("Slave port, facing the rest of the memory system")
+    channels = VectorMasterPort("Master ports, one per channel")
+
+    mem_ctrls = VectorParam.AbstractMemory("The channels, in port order")
+
+    # latency of a request or response crossing to a channel on another
+    # event queue, raised to the simulation quantum if smaller
+    crossing_latency = Param.Latency('0ns', "Latency of crossing to a "
+                                     "channel on another event queue")
+
+    # requests to a channel on another event queue that are yet to be
+    # accepted by the channel are buffered in the group
+    channel_buffer_size = Param.Unsigned(16, "Requests in flight to each "
+                                         "channel on another event queue")
+
+    def attachChannels(self, ctrls):
+        self.mem_ctrls = ctrls
+        for ctrl in ctrls:
+            self.channels = ctrl.port
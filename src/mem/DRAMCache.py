@@ -0,0 +1,82 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from AbstractMemory import *
+
+# Enum for where the DRAM cache keeps its tags, either in the DRAM
+# alongside the data (tag-and-data units as in the Alloy cache), or in
+# an on-die SRAM
+class DRAMCacheTags(Enum): vals = ['dram', 'sram']
+
+# The DRAMCache is a direct-mapped memory-side cache, e.g. in stacked
+# HBM, in front of the main memory. It holds the data of the entire
+# range as any other memory, and drives the cache and main memory
+# controllers, typically a HBM and a DDR4 DRAMCtrl, with the requests
+# needed for each access to capture their timing and bandwidth. The
+# two controllers should therefore not be part of the address map, nor
+# store any data, e.g.:
+#
+#   hbm = HBM_1000_4H_1x128(range = AddrRange('128MB'),
+#                           in_addr_map = False, null = True)
+#   ddr = DDR4_2400_8x8(range = mem_range, in_addr_map = False,
+#                       null = True)
+#   dcache = DRAMCache(range = mem_range)
+#   dcache.cache_port = hbm.port
+#   dcache.mem_port = ddr.port
+#
+# The capacity of the cache is given by the range of the cache
+# controller, less the space taken by the tags if kept in DRAM.
+class DRAMCache(AbstractMemory):
+    type = 'DRAMCache'
+    cxx_header = "mem/dram_cache.hh"
+
+    port = SlavePort("Slave port")
+    cache_port = MasterPort("Master port to the DRAM cache controller")
+    mem_port = MasterPort("Master port to the main memory controller")
+
+    tag_location = Param.DRAMCacheTags('dram', "Location of the tags")
+
+    # size of the tag stored with every line when the tags are in
+    # DRAM, read and written along with the data
+    tag_size = Param.Unsigned(8, "Bytes of tag per line in DRAM")
+
+    # lookup latency of the tags when they are in SRAM
+    tag_latency = Param.Latency('2ns', "SRAM tag lookup latency")
+
+    # static latency of the controller added to every response
+    static_latency = Param.Latency('5ns', "Static controller latency")
+
+    # the miss predictor (as in MAP-I) starts the main memory access in
+    # parallel with the cache access for likely misses, and uses
+    # saturating counters indexed by the PC, or the master if there is
+    # no PC
+    miss_predictor = Param.Bool(True, "Predict misses when the tags are "
+                                "in DRAM")
+    predictor_entries = Param.Unsigned(256, "Entries of the miss predictor")
+
+    # bound the number of outstanding reads and queued requests
+    buffer_size = Param.Unsigned(64, "Number of outstanding requests")
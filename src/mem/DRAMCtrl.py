@@ -45,11 +45,13 @@
 #          Erfan Azarkhish
 
 from m5.params import *
+from m5.SimObject import *
 from AbstractMemory import *
 
 # Enum for memory scheduling algorithms, currently First-Come
-# First-Served and a First-Row Hit then First-Come First-Served
-class MemSched(Enum): vals = ['fcfs', 'frfcfs']
+# First-Served, a First-Row Hit then First-Come First-Served, and the
+# thread-aware BLISS, ATLAS and TCM policies
+class MemSched(Enum): vals = ['fcfs', 'frfcfs', 'bliss', 'atlas', 'tcm']
 
 # Enum for the address mapping. With Ch, Ra, Ba, Ro and Co denoting
 # channel, rank, bank, row and column, respectively, and going from
@@ -59,6 +61,12 @@ class MemSched(Enum): vals = ['fcfs', 'frfcfs']
 # maximises parallelism.
 class AddrMap(Enum): vals = ['RoRaBaChCo', 'RoRaBaCoCh', 'RoCoRaBaCh']
 
+# On top of the address mapping, the rank and bank index can be
+# permuted by XOR-ing each index bit with the parity of the address
+# bits in a mask (see rank_xor_masks and bank_xor_masks), e.g. to
+# spread strided accesses across the banks. Bank groups follow the
+# bank index.
+
 # Enum for the page policy, either open, open_adaptive, close, or
 # close_adaptive.
 class PageManage(Enum): vals = ['open', 'open_adaptive', 'close',
@@ -72,6 +80,10 @@ class DRAMCtrl(AbstractMemory):
     type = 'DRAMCtrl'
     cxx_header = "mem/dram_ctrl.hh"
 
+    cxx_exports = [
+        PyBindMethod("setApproximate"),
+    ]
+
     # single-ported on the system interface side, instantiate with a
     # bus in front of the controller for multiple ports
     port = SlavePort("Slave port")
@@ -100,6 +112,52 @@ class DRAMCtrl(AbstractMemory):
     addr_mapping = Param.AddrMap('RoRaBaCoCh', "Address mapping policy")
     page_policy = Param.PageManage('open_adaptive', "Page management policy")
 
+    # optional XOR permutation of the rank and bank index, with one
+    # address bit mask per index bit, least significant bit first,
+    # and the masks must not include the rank and bank bits of the
+    # address mapping
+    rank_xor_masks = VectorParam.Addr([], "Address bit masks XOR-ed into "
+                                      "the rank index")
+    bank_xor_masks = VectorParam.Addr([], "Address bit masks XOR-ed into "
+                                      "the bank index")
+
+    # optional static priority classes for masters, given by the name
+    # of the master or the object it belongs to (e.g. system.cpu0),
+    # with higher classes taking precedence with any scheduling policy
+    qos_masters = VectorParam.String([], "Masters with a priority class")
+    qos_priorities = VectorParam.Unsigned([], "Priority class of each of "
+                                          "the QoS masters")
+
+    # parameters of the thread-aware scheduling policies
+    sched_quantum = Param.Latency('100us', "Ranking quantum (ATLAS, TCM)")
+    bliss_threshold = Param.Unsigned(4, "Requests served in a row before "
+                                     "a master is blacklisted (BLISS)")
+    bliss_clear_interval = Param.Latency('10us', "Interval for clearing "
+                                         "the blacklist (BLISS)")
+    atlas_history_weight = Param.Float(0.875, "Weight of the attained "
+                                       "service history (ATLAS)")
+    atlas_starvation_threshold = Param.Latency('50us', "Waiting time "
+                                               "before a request is "
+                                               "prioritised (ATLAS)")
+    tcm_cluster_fraction = Param.Float(0.2, "Bandwidth share of the "
+                                       "latency-sensitive cluster (TCM)")
+    tcm_shuffle_interval = Param.Latency('1us', "Interval for shuffling "
+                                         "the bandwidth-sensitive "
+                                         "cluster (TCM)")
+
+    # use an approximate, analytical model of the banks and the data
+    # bus rather than scheduling every DRAM command, e.g. for
+    # fast-forwarding and warm-up, the mode can also be changed from
+    # the script once the system is drained using setApproximate, the
+    # ranks are still refreshed, and the approximate model delays any
+    # access falling in the refresh window at the start of each tREFI
+    approximate = Param.Bool(False, "Use the approximate DRAM model")
+
+    # coalesce the wake-up, power and refresh events of a rank that is
+    # refreshed while idle into a single step, issuing the same
+    # commands to DRAMPower and thus giving identical energy numbers
+    bulk_refresh = Param.Bool(False, "Refresh idle ranks in bulk")
+
     # enforce a limit on the number of accesses per row
     max_accesses_per_row = Param.Unsigned(16, "Max accesses per row before "
                                           "closing");
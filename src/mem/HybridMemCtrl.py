@@ -0,0 +1,70 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from MemObject import MemObject
+
+# The HybridMemCtrl presents a DRAM tier and an NVM tier as one flat
+# memory, with the DRAM holding the pages at the start of the range
+# and the NVM the remaining ones. Behind the scenes the pages are
+# remapped at a page granularity, with the hot pages in the NVM tier
+# migrated to the DRAM tier by swapping them with cold DRAM pages. The
+# range of the two tiers should together cover the range of the
+# controller, e.g. for a DRAMCtrl dram and an NVMemory nvm:
+#
+#   dram.range = AddrRange(start, size = dram_size)
+#   nvm.range = AddrRange(start + dram_size, size = nvm_size)
+#   hybrid.range = AddrRange(start, size = dram_size + nvm_size)
+class HybridMemCtrl(MemObject):
+    type = 'HybridMemCtrl'
+    cxx_header = "mem/hybrid_mem_ctrl.hh"
+
+    port = SlavePort("Slave port")
+    dram_port = MasterPort("Master port connected to the DRAM tier")
+    nvm_port = MasterPort("Master port connected to the NVM tier")
+
+    system = Param.System(Parent.any, "System we belong to")
+
+    range = Param.AddrRange("Address range of the hybrid memory")
+    dram_size = Param.MemorySize("Size of the DRAM tier")
+
+    # granularity of the remapping and migration
+    page_size = Param.MemorySize('4kB', "Page size")
+
+    # pages in the NVM tier reaching the threshold number of accesses
+    # within an interval are migrated at the end of the interval,
+    # limited to a maximum number of pages per interval
+    migration_interval = Param.Latency('10us', "Migration interval")
+    migration_threshold = Param.Unsigned(32, "Accesses within an interval "
+                                         "for an NVM page to be hot")
+    max_migrations = Param.Unsigned(4, "Maximum number of pages migrated "
+                                    "per interval")
+
+    # the data of a migrated page is read and written in bursts of
+    # this size, consuming bandwidth in both tiers
+    migration_burst_size = Param.MemorySize('64B', "Size of the migration "
+                                            "requests")
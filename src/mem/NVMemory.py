@@ -0,0 +1,68 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from AbstractMemory import *
+
+# The NVMemory is a simple model of a byte-addressable non-volatile
+# memory (e.g. PCM or 3D XPoint) behind a controller, capturing the
+# asymmetric read and write latency of the media, the bank-level
+# parallelism, and the limited write endurance. Similar to the flash
+# device (see AbstractNVM and FlashDevice in dev/arm), the media is
+# divided in blocks with a write counter each, here used for wear
+# accounting rather than garbage collection.
+class NVMemory(AbstractMemory):
+    type = 'NVMemory'
+    cxx_header = "mem/nvm_mem.hh"
+
+    port = SlavePort("Slave port")
+
+    # latency of a read and write access to the media, the latter
+    # also occupies the bank for the entire duration
+    read_latency = Param.Latency('150ns', "Media read latency")
+    write_latency = Param.Latency('500ns', "Media write latency")
+
+    # static latency of the controller and PHY
+    static_latency = Param.Latency('20ns', "Static controller latency")
+
+    # the media is split in banks that can be accessed in parallel,
+    # interleaved at a fixed granularity
+    banks = Param.Unsigned(16, "Number of independent banks")
+    bank_interleave = Param.MemorySize('256B', "Bank interleaving "
+                                       "granularity")
+
+    # the interface bandwidth is shared by reads and writes
+    bandwidth = Param.MemoryBandwidth('12.8GB/s', "Interface bandwidth")
+
+    # bound the number of outstanding requests in the controller
+    read_buffer_size = Param.Unsigned(32, "Number of read queue entries")
+    write_buffer_size = Param.Unsigned(64, "Number of write queue entries")
+
+    # granularity and limit of the write endurance accounting
+    endurance_block_size = Param.MemorySize('4kB', "Size of a block with "
+                                            "its own write counter")
+    max_block_writes = Param.UInt64(10000000, "Number of writes a block "
+                                    "endures before wearing out")
@@ -73,6 +73,14 @@ class BaseXBar(MemObject):
     # Width governing the throughput of the crossbar
     width = Param.Unsigned("Datapath width per port (bytes)")
 
+    # When a port that is sent a retry does not take it up in zero
+    # time, a layer is released again in the same tick if the crossbar
+    # clock edge has already been reached. Rather than scheduling a
+    # release event for every waiting port in turn, up to this many
+    # ports are retried in one go, with identical timing.
+    retry_batch = Param.Unsigned(1, "Maximum number of waiting ports " \
+                                 "retried per layer release")
+
     # The default port can be left unconnected, or be used to connect
     # a default slave port
     default = MasterPort("Port for connecting an optional default slave")
@@ -125,6 +133,14 @@ class SnoopFilter(SimObject):
     # Sanity check on max capacity to track, adjust if needed.
     max_capacity = Param.MemorySize('8MB', "Maximum capacity of snoop filter")
 
+    # By default the filter is unbounded, and max_capacity is merely
+    # a sanity check. With a non-zero associativity the filter is
+    # instead organised as a set-associative structure holding
+    # max_capacity worth of lines, and replaced entries are
+    # back-invalidated in the caches above.
+    assoc = Param.Unsigned(0, "Associativity of a bounded snoop filter " \
+                           "(0 for unbounded)")
+
 # We use a coherent crossbar to connect multiple masters to the L2
 # caches. Normally this crossbar would be part of the cache itself.
 class L2XBar(CoherentXBar):
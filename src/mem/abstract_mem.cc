@@ -47,6 +47,9 @@
 #include <vector>
 
 #include "arch/locked_mem.hh"
+#include "base/callback.hh"
+#include "base/output.hh"
+#include "config/have_protobuf.hh"
 #include "cpu/base.hh"
 #include "cpu/thread_context.hh"
 #include "debug/LLSC.hh"
@@ -54,13 +57,22 @@
 #include "mem/packet_access.hh"
 #include "sim/system.hh"
 
+#if HAVE_PROTOBUF
+#include "proto/packet.pb.h"
+#include "proto/protoio.hh"
+#endif
+
 using namespace std;
 
 AbstractMemory::AbstractMemory(const Params *p) :
     MemObject(p), range(params()->range), pmemAddr(NULL),
     confTableReported(p->conf_table_reported), inAddrMap(p->in_addr_map),
-    kvmMap(p->kvm_map), _system(NULL)
+    kvmMap(p->kvm_map), traceStream(NULL), _system(NULL)
 {
+#if !HAVE_PROTOBUF
+    fatal_if(p->trace_file != "", "%s: access tracing requires protobuf "
+             "support\n", name());
+#endif
 }
 
 void
@@ -72,6 +84,98 @@ AbstractMemory::init()
         panic("Memory Size not divisible by page size\n");
 }
 
+void
+AbstractMemory::startup()
+{
+#if HAVE_PROTOBUF
+    const AbstractMemoryParams* p = params();
+
+    if (p->trace_file == "")
+        return;
+
+    // If the trace file is not specified as an absolute path, append
+    // the current simulation output directory, and if compression is
+    // enabled make sure the file name ends in .gz
+    std::string filename = simout.resolve(p->trace_file);
+    const std::string suffix = ".gz";
+    if (p->trace_compress &&
+        (filename.size() < suffix.size() ||
+         filename.compare(filename.size() - suffix.size(), suffix.size(),
+                          suffix) != 0))
+        filename += suffix;
+
+    traceStream = new ProtoOutputStream(filename, p->trace_block_size);
+
+    // the header identifies the memory, and maps master ids to names
+    ProtoMessage::PacketHeader header_msg;
+    header_msg.set_obj_id(name());
+    header_msg.set_tick_freq(SimClock::Frequency);
+
+    for (int i = 0; i < system()->maxMasters(); i++) {
+        auto id_string = header_msg.add_id_strings();
+        id_string->set_key(i);
+        id_string->set_value(system()->getMasterName(i));
+    }
+
+    traceStream->write(header_msg);
+
+    // the destructor is not called, so flush and close on exit
+    registerExitCallback(
+        new MakeCallback<AbstractMemory, &AbstractMemory::closeTrace>(this));
+#endif
+}
+
+void
+AbstractMemory::traceAccess(Tick when, MemCmd cmd, Addr addr, unsigned size,
+                            MasterID master)
+{
+#if HAVE_PROTOBUF
+    if (traceStream == NULL)
+        return;
+
+    ProtoMessage::Packet pkt_msg;
+    pkt_msg.set_tick(when);
+    pkt_msg.set_cmd(cmd.toInt());
+    pkt_msg.set_addr(addr);
+    pkt_msg.set_size(size);
+    pkt_msg.set_pkt_id(master);
+
+    traceStream->write(pkt_msg);
+#endif
+}
+
+void
+AbstractMemory::traceAccess(Tick when, MemCmd cmd, Addr addr, unsigned size,
+                            MasterID master, unsigned rank, unsigned bank,
+                            uint64_t row)
+{
+#if HAVE_PROTOBUF
+    if (traceStream == NULL)
+        return;
+
+    ProtoMessage::Packet pkt_msg;
+    pkt_msg.set_tick(when);
+    pkt_msg.set_cmd(cmd.toInt());
+    pkt_msg.set_addr(addr);
+    pkt_msg.set_size(size);
+    pkt_msg.set_pkt_id(master);
+    pkt_msg.set_rank(rank);
+    pkt_msg.set_bank(bank);
+    pkt_msg.set_row(row);
+
+    traceStream->write(pkt_msg);
+#endif
+}
+
+void
+AbstractMemory::closeTrace()
+{
+#if HAVE_PROTOBUF
+    delete traceStream;
+    traceStream = NULL;
+#endif
+}
+
 void
 AbstractMemory::setBackingStore(uint8_t* pmem_addr)
 {
@@ -54,6 +54,7 @@
 #include "sim/stats.hh"
 
 
+class ProtoOutputStream;
 class System;
 
 /**
@@ -175,6 +176,44 @@ class AbstractMemory : public MemObject
     /** Total bandwidth from this memory */
     Stats::Formula bwTotal;
 
+    /** Output stream of the access trace, NULL if not tracing */
+    ProtoOutputStream* traceStream;
+
+    /**
+     * Record an access in the access trace, if enabled. The tick is
+     * the time the access reached the memory.
+     *
+     * @param when Tick of the access
+     * @param cmd Command of the access, i.e. read or write
+     * @param addr Start address of the access
+     * @param size Size of the access in bytes
+     * @param master Master that issued the access
+     */
+    void traceAccess(Tick when, MemCmd cmd, Addr addr, unsigned size,
+                     MasterID master);
+
+    /**
+     * Record an access in the access trace, if enabled, along with
+     * the location in a banked memory that it maps to.
+     *
+     * @param when Tick of the access
+     * @param cmd Command of the access, i.e. read or write
+     * @param addr Start address of the access
+     * @param size Size of the access in bytes
+     * @param master Master that issued the access
+     * @param rank Rank the access maps to
+     * @param bank Bank the access maps to
+     * @param row Row the access maps to
+     */
+    void traceAccess(Tick when, MemCmd cmd, Addr addr, unsigned size,
+                     MasterID master, unsigned rank, unsigned bank,
+                     uint64_t row);
+
+    /**
+     * Callback to flush and close the trace on exit.
+     */
+    void closeTrace();
+
     /** Pointor to the System object.
      * This is used for getting the number of masters in the system which is
      * needed when registering stats
@@ -202,6 +241,11 @@ class AbstractMemory : public MemObject
      */
     void init() override;
 
+    /**
+     * Open the access trace, if enabled, once all masters are known.
+     */
+    void startup() override;
+
     /**
      * See if this is a null memory that should never store data and
      * always return zero.
@@ -1819,35 +1819,56 @@ Cache::allocateBlock(Addr addr, bool is_secure, PacketList &writebacks)
     if (!blk)
         return nullptr;
 
-    if (blk->isValid()) {
-        Addr repl_addr = tags->regenerateBlkAddr(blk->tag, blk->set);
-        MSHR *repl_mshr = mshrQueue.findMatch(repl_addr, blk->isSecure());
+    // Some tag stores, e.g., sector caches, need to evict other blocks
+    // along with the victim
+    std::vector<CacheBlk*> evict_blks;
+    if (blk->isValid())
+        evict_blks.push_back(blk);
+    tags->findCoVictims(addr, blk, evict_blks);
+
+    for (const auto &evict_blk : evict_blks) {
+        Addr repl_addr = tags->regenerateBlkAddr(evict_blk->tag,
+                                                 evict_blk->set);
+        MSHR *repl_mshr = mshrQueue.findMatch(repl_addr,
+                                              evict_blk->isSecure());
         if (repl_mshr) {
             // must be an outstanding upgrade request
             // on a block we're about to replace...
-            assert(!blk->isWritable() || blk->isDirty());
+            assert(!evict_blk->isWritable() || evict_blk->isDirty());
             assert(repl_mshr->needsWritable());
             // too hard to replace block with transient state
             // allocation failed, block not inserted
             return nullptr;
-        } else {
-            DPRINTF(Cache, "replacement: replacing %#llx (%s) with %#llx "
-                    "(%s): %s\n", repl_addr, blk->isSecure() ? "s" : "ns",
-                    addr, is_secure ? "s" : "ns",
-                    blk->isDirty() ? "writeback" : "clean");
+        }
+    }
 
-            if (blk->wasPrefetched()) {
-                unusedPrefetches++;
-            }
-            // Will send up Writeback/CleanEvict snoops via isCachedAbove
-            // when pushing this writeback list into the write buffer.
-            if (blk->isDirty() || writebackClean) {
-                // Save writeback packet for handling by caller
-                writebacks.push_back(writebackBlk(blk));
-            } else {
-                writebacks.push_back(cleanEvictBlk(blk));
-            }
+    for (const auto &evict_blk : evict_blks) {
+        Addr repl_addr = tags->regenerateBlkAddr(evict_blk->tag,
+                                                 evict_blk->set);
+        DPRINTF(Cache, "replacement: replacing %#llx (%s) with %#llx "
+                "(%s): %s\n", repl_addr, evict_blk->isSecure() ? "s" : "ns",
+                addr, is_secure ? "s" : "ns",
+                evict_blk->isDirty() ? "writeback" : "clean");
+
+        if (evict_blk->wasPrefetched()) {
+            unusedPrefetches++;
+        }
+        if (prefetcher) {
+            prefetcher->notifyEvict(repl_addr);
         }
+        // Will send up Writeback/CleanEvict snoops via isCachedAbove
+        // when pushing this writeback list into the write buffer.
+        if (evict_blk->isDirty() || writebackClean) {
+            // Save writeback packet for handling by caller
+            writebacks.push_back(writebackBlk(evict_blk));
+        } else {
+            writebacks.push_back(cleanEvictBlk(evict_blk));
+        }
+
+        // The victim itself is replaced when the new block is
+        // inserted, any other block is invalidated right away
+        if (evict_blk != blk)
+            invalidateBlock(evict_blk);
     }
 
     return blk;
@@ -2336,8 +2357,11 @@ Cache::recvTimingSnoopReq(PacketPtr pkt)
         // the difference being that instead of querying the block
         // state to determine if it is dirty and writable, we use the
         // command and fields of the writeback packet
+        // back-invalidations from a snoop filter are not responded
+        // to, and the queued write carries any dirty data down to
+        // the memory below anyway
         bool respond = wb_pkt->cmd == MemCmd::WritebackDirty &&
-            pkt->needsResponse();
+            pkt->needsResponse() && !pkt->isBackInvalidation();
         bool have_writable = !wb_pkt->hasSharers();
         bool invalidate = pkt->isInvalidate();
 
@@ -2358,7 +2382,8 @@ Cache::recvTimingSnoopReq(PacketPtr pkt)
                                    false, false);
         }
 
-        if (invalidate && wb_pkt->cmd != MemCmd::WriteClean) {
+        if (invalidate && wb_pkt->cmd != MemCmd::WriteClean &&
+            !pkt->isBackInvalidation()) {
             // Invalidation trumps our writeback... discard here
             // Note: markInService will remove entry from writeback buffer.
             markInService(wb_entry);
@@ -90,3 +90,15 @@ class TaggedPrefetcher(QueuedPrefetcher):
     cxx_header = "mem/cache/prefetch/tagged.hh"
 
     degree = Param.Int(2, "Number of prefetches to generate")
+
+class FootprintPrefetcher(QueuedPrefetcher):
+    type = 'FootprintPrefetcher'
+    cxx_class = 'FootprintPrefetcher'
+    cxx_header = "mem/cache/prefetch/footprint.hh"
+
+    # should match num_blocks_per_sector of the SectorTags of the cache
+    num_blocks_per_sector = Param.Unsigned(4, "Number of blocks per sector")
+    active_entries = Param.Unsigned(1024,
+        "Number of sectors whose footprint is recorded at a time")
+    history_entries = Param.Unsigned(4096,
+        "Number of entries in the footprint history table")
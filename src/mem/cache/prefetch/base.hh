@@ -134,6 +134,13 @@ class BasePrefetcher : public ClockedObject
      */
     virtual Tick notify(const PacketPtr &pkt) = 0;
 
+    /**
+     * Notify prefetcher that a valid block is evicted to make room for
+     * a new one.
+     * @param addr Address of the evicted block.
+     */
+    virtual void notifyEvict(Addr addr) {}
+
     virtual PacketPtr getPacket() = 0;
 
     virtual Tick nextPrefetchReadyTime() const = 0;
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Footprint prefetcher definitions.
+ */
+
+#include "mem/cache/prefetch/footprint.hh"
+
+#include <iterator>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+
+FootprintPrefetcher::FootprintPrefetcher(const FootprintPrefetcherParams *p)
+    : QueuedPrefetcher(p),
+      numBlocksPerSector(p->num_blocks_per_sector),
+      activeEntries(p->active_entries),
+      historyMask(p->history_entries - 1),
+      history(p->history_entries)
+{
+    fatal_if(!isPowerOf2(numBlocksPerSector) || numBlocksPerSector > 64,
+             "%s: # of blocks per sector must be a power of 2 no larger "
+             "than 64\n", name());
+    fatal_if(!isPowerOf2(p->history_entries),
+             "%s: # of history entries must be a power of 2\n", name());
+    fatal_if(activeEntries == 0,
+             "%s: # of active entries must be non-zero\n", name());
+}
+
+Addr
+FootprintPrefetcher::triggerHash(Addr pc, unsigned offset) const
+{
+    return (pc << floorLog2(numBlocksPerSector)) | offset;
+}
+
+void
+FootprintPrefetcher::retireSector(std::list<ActiveSector>::iterator it)
+{
+    const ActiveSector &sector = *it;
+
+    footprintOverfetch += popCount(sector.predicted & ~sector.footprint);
+    footprintUnderfetch += popCount(sector.footprint & ~sector.predicted);
+
+    HistoryEntry &entry = history[sector.trigger & historyMask];
+    entry.valid = true;
+    entry.trigger = sector.trigger;
+    entry.footprint = sector.footprint;
+
+    DPRINTF(HWPrefetch, "Learnt footprint %#x for sector %#x\n",
+            sector.footprint, sector.sectorAddr);
+
+    activeIndex.erase(sector.sectorAddr);
+    activeList.erase(it);
+}
+
+void
+FootprintPrefetcher::notifyEvict(Addr addr)
+{
+    // The first sub-block evicted ends the sector's residency, the
+    // others are no longer tracked
+    auto it = activeIndex.find(addr & ~(numBlocksPerSector * blkSize - 1));
+    if (it != activeIndex.end())
+        retireSector(it->second);
+}
+
+void
+FootprintPrefetcher::calculatePrefetch(const PacketPtr &pkt,
+                                       std::vector<AddrPriority> &addresses)
+{
+    const Addr sector_size = numBlocksPerSector * blkSize;
+    const Addr pkt_addr = pkt->getAddr();
+    const Addr sector_addr = pkt_addr & ~(sector_size - 1);
+    const unsigned offset = (pkt_addr & (sector_size - 1)) >> lBlkSize;
+
+    auto it = activeIndex.find(sector_addr);
+    if (it != activeIndex.end()) {
+        // Already tracked, record the block and move the sector to MRU
+        it->second->footprint |= ULL(1) << offset;
+        activeList.splice(activeList.begin(), activeList, it->second);
+        return;
+    }
+
+    // First access to the sector, predict its footprint
+    const Addr pc = pkt->req->hasPC() ? pkt->req->getPC() : 0;
+    const Addr trigger = triggerHash(pc, offset);
+    const HistoryEntry &entry = history[trigger & historyMask];
+    uint64_t predicted = 0;
+
+    if (entry.valid && entry.trigger == trigger) {
+        footprintHits++;
+        predicted = entry.footprint;
+
+        DPRINTF(HWPrefetch, "Sector %#x triggered by PC %#x offset %d, "
+                "footprint %#x\n", sector_addr, pc, offset, predicted);
+
+        for (unsigned blk = 0; blk < numBlocksPerSector; blk++) {
+            if (blk != offset && bits(predicted, blk)) {
+                addresses.push_back(
+                    AddrPriority(sector_addr + blk * blkSize, 0));
+            }
+        }
+    } else {
+        footprintMisses++;
+    }
+
+    if (activeList.size() >= activeEntries)
+        retireSector(std::prev(activeList.end()));
+
+    activeList.emplace_front(sector_addr, trigger,
+                             predicted | (ULL(1) << offset));
+    activeList.front().footprint = ULL(1) << offset;
+    activeIndex[sector_addr] = activeList.begin();
+}
+
+void
+FootprintPrefetcher::regStats()
+{
+    QueuedPrefetcher::regStats();
+
+    footprintHits
+        .name(name() + ".footprintHits")
+        .desc("number of sectors triggered with a known footprint");
+
+    footprintMisses
+        .name(name() + ".footprintMisses")
+        .desc("number of sectors triggered without a known footprint");
+
+    footprintOverfetch
+        .name(name() + ".footprintOverfetch")
+        .desc("number of predicted blocks that were not referenced");
+
+    footprintUnderfetch
+        .name(name() + ".footprintUnderfetch")
+        .desc("number of referenced blocks that were not predicted");
+}
+
+FootprintPrefetcher*
+FootprintPrefetcherParams::create()
+{
+    return new FootprintPrefetcher(this);
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes a footprint prefetcher for sector caches.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_FOOTPRINT_HH__
+#define __MEM_CACHE_PREFETCH_FOOTPRINT_HH__
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "mem/cache/prefetch/queued.hh"
+#include "params/FootprintPrefetcher.hh"
+
+/**
+ * Footprint predictor, which together with SectorTags turns a cache
+ * into a footprint cache (Jevdjic et al., ISCA 2013). Space is
+ * allocated at sector granularity, but only the blocks predicted to be
+ * used during the sector's residency (its footprint) are fetched.
+ *
+ * The prefetcher tracks the blocks referenced in recently touched
+ * sectors. When the cache evicts a sector its footprint is stored in a
+ * history table indexed by the PC and sector offset of the access that
+ * first touched it. The next time that PC and offset trigger a new
+ * sector, the recorded footprint is prefetched.
+ *
+ * Only active_entries sectors are tracked at a time. If more sectors
+ * are resident in the cache, the least recently touched one is retired
+ * early, and its footprint is learnt before the sector is evicted.
+ * Sectors whose sub-blocks are all invalidated, e.g., by snoops, are
+ * not reported as evicted and are also retired this way.
+ */
+class FootprintPrefetcher : public QueuedPrefetcher
+{
+  protected:
+    /** Number of blocks per sector, at most 64. */
+    const unsigned numBlocksPerSector;
+
+    /** Number of sectors whose footprint is being recorded. */
+    const unsigned activeEntries;
+
+    /** Mask for the history table index. */
+    const unsigned historyMask;
+
+    /** A sector whose footprint is being recorded. */
+    struct ActiveSector
+    {
+        ActiveSector(Addr sector, Addr trigger, uint64_t predicted)
+            : sectorAddr(sector), trigger(trigger), footprint(0),
+              predicted(predicted)
+        {}
+
+        Addr sectorAddr;
+        /** Hash of the triggering PC and offset. */
+        Addr trigger;
+        /** Blocks referenced so far. */
+        uint64_t footprint;
+        /** Blocks predicted (and prefetched) when triggered. */
+        uint64_t predicted;
+    };
+
+    /** Active sectors, in MRU order. */
+    std::list<ActiveSector> activeList;
+
+    /** Index of the active sectors by sector address. */
+    std::unordered_map<Addr, std::list<ActiveSector>::iterator>
+        activeIndex;
+
+    /** A learnt footprint. */
+    struct HistoryEntry
+    {
+        HistoryEntry() : valid(false), trigger(0), footprint(0) {}
+
+        bool valid;
+        Addr trigger;
+        uint64_t footprint;
+    };
+
+    /** Direct-mapped footprint history table. */
+    std::vector<HistoryEntry> history;
+
+    /** Sectors triggered with a footprint available. */
+    Stats::Scalar footprintHits;
+    /** Sectors triggered without a footprint available. */
+    Stats::Scalar footprintMisses;
+    /** Prefetched blocks that were not referenced. */
+    Stats::Scalar footprintOverfetch;
+    /** Referenced blocks that were not prefetched. */
+    Stats::Scalar footprintUnderfetch;
+
+    /** Hash a trigger PC and sector offset into a history key. */
+    Addr triggerHash(Addr pc, unsigned offset) const;
+
+    /** Stop tracking a sector and learn its footprint. */
+    void retireSector(std::list<ActiveSector>::iterator it);
+
+  public:
+    FootprintPrefetcher(const FootprintPrefetcherParams *p);
+
+    void calculatePrefetch(const PacketPtr &pkt,
+                           std::vector<AddrPriority> &addresses);
+
+    void notifyEvict(Addr addr);
+
+    void regStats();
+};
+
+#endif // __MEM_CACHE_PREFETCH_FOOTPRINT_HH__
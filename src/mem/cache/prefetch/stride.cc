@@ -70,34 +70,107 @@ StridePrefetcher::StridePrefetcher(const StridePrefetcherParams *p)
     assert(isPowerOf2(pcTableSets));
 }
 
-StridePrefetcher::StrideEntry**
+int
 StridePrefetcher::PCTable::allocateNewContext(int context)
 {
-    auto res = entries.insert(std::make_pair(context,
-                              new StrideEntry*[pcTableSets]));
-    auto it = res.first;
-    chatty_assert(res.second, "Allocating an already created context\n");
-    assert(it->first == context);
-
-    DPRINTF(HWPrefetch, "Adding context %i with stride entries at %p\n",
-            context, it->second);
-
-    StrideEntry** entry = it->second;
-    for (int s = 0; s < pcTableSets; s++) {
-        entry[s] = new StrideEntry[pcTableAssoc];
+    chatty_assert(context >= contextSlots.size() ||
+                  contextSlots[context] < 0,
+                  "Allocating an already created context\n");
+
+    if (context >= contextSlots.size())
+        contextSlots.resize(context + 1, -1);
+
+    const int slot = contexts.size();
+    contextSlots[context] = slot;
+    contexts.push_back(context);
+    entries.resize(contexts.size() * pcTableSets * pcTableAssoc);
+
+    DPRINTF(HWPrefetch, "Adding context %i in table slot %i\n",
+            context, slot);
+
+    return slot;
+}
+
+void
+StridePrefetcher::PCTable::serialize(CheckpointOut &cp) const
+{
+    SERIALIZE_SCALAR(pcTableAssoc);
+    SERIALIZE_SCALAR(pcTableSets);
+    SERIALIZE_CONTAINER(contexts);
+
+    std::vector<Addr> instAddr, lastAddr;
+    std::vector<bool> isSecure;
+    std::vector<int> stride, confidence;
+    for (const auto &entry : entries) {
+        instAddr.push_back(entry.instAddr);
+        lastAddr.push_back(entry.lastAddr);
+        isSecure.push_back(entry.isSecure);
+        stride.push_back(entry.stride);
+        confidence.push_back(entry.confidence);
     }
-    return entry;
+    SERIALIZE_CONTAINER(instAddr);
+    SERIALIZE_CONTAINER(lastAddr);
+    SERIALIZE_CONTAINER(isSecure);
+    SERIALIZE_CONTAINER(stride);
+    SERIALIZE_CONTAINER(confidence);
 }
 
-StridePrefetcher::PCTable::~PCTable() {
-    for (auto entry : entries) {
-        for (int s = 0; s < pcTableSets; s++) {
-            delete[] entry.second[s];
-        }
-        delete[] entry.second;
+void
+StridePrefetcher::PCTable::unserialize(CheckpointIn &cp)
+{
+    int assoc, sets;
+    paramIn(cp, "pcTableAssoc", assoc);
+    paramIn(cp, "pcTableSets", sets);
+    fatal_if(assoc != pcTableAssoc || sets != pcTableSets,
+             "%s: checkpointed PC table geometry (%d sets, %d ways) does "
+             "not match the configuration (%d sets, %d ways)\n",
+             name(), sets, assoc, pcTableSets, pcTableAssoc);
+
+    std::vector<int> ckpt_contexts;
+    arrayParamIn(cp, "contexts", ckpt_contexts);
+
+    contextSlots.clear();
+    contexts.clear();
+    entries.clear();
+    for (auto context : ckpt_contexts)
+        allocateNewContext(context);
+
+    std::vector<Addr> instAddr, lastAddr;
+    std::vector<bool> isSecure;
+    std::vector<int> stride, confidence;
+    UNSERIALIZE_CONTAINER(instAddr);
+    UNSERIALIZE_CONTAINER(lastAddr);
+    UNSERIALIZE_CONTAINER(isSecure);
+    UNSERIALIZE_CONTAINER(stride);
+    UNSERIALIZE_CONTAINER(confidence);
+    fatal_if(instAddr.size() != entries.size(),
+             "%s: checkpoint holds %d PC table entries, expected %d\n",
+             name(), instAddr.size(), entries.size());
+
+    for (int i = 0; i < entries.size(); i++) {
+        entries[i].instAddr = instAddr[i];
+        entries[i].lastAddr = lastAddr[i];
+        entries[i].isSecure = isSecure[i];
+        entries[i].stride = stride[i];
+        entries[i].confidence = confidence[i];
     }
 }
 
+void
+StridePrefetcher::serialize(CheckpointOut &cp) const
+{
+    pcTable.serializeSection(cp, "pcTable");
+}
+
+void
+StridePrefetcher::unserialize(CheckpointIn &cp)
+{
+    // Checkpoints taken before the table was serialized have no
+    // section, in which case the prefetcher simply starts cold
+    if (cp.sectionExists(Serializable::currentSection() + ".pcTable"))
+        pcTable.unserializeSection(cp, "pcTable");
+}
+
 void
 StridePrefetcher::calculatePrefetch(const PacketPtr &pkt,
                                     std::vector<AddrPriority> &addresses)
@@ -193,7 +266,7 @@ StridePrefetcher::pcTableVictim(Addr pc, int master_id)
     int way = random_mt.random<int>(0, pcTableAssoc - 1);
 
     DPRINTF(HWPrefetch, "Victimizing lookup table[%d][%d].\n", set, way);
-    return &pcTable[master_id][set][way];
+    return &pcTable.getSet(master_id, set)[way];
 }
 
 inline bool
@@ -201,7 +274,7 @@ StridePrefetcher::pcTableHit(Addr pc, bool is_secure, int master_id,
                              StrideEntry* &entry)
 {
     int set = pcHash(pc);
-    StrideEntry* set_entries = pcTable[master_id][set];
+    StrideEntry* set_entries = pcTable.getSet(master_id, set);
     for (int way = 0; way < pcTableAssoc; way++) {
         // Search ways for match
         if (set_entries[way].instAddr == pc &&
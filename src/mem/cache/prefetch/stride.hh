@@ -48,7 +48,8 @@
 #ifndef __MEM_CACHE_PREFETCH_STRIDE_HH__
 #define __MEM_CACHE_PREFETCH_STRIDE_HH__
 
-#include <unordered_map>
+#include <string>
+#include <vector>
 
 #include "mem/cache/prefetch/queued.hh"
 #include "params/StridePrefetcher.hh"
@@ -81,28 +82,52 @@ class StridePrefetcher : public QueuedPrefetcher
         int confidence;
     };
 
-    class PCTable
+    /**
+     * Per-context, set-associative table of stride entries. All
+     * contexts share a single contiguous allocation laid out as
+     * [context][set][way], and contexts are located through a dense
+     * index so a lookup never has to hash the context.
+     */
+    class PCTable : public Serializable
     {
       public:
         PCTable(int assoc, int sets, const std::string name) :
             pcTableAssoc(assoc), pcTableSets(sets), _name(name) {}
-        StrideEntry** operator[] (int context) {
-            auto it = entries.find(context);
-            if (it != entries.end())
-                return it->second;
 
-            return allocateNewContext(context);
+        /**
+         * Get the first way of a set for the given context, allocating
+         * the context on first use.
+         *
+         * @param context Context (master id) to look up.
+         * @param set Set index within the context.
+         * @return Pointer to the pcTableAssoc entries of the set.
+         */
+        StrideEntry* getSet(int context, int set) {
+            int slot = context < contextSlots.size() ?
+                contextSlots[context] : -1;
+            if (slot < 0)
+                slot = allocateNewContext(context);
+
+            return &entries[(slot * pcTableSets + set) * pcTableAssoc];
         }
 
-        ~PCTable();
+        void serialize(CheckpointOut &cp) const override;
+        void unserialize(CheckpointIn &cp) override;
+
       private:
         const std::string name() {return _name; }
         const int pcTableAssoc;
         const int pcTableSets;
         const std::string _name;
-        std::unordered_map<int, StrideEntry**> entries;
 
-        StrideEntry** allocateNewContext(int context);
+        /** Slot of each context in the table, -1 if not allocated */
+        std::vector<int> contextSlots;
+        /** Context owning each slot, in allocation order */
+        std::vector<int> contexts;
+        /** Stride entries of all contexts */
+        std::vector<StrideEntry> entries;
+
+        int allocateNewContext(int context);
     };
     PCTable pcTable;
 
@@ -116,6 +141,9 @@ class StridePrefetcher : public QueuedPrefetcher
 
     void calculatePrefetch(const PacketPtr &pkt,
                            std::vector<AddrPriority> &addresses);
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
 };
 
 #endif // __MEM_CACHE_PREFETCH_STRIDE_HH__
@@ -84,3 +84,24 @@ class FALRU(BaseTags):
     type = 'FALRU'
     cxx_class = 'FALRU'
     cxx_header = "mem/cache/tags/fa_lru.hh"
+
+class SectorTags(BaseTags):
+    type = 'SectorTags'
+    cxx_class = 'SectorTags'
+    cxx_header = "mem/cache/tags/sector_tags.hh"
+    assoc = Param.Int(Parent.assoc, "associativity (in sectors)")
+    num_blocks_per_sector = Param.Unsigned(4, "Number of blocks per sector")
+
+class SkewedAssoc(BaseTags):
+    type = 'SkewedAssoc'
+    cxx_class = 'SkewedAssoc'
+    cxx_header = "mem/cache/tags/skewed_assoc.hh"
+    assoc = Param.Int(Parent.assoc, "associativity")
+    # A single level gives a plain skewed-associative cache, more levels
+    # give a zcache, e.g., 3 levels and 52 candidates for a 4-way Z4/52
+    walk_levels = Param.Unsigned(1, "Number of levels of the replacement walk")
+    max_candidates = Param.Unsigned(64,
+        "Maximum number of replacement candidates per walk")
+    assoc_dist_samples = Param.Unsigned(0, "Number of blocks sampled to "
+        "estimate the eviction priority of victims (0 to disable)")
+    hash_seed = Param.UInt32(1, "Seed of the per-way hash functions")
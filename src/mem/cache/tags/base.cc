@@ -50,6 +50,7 @@
 
 #include "cpu/smt.hh" //maxThreadsPerCPU
 #include "mem/cache/base.hh"
+#include "sim/core.hh"
 #include "sim/sim_exit.hh"
 
 using namespace std;
@@ -74,6 +75,40 @@ BaseTags::setCache(BaseCache *_cache)
     cache = _cache;
 }
 
+void
+BaseTags::resetTaskIdStats()
+{
+    for (unsigned i = 0; i < ContextSwitchTaskId::NumTaskId; ++i) {
+        occupanciesTaskId[i] = 0;
+        for (unsigned j = 0; j < 5; ++j) {
+            ageTaskId[i][j] = 0;
+        }
+    }
+}
+
+void
+BaseTags::sampleTaskIdStats(const CacheBlk &blk)
+{
+    assert(blk.task_id < ContextSwitchTaskId::NumTaskId);
+    occupanciesTaskId[blk.task_id]++;
+    assert(blk.tickInserted <= curTick());
+    Tick age = curTick() - blk.tickInserted;
+
+    int age_index;
+    if (age / SimClock::Int::us < 10) { // <10us
+        age_index = 0;
+    } else if (age / SimClock::Int::us < 100) { // <100us
+        age_index = 1;
+    } else if (age / SimClock::Int::ms < 1) { // <1ms
+        age_index = 2;
+    } else if (age / SimClock::Int::ms < 10) { // <10ms
+        age_index = 3;
+    } else
+        age_index = 4; // >10ms
+
+    ageTaskId[blk.task_id][age_index]++;
+}
+
 void
 BaseTags::regStats()
 {
@@ -50,6 +50,7 @@
 #define __MEM_CACHE_TAGS_BASE_HH__
 
 #include <string>
+#include <vector>
 
 #include "base/callback.hh"
 #include "base/statistics.hh"
@@ -148,6 +149,18 @@ class BaseTags : public ClockedObject
      * @}
      */
 
+    /**
+     * Clear the per task id occupancy and age stats before they are
+     * recomputed by computeStats().
+     */
+    void resetTaskIdStats();
+
+    /**
+     * Account a valid block in the per task id occupancy and age stats.
+     * @param blk The block to account for.
+     */
+    void sampleTaskIdStats(const CacheBlk &blk);
+
   public:
     typedef BaseTagsParams Params;
     BaseTags(const Params *p);
@@ -248,6 +261,18 @@ class BaseTags : public ClockedObject
 
     virtual CacheBlk* findVictim(Addr addr) = 0;
 
+    /**
+     * Find the blocks that have to be evicted along with the victim
+     * when allocating the given address. This is needed by tag stores
+     * where a tag covers several blocks, e.g., sector caches.
+     * @param addr The address being allocated.
+     * @param victim The victim selected by findVictim().
+     * @param evict_blks Valid blocks to evict are appended to this.
+     */
+    virtual void findCoVictims(Addr addr, CacheBlk *victim,
+                               std::vector<CacheBlk*> &evict_blks)
+    {}
+
     virtual int extractSet(Addr addr) const = 0;
 
     virtual void forEachBlk(CacheBlkVisitor &visitor) = 0;
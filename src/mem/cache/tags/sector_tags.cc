@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a sector tag store.
+ */
+
+#include "mem/cache/tags/sector_tags.hh"
+
+#include <string>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "debug/CacheRepl.hh"
+
+SectorTags::SectorTags(const Params *p)
+    : BaseTags(p), assoc(p->assoc), allocAssoc(p->assoc),
+      numBlocksPerSector(p->num_blocks_per_sector),
+      numSets(p->size / (p->block_size * p->num_blocks_per_sector *
+                         p->assoc)),
+      sequentialAccess(p->sequential_access),
+      sectors(numSets * assoc),
+      blks(p->size / p->block_size),
+      dataBlks(new uint8_t[p->size]), // Allocate data storage in one chunk
+      sectorShift(floorLog2(blkSize)),
+      sectorMask(numBlocksPerSector - 1),
+      setShift(sectorShift + floorLog2(numBlocksPerSector)),
+      setMask(numSets - 1),
+      tagShift(setShift + floorLog2(numSets)),
+      accessCount(0)
+{
+    // Check parameters
+    if (blkSize < 4 || !isPowerOf2(blkSize)) {
+        fatal("Block size must be at least 4 and a power of 2");
+    }
+    if (!isPowerOf2(numBlocksPerSector) || numBlocksPerSector > 64) {
+        fatal("# of blocks per sector must be a power of 2 no larger "
+              "than 64");
+    }
+    if (!isPowerOf2(numSets)) {
+        fatal("# of sets must be non-zero and a power of 2");
+    }
+    if (assoc <= 0) {
+        fatal("associativity must be greater than zero");
+    }
+
+    unsigned blkIndex = 0;       // index into blks array
+    for (unsigned i = 0; i < numSets; ++i) {
+        for (unsigned j = 0; j < assoc; ++j) {
+            for (unsigned k = 0; k < numBlocksPerSector; ++k) {
+                CacheBlk &blk = blks[blkIndex];
+
+                // Associate a data chunk to the block
+                blk.data = &dataBlks[blkSize * blkIndex];
+
+                // The set includes the sub-block index so that the
+                // block address can be regenerated from it
+                blk.set = i * numBlocksPerSector + k;
+                blk.way = j;
+
+                ++blkIndex;
+            }
+        }
+    }
+}
+
+CacheBlk*
+SectorTags::findBlockBySetAndWay(int set, int way) const
+{
+    const unsigned sector = (set / numBlocksPerSector) * assoc + way;
+    return const_cast<CacheBlk*>(
+        &blks[sector * numBlocksPerSector + (set & sectorMask)]);
+}
+
+void
+SectorTags::invalidate(CacheBlk *blk)
+{
+    assert(blk);
+    assert(blk->isValid());
+    tagsInUse--;
+    assert(blk->srcMasterId < cache->system->maxMasters());
+    occupancies[blk->srcMasterId]--;
+    blk->srcMasterId = Request::invldMasterId;
+    blk->task_id = ContextSwitchTaskId::Unknown;
+    blk->tickInserted = curTick();
+
+    SectorBlk &sector = sectors[sectorIndex(blk)];
+    assert(sector.numValid > 0);
+    --sector.numValid;
+}
+
+CacheBlk*
+SectorTags::accessBlock(Addr addr, bool is_secure, Cycles &lat)
+{
+    const int idx = findSector(extractSectorSet(addr), extractTag(addr));
+    CacheBlk *blk = nullptr;
+
+    if (idx >= 0) {
+        SectorBlk &sector = sectors[idx];
+        const unsigned sub_blk = extractSubBlk(addr);
+        sector.lastTouch = ++accessCount;
+
+        blk = &blks[idx * numBlocksPerSector + sub_blk];
+        if (blk->isValid() && blk->isSecure() == is_secure) {
+            sector.footprint |= ULL(1) << sub_blk;
+        } else {
+            blk = nullptr;
+            subBlkMisses++;
+        }
+    } else {
+        sectorMisses++;
+    }
+
+    // Access all sector tags in parallel, hence one in each way. The
+    // data side either accesses all sub-blocks selected by the set
+    // index in parallel, or one block sequentially on a hit.
+    tagAccesses += allocAssoc;
+    if (sequentialAccess) {
+        if (blk != nullptr) {
+            dataAccesses += 1;
+        }
+    } else {
+        dataAccesses += allocAssoc;
+    }
+
+    if (blk != nullptr) {
+        // If a cache hit
+        lat = accessLatency;
+        // Check if the block to be accessed is available. If not,
+        // apply the accessLatency on top of block->whenReady.
+        if (blk->whenReady > curTick() &&
+            cache->ticksToCycles(blk->whenReady - curTick()) >
+            accessLatency) {
+            lat = cache->ticksToCycles(blk->whenReady - curTick()) +
+            accessLatency;
+        }
+        blk->refCount += 1;
+    } else {
+        // If a cache miss
+        lat = lookupLatency;
+    }
+
+    return blk;
+}
+
+CacheBlk*
+SectorTags::findBlock(Addr addr, bool is_secure) const
+{
+    const int idx = findSector(extractSectorSet(addr), extractTag(addr));
+    if (idx < 0)
+        return nullptr;
+
+    const CacheBlk *blk = &blks[idx * numBlocksPerSector +
+                                extractSubBlk(addr)];
+    if (blk->isValid() && blk->isSecure() == is_secure)
+        return const_cast<CacheBlk*>(blk);
+
+    return nullptr;
+}
+
+CacheBlk*
+SectorTags::findVictim(Addr addr)
+{
+    const unsigned set = extractSectorSet(addr);
+    const unsigned sub_blk = extractSubBlk(addr);
+
+    // If the sector is already allocated, the sub-block has a fixed
+    // place within it
+    int idx = findSector(set, extractTag(addr));
+    if (idx < 0) {
+        // Otherwise prefer an unused sector, then the LRU one
+        for (unsigned way = 0; way < allocAssoc; ++way) {
+            const unsigned candidate = set * assoc + way;
+            if (sectors[candidate].numValid == 0) {
+                idx = candidate;
+                break;
+            }
+            if (idx < 0 ||
+                sectors[candidate].lastTouch < sectors[idx].lastTouch) {
+                idx = candidate;
+            }
+        }
+
+        if (idx >= 0 && sectors[idx].numValid) {
+            DPRINTF(CacheRepl, "set %x: selecting sector %x with %d valid "
+                    "blocks for replacement\n", set,
+                    sectors[idx].tag, sectors[idx].numValid);
+        }
+    }
+
+    return idx < 0 ? nullptr : &blks[idx * numBlocksPerSector + sub_blk];
+}
+
+void
+SectorTags::findCoVictims(Addr addr, CacheBlk *victim,
+                          std::vector<CacheBlk*> &evict_blks)
+{
+    const unsigned idx = sectorIndex(victim);
+    const SectorBlk &sector = sectors[idx];
+
+    // Filling a sub-block of an allocated sector does not disturb the
+    // other sub-blocks
+    if (sector.numValid == 0 || sector.tag == extractTag(addr))
+        return;
+
+    for (unsigned k = 0; k < numBlocksPerSector; ++k) {
+        CacheBlk *blk = &blks[idx * numBlocksPerSector + k];
+        if (blk != victim && blk->isValid())
+            evict_blks.push_back(blk);
+    }
+}
+
+void
+SectorTags::insertBlock(PacketPtr pkt, CacheBlk *blk)
+{
+    Addr addr = pkt->getAddr();
+    MasterID master_id = pkt->req->masterId();
+    uint32_t task_id = pkt->req->taskId();
+    Addr tag = extractTag(addr);
+    SectorBlk &sector = sectors[sectorIndex(blk)];
+
+    if (!blk->isTouched) {
+        tagsInUse++;
+        blk->isTouched = true;
+        if (!warmedUp && tagsInUse.value() >= warmupBound) {
+            warmedUp = true;
+            warmupCycle = curTick();
+        }
+    }
+
+    // A new sector is allocated either in an unused sector or in one
+    // whose other sub-blocks have all been evicted by the cache
+    if (sector.numValid == 0 || sector.tag != tag) {
+        assert(sector.numValid == (blk->isValid() ? 1 : 0));
+
+        if (sector.footprint) {
+            sectorReplacements++;
+            sectorFootprint.sample(popCount(sector.footprint));
+        }
+
+        sector.tag = tag;
+        sector.footprint = 0;
+        for (unsigned k = 0; k < numBlocksPerSector; ++k)
+            blks[sectorIndex(blk) * numBlocksPerSector + k].tag = tag;
+    }
+    sector.lastTouch = ++accessCount;
+    sector.footprint |= ULL(1) << extractSubBlk(addr);
+
+    // If we're replacing a block that was previously valid update
+    // stats for it. This can't be done in findBlock() because a
+    // found block might not actually be replaced there if the
+    // coherence protocol says it can't be.
+    if (blk->isValid()) {
+        replacements[0]++;
+        totalRefs += blk->refCount;
+        ++sampledRefs;
+        blk->refCount = 0;
+
+        // deal with evicted block
+        assert(blk->srcMasterId < cache->system->maxMasters());
+        occupancies[blk->srcMasterId]--;
+
+        blk->invalidate();
+    } else {
+        ++sector.numValid;
+    }
+
+    assert(blk->tag == tag);
+
+    // deal with what we are bringing in
+    assert(master_id < cache->system->maxMasters());
+    occupancies[master_id]++;
+    blk->srcMasterId = master_id;
+    blk->task_id = task_id;
+    blk->tickInserted = curTick();
+
+    // We only need to write into one tag and one data block.
+    tagAccesses += 1;
+    dataAccesses += 1;
+}
+
+std::string
+SectorTags::print() const
+{
+    std::string cache_state;
+    for (unsigned i = 0; i < numSets * assoc; ++i) {
+        if (!sectors[i].numValid)
+            continue;
+
+        cache_state += csprintf("\tset: %d sector: %d tag: %#x\n",
+                                i / assoc, i % assoc, sectors[i].tag);
+        for (unsigned k = 0; k < numBlocksPerSector; ++k) {
+            const CacheBlk &blk = blks[i * numBlocksPerSector + k];
+            if (blk.isValid())
+                cache_state += csprintf("\t\tblock: %d %s\n", k,
+                                        blk.print());
+        }
+    }
+    if (cache_state.empty())
+        cache_state = "no valid tags\n";
+    return cache_state;
+}
+
+void
+SectorTags::cleanupRefs()
+{
+    for (const auto &blk : blks) {
+        if (blk.isValid()) {
+            totalRefs += blk.refCount;
+            ++sampledRefs;
+        }
+    }
+}
+
+void
+SectorTags::computeStats()
+{
+    resetTaskIdStats();
+
+    for (const auto &blk : blks) {
+        if (blk.isValid())
+            sampleTaskIdStats(blk);
+    }
+}
+
+void
+SectorTags::regStats()
+{
+    BaseTags::regStats();
+
+    using namespace Stats;
+
+    sectorMisses
+        .name(name() + ".sector_misses")
+        .desc("Number of lookups without a matching sector")
+        ;
+
+    subBlkMisses
+        .name(name() + ".sub_blk_misses")
+        .desc("Number of lookups hitting a sector but missing the block")
+        ;
+
+    sectorReplacements
+        .name(name() + ".sector_replacements")
+        .desc("Number of replaced sectors")
+        ;
+
+    sectorFootprint
+        .init(0, numBlocksPerSector, 1)
+        .name(name() + ".sector_footprint")
+        .desc("Number of blocks referenced per replaced sector")
+        .flags(nozero)
+        ;
+}
+
+SectorTags*
+SectorTagsParams::create()
+{
+    return new SectorTags(this);
+}
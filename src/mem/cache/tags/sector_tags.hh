@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a sector tag store.
+ */
+
+#ifndef __MEM_CACHE_TAGS_SECTOR_TAGS_HH__
+#define __MEM_CACHE_TAGS_SECTOR_TAGS_HH__
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+#include "mem/cache/base.hh"
+#include "mem/cache/blk.hh"
+#include "mem/cache/tags/base.hh"
+#include "mem/packet.hh"
+#include "params/SectorTags.hh"
+
+/**
+ * A set associative sector cache tag store with LRU replacement of
+ * sectors.
+ *
+ * Each tag covers a sector of numBlocksPerSector consecutive cache
+ * blocks. The blocks of a sector (sub-blocks) are ordinary CacheBlks
+ * with their own valid, dirty and coherence state, but they share the
+ * sector tag, so a lookup only compares one tag per way regardless of
+ * the sector size. A sub-block miss in an allocated sector fills the
+ * sub-block in place, while a sector miss replaces a whole sector and
+ * evicts all of its valid sub-blocks.
+ *
+ * Addresses are split as | tag | sector set | sub-block | offset |. To
+ * keep the CacheBlk interface unchanged, the set reported through
+ * extractSet() and stored in CacheBlk::set includes the sub-block
+ * index, so regenerateBlkAddr() rebuilds the full block address.
+ */
+class SectorTags : public BaseTags
+{
+  protected:
+    /** A sector, i.e. a tag shared by numBlocksPerSector sub-blocks. */
+    struct SectorBlk
+    {
+        SectorBlk() : tag(0), numValid(0), lastTouch(0), footprint(0) {}
+
+        /** Sector tag, shared by all sub-blocks. */
+        Addr tag;
+        /** Number of valid sub-blocks. */
+        unsigned numValid;
+        /** Last access, used for LRU replacement of sectors. */
+        uint64_t lastTouch;
+        /** Sub-blocks referenced since the sector was allocated. */
+        uint64_t footprint;
+    };
+
+    /** The associativity (in sectors) of the cache. */
+    const unsigned assoc;
+    /** The allocatable associativity of the cache (alloc mask). */
+    unsigned allocAssoc;
+
+    /** The number of sub-blocks in a sector. */
+    const unsigned numBlocksPerSector;
+
+    /** The number of sector sets in the cache. */
+    const unsigned numSets;
+
+    /** Whether tags and data are accessed sequentially. */
+    const bool sequentialAccess;
+
+    /** The sectors, laid out as [set][way]. */
+    std::vector<SectorBlk> sectors;
+
+    /** The sub-blocks, laid out as [set][way][sub-block]. */
+    std::vector<CacheBlk> blks;
+
+    /** The data blocks, 1 per sub-block. */
+    std::unique_ptr<uint8_t[]> dataBlks;
+
+    /** The amount to shift the address to get the sub-block index. */
+    const int sectorShift;
+    /** Mask out all bits that aren't part of the sub-block index. */
+    const unsigned sectorMask;
+    /** The amount to shift the address to get the sector set. */
+    const int setShift;
+    /** Mask out all bits that aren't part of the sector set index. */
+    const unsigned setMask;
+    /** The amount to shift the address to get the tag. */
+    const int tagShift;
+
+    /** Sector access counter, used as the LRU timestamp. */
+    uint64_t accessCount;
+
+    /**
+     * @addtogroup SectorTagsStatistics
+     * @{
+     */
+
+    /** Number of lookups that found no sector with a matching tag. */
+    Stats::Scalar sectorMisses;
+    /** Number of lookups that found the sector but not the sub-block. */
+    Stats::Scalar subBlkMisses;
+    /** Number of sectors replaced after having been used. */
+    Stats::Scalar sectorReplacements;
+    /** Number of distinct sub-blocks referenced per replaced sector. */
+    Stats::Distribution sectorFootprint;
+
+    /**
+     * @}
+     */
+
+    /**
+     * Get the index of the sector a sub-block belongs to.
+     * @param blk The sub-block.
+     * @return Index of the sector in the sectors vector.
+     */
+    unsigned sectorIndex(const CacheBlk *blk) const
+    {
+        return (blk - blks.data()) / numBlocksPerSector;
+    }
+
+    /**
+     * Find the sector allocated to a tag in a given set.
+     * @param set The sector set.
+     * @param tag The sector tag.
+     * @return Index of the sector, -1 if none is allocated.
+     */
+    int findSector(unsigned set, Addr tag) const
+    {
+        for (unsigned way = 0; way < assoc; ++way) {
+            const unsigned idx = set * assoc + way;
+            if (sectors[idx].numValid && sectors[idx].tag == tag)
+                return idx;
+        }
+        return -1;
+    }
+
+    /**
+     * Calculate the sub-block index from the address.
+     * @param addr The address to get the sub-block index from.
+     * @return The sub-block index of the address.
+     */
+    unsigned extractSubBlk(Addr addr) const
+    {
+        return (addr >> sectorShift) & sectorMask;
+    }
+
+    /**
+     * Calculate the sector set index from the address.
+     * @param addr The address to get the set from.
+     * @return The sector set index of the address.
+     */
+    unsigned extractSectorSet(Addr addr) const
+    {
+        return (addr >> setShift) & setMask;
+    }
+
+  public:
+    /** Convenience typedef. */
+    typedef SectorTagsParams Params;
+
+    /**
+     * Construct and initialize this tag store.
+     */
+    SectorTags(const Params *p);
+
+    /**
+     * Destructor
+     */
+    virtual ~SectorTags() {};
+
+    /**
+     * Register local statistics.
+     */
+    void regStats() override;
+
+    CacheBlk *findBlockBySetAndWay(int set, int way) const override;
+
+    void invalidate(CacheBlk *blk) override;
+
+    CacheBlk* accessBlock(Addr addr, bool is_secure, Cycles &lat) override;
+
+    CacheBlk* findBlock(Addr addr, bool is_secure) const override;
+
+    /**
+     * Find the sub-block to fill for the address provided. If the sector
+     * of the address is allocated, this is the sub-block slot within the
+     * sector. Otherwise, an unused sector is preferred, and the least
+     * recently used sector is selected if there is none.
+     * @param addr The addr to a find a replacement candidate for.
+     * @return The candidate block.
+     */
+    CacheBlk* findVictim(Addr addr) override;
+
+    void findCoVictims(Addr addr, CacheBlk *victim,
+                       std::vector<CacheBlk*> &evict_blks) override;
+
+    void insertBlock(PacketPtr pkt, CacheBlk *blk) override;
+
+    void setWayAllocationMax(int ways) override
+    {
+        fatal_if(ways < 1, "Allocation limit must be greater than zero");
+        allocAssoc = ways;
+    }
+
+    int getWayAllocationMax() const override
+    {
+        return allocAssoc;
+    }
+
+    /**
+     * Generate the sector tag from the given address.
+     * @param addr The address to get the tag from.
+     * @return The tag of the address.
+     */
+    Addr extractTag(Addr addr) const override
+    {
+        return (addr >> tagShift);
+    }
+
+    /**
+     * Calculate the set index, including the sub-block index, from the
+     * address.
+     * @param addr The address to get the set from.
+     * @return The set index of the address.
+     */
+    int extractSet(Addr addr) const override
+    {
+        return (addr >> sectorShift) & (numSets * numBlocksPerSector - 1);
+    }
+
+    /**
+     * Regenerate the block address from the tag.
+     * @param tag The sector tag of the block.
+     * @param set The set of the block, including the sub-block index.
+     * @return The block address.
+     */
+    Addr regenerateBlkAddr(Addr tag, unsigned set) const override
+    {
+        return ((tag << tagShift) | ((Addr)set << sectorShift));
+    }
+
+    void cleanupRefs() override;
+
+    std::string print() const override;
+
+    void computeStats() override;
+
+    void forEachBlk(CacheBlkVisitor &visitor) override
+    {
+        for (auto &blk : blks) {
+            if (!visitor(blk))
+                return;
+        }
+    }
+};
+
+#endif //__MEM_CACHE_TAGS_SECTOR_TAGS_HH__
@@ -0,0 +1,436 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a skewed-associative tag store.
+ */
+
+#include "mem/cache/tags/skewed_assoc.hh"
+
+#include <algorithm>
+#include <string>
+
+#include "base/intmath.hh"
+#include "debug/CacheRepl.hh"
+
+void
+SkewedAssocBlk::swapContents(SkewedAssocBlk &other)
+{
+    std::swap(task_id, other.task_id);
+    std::swap(tag, other.tag);
+    std::swap(data, other.data);
+    std::swap(status, other.status);
+    std::swap(whenReady, other.whenReady);
+    std::swap(isTouched, other.isTouched);
+    std::swap(refCount, other.refCount);
+    std::swap(srcMasterId, other.srcMasterId);
+    std::swap(tickInserted, other.tickInserted);
+    std::swap(lastTouch, other.lastTouch);
+    lockList.swap(other.lockList);
+}
+
+SkewedAssoc::SkewedAssoc(const Params *p)
+    : BaseTags(p), assoc(p->assoc),
+      numSets(p->size / (p->block_size * p->assoc)),
+      setMask(numSets - 1),
+      tagShift(floorLog2(p->block_size)),
+      walkLevels(p->walk_levels),
+      maxCandidates(std::max<unsigned>(p->max_candidates, p->assoc)),
+      assocDistSamples(p->assoc_dist_samples),
+      sequentialAccess(p->sequential_access),
+      blks(p->size / p->block_size),
+      dataBlks(new uint8_t[p->size]), // Allocate data storage in one chunk
+      hashTables(p->assoc * 8 * 256),
+      accessCount(0),
+      rng(p->hash_seed)
+{
+    // Check parameters
+    if (blkSize < 4 || !isPowerOf2(blkSize)) {
+        fatal("Block size must be at least 4 and a power of 2");
+    }
+    if (!isPowerOf2(numSets)) {
+        fatal("# of sets must be non-zero and a power of 2");
+    }
+    if (assoc <= 1) {
+        fatal("associativity must be greater than one");
+    }
+    if (walkLevels == 0) {
+        fatal("The replacement walk needs at least one level");
+    }
+
+    candidates.reserve(maxCandidates);
+
+    // Draw one random row per address bit for each way, and expand
+    // them into per-byte tables so that hashing a block number only
+    // takes one lookup per byte
+    for (unsigned w = 0; w < assoc; ++w) {
+        for (unsigned byte = 0; byte < 8; ++byte) {
+            uint32_t rows[8];
+            for (unsigned bit = 0; bit < 8; ++bit)
+                rows[bit] = rng.random<uint32_t>();
+
+            uint32_t *table = &hashTables[(w * 8 + byte) * 256];
+            for (unsigned val = 0; val < 256; ++val) {
+                table[val] = 0;
+                for (unsigned bit = 0; bit < 8; ++bit) {
+                    if (val & (1 << bit))
+                        table[val] ^= rows[bit];
+                }
+            }
+        }
+    }
+
+    for (unsigned w = 0; w < assoc; ++w) {
+        for (unsigned i = 0; i < numSets; ++i) {
+            const unsigned blkIndex = w * numSets + i;
+            SkewedAssocBlk &blk = blks[blkIndex];
+
+            // Associate a data chunk to the block
+            blk.data = &dataBlks[blkSize * blkIndex];
+
+            blk.set = i;
+            blk.way = w;
+        }
+    }
+}
+
+CacheBlk*
+SkewedAssoc::findBlockBySetAndWay(int set, int way) const
+{
+    return const_cast<SkewedAssocBlk*>(&blks[way * numSets + set]);
+}
+
+void
+SkewedAssoc::invalidate(CacheBlk *blk)
+{
+    assert(blk);
+    assert(blk->isValid());
+    tagsInUse--;
+    assert(blk->srcMasterId < cache->system->maxMasters());
+    occupancies[blk->srcMasterId]--;
+    blk->srcMasterId = Request::invldMasterId;
+    blk->task_id = ContextSwitchTaskId::Unknown;
+    blk->tickInserted = curTick();
+}
+
+CacheBlk*
+SkewedAssoc::accessBlock(Addr addr, bool is_secure, Cycles &lat)
+{
+    SkewedAssocBlk *blk =
+        static_cast<SkewedAssocBlk*>(findBlock(addr, is_secure));
+
+    // Access all tags in parallel, hence one in each way.  The data side
+    // either accesses all blocks in parallel, or one block sequentially on
+    // a hit.  Sequential access with a miss doesn't access data.
+    tagAccesses += assoc;
+    if (sequentialAccess) {
+        if (blk != nullptr) {
+            dataAccesses += 1;
+        }
+    } else {
+        dataAccesses += assoc;
+    }
+
+    if (blk != nullptr) {
+        // If a cache hit
+        lat = accessLatency;
+        // Check if the block to be accessed is available. If not,
+        // apply the accessLatency on top of block->whenReady.
+        if (blk->whenReady > curTick() &&
+            cache->ticksToCycles(blk->whenReady - curTick()) >
+            accessLatency) {
+            lat = cache->ticksToCycles(blk->whenReady - curTick()) +
+            accessLatency;
+        }
+        blk->refCount += 1;
+        blk->lastTouch = ++accessCount;
+    } else {
+        // If a cache miss
+        lat = lookupLatency;
+    }
+
+    return blk;
+}
+
+CacheBlk*
+SkewedAssoc::findBlock(Addr addr, bool is_secure) const
+{
+    const Addr tag = extractTag(addr);
+    for (unsigned w = 0; w < assoc; ++w) {
+        const SkewedAssocBlk &blk = blks[position(w, tag)];
+        if (blk.tag == tag && blk.isValid() && blk.isSecure() == is_secure)
+            return const_cast<SkewedAssocBlk*>(&blk);
+    }
+    return nullptr;
+}
+
+bool
+SkewedAssoc::isCandidate(unsigned pos) const
+{
+    for (const auto &candidate : candidates) {
+        if (candidate.pos == pos)
+            return true;
+    }
+    return false;
+}
+
+CacheBlk*
+SkewedAssoc::findVictim(Addr addr)
+{
+    const Addr tag = extractTag(addr);
+
+    // The first level holds the positions of the address itself
+    candidates.clear();
+    for (unsigned w = 0; w < assoc; ++w)
+        candidates.push_back(Candidate{position(w, tag), -1, 0});
+
+    // Expand the walk breadth-first with the alternative positions of
+    // each candidate, until an invalid block is found or the walk is
+    // exhausted
+    for (unsigned i = 0; i < candidates.size() &&
+             candidates.size() < maxCandidates; ++i) {
+        const Candidate candidate = candidates[i];
+        const SkewedAssocBlk &blk = blks[candidate.pos];
+        if (!blk.isValid())
+            break;
+        if (candidate.level + 1 >= walkLevels)
+            continue;
+
+        for (unsigned w = 0; w < assoc &&
+                 candidates.size() < maxCandidates; ++w) {
+            if (w == blk.way)
+                continue;
+            const unsigned pos = position(w, blk.tag);
+            if (!isCandidate(pos)) {
+                candidates.push_back(
+                    Candidate{pos, (int)i, candidate.level + 1});
+            }
+        }
+    }
+
+    // Prefer the first invalid block, otherwise evict the LRU block.
+    // Blocks with an outstanding upgrade cannot be evicted.
+    int victim = -1;
+    for (unsigned i = 0; i < candidates.size(); ++i) {
+        const SkewedAssocBlk &blk = blks[candidates[i].pos];
+        if (!blk.isValid()) {
+            victim = i;
+            break;
+        }
+        if (victim >= 0 &&
+            blk.lastTouch >= blks[candidates[victim].pos].lastTouch) {
+            continue;
+        }
+        if (cache->inMissQueue(regenerateBlkAddr(blk.tag, blk.set),
+                               blk.isSecure())) {
+            continue;
+        }
+        victim = i;
+    }
+
+    // The walk reads one tag per candidate beyond the first level,
+    // which was already read by the lookup
+    tagAccesses += candidates.size() - assoc;
+    walkCandidates.sample(candidates.size());
+
+    if (victim < 0)
+        return nullptr;
+
+    if (blks[candidates[victim].pos].isValid() && assocDistSamples)
+        sampleEvictionPriority(blks[candidates[victim].pos]);
+
+    // Move the victim up to the first level, shifting the blocks on its
+    // path down by one position each
+    int c = victim;
+    unsigned moved = 0;
+    while (candidates[c].parent >= 0) {
+        const int p = candidates[c].parent;
+        SkewedAssocBlk &child = blks[candidates[c].pos];
+        SkewedAssocBlk &parent = blks[candidates[p].pos];
+        child.swapContents(parent);
+        if (child.isValid()) {
+            DPRINTF(CacheRepl, "relocating blk %x from way %d to way %d\n",
+                    regenerateBlkAddr(child.tag, child.set),
+                    parent.way, child.way);
+        }
+        ++moved;
+        c = p;
+    }
+
+    walkRelocations.sample(moved);
+    relocations += moved;
+    tagAccesses += moved;
+    dataAccesses += moved;
+
+    return &blks[candidates[c].pos];
+}
+
+void
+SkewedAssoc::sampleEvictionPriority(const SkewedAssocBlk &victim)
+{
+    unsigned sampled = 0;
+    unsigned more_recent = 0;
+    for (unsigned i = 0; i < assocDistSamples; ++i) {
+        const SkewedAssocBlk &blk =
+            blks[rng.random<unsigned>(0, blks.size() - 1)];
+        if (&blk == &victim || !blk.isValid())
+            continue;
+        ++sampled;
+        if (blk.lastTouch > victim.lastTouch)
+            ++more_recent;
+    }
+
+    if (sampled)
+        assocDistribution.sample(100 * more_recent / sampled);
+}
+
+void
+SkewedAssoc::insertBlock(PacketPtr pkt, CacheBlk *blk)
+{
+    Addr addr = pkt->getAddr();
+    MasterID master_id = pkt->req->masterId();
+    uint32_t task_id = pkt->req->taskId();
+
+    if (!blk->isTouched) {
+        tagsInUse++;
+        blk->isTouched = true;
+        if (!warmedUp && tagsInUse.value() >= warmupBound) {
+            warmedUp = true;
+            warmupCycle = curTick();
+        }
+    }
+
+    // If we're replacing a block that was previously valid update
+    // stats for it. This can't be done in findBlock() because a
+    // found block might not actually be replaced there if the
+    // coherence protocol says it can't be.
+    if (blk->isValid()) {
+        replacements[0]++;
+        totalRefs += blk->refCount;
+        ++sampledRefs;
+        blk->refCount = 0;
+
+        // deal with evicted block
+        assert(blk->srcMasterId < cache->system->maxMasters());
+        occupancies[blk->srcMasterId]--;
+
+        blk->invalidate();
+    }
+
+    // Set tag for new block.  Caller is responsible for setting status.
+    blk->tag = extractTag(addr);
+    static_cast<SkewedAssocBlk*>(blk)->lastTouch = ++accessCount;
+
+    // deal with what we are bringing in
+    assert(master_id < cache->system->maxMasters());
+    occupancies[master_id]++;
+    blk->srcMasterId = master_id;
+    blk->task_id = task_id;
+    blk->tickInserted = curTick();
+
+    // We only need to write into one tag and one data block.
+    tagAccesses += 1;
+    dataAccesses += 1;
+}
+
+std::string
+SkewedAssoc::print() const
+{
+    std::string cache_state;
+    for (const auto &blk : blks) {
+        if (blk.isValid())
+            cache_state += csprintf("\tway: %d set: %d %s\n", blk.way,
+                                    blk.set, blk.print());
+    }
+    if (cache_state.empty())
+        cache_state = "no valid tags\n";
+    return cache_state;
+}
+
+void
+SkewedAssoc::cleanupRefs()
+{
+    for (const auto &blk : blks) {
+        if (blk.isValid()) {
+            totalRefs += blk.refCount;
+            ++sampledRefs;
+        }
+    }
+}
+
+void
+SkewedAssoc::computeStats()
+{
+    resetTaskIdStats();
+
+    for (const auto &blk : blks) {
+        if (blk.isValid())
+            sampleTaskIdStats(blk);
+    }
+}
+
+void
+SkewedAssoc::regStats()
+{
+    BaseTags::regStats();
+
+    using namespace Stats;
+
+    walkCandidates
+        .init(0, maxCandidates, 1)
+        .name(name() + ".walk_candidates")
+        .desc("Number of replacement candidates per walk")
+        .flags(nozero)
+        ;
+
+    walkRelocations
+        .init(0, walkLevels - 1, 1)
+        .name(name() + ".walk_relocations")
+        .desc("Number of relocated blocks per replacement")
+        .flags(nozero)
+        ;
+
+    relocations
+        .name(name() + ".relocations")
+        .desc("Total number of relocated blocks")
+        ;
+
+    assocDistribution
+        .init(0, 100, 5)
+        .name(name() + ".assoc_distribution")
+        .desc("Estimated eviction priority of victims (%)")
+        .flags(pdf | nozero)
+        ;
+}
+
+SkewedAssoc*
+SkewedAssocParams::create()
+{
+    return new SkewedAssoc(this);
+}
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a skewed-associative tag store with optional zcache
+ * relocation.
+ */
+
+#ifndef __MEM_CACHE_TAGS_SKEWED_ASSOC_HH__
+#define __MEM_CACHE_TAGS_SKEWED_ASSOC_HH__
+
+#include <memory>
+#include <vector>
+
+#include "base/random.hh"
+#include "mem/cache/base.hh"
+#include "mem/cache/blk.hh"
+#include "mem/cache/tags/base.hh"
+#include "mem/packet.hh"
+#include "params/SkewedAssoc.hh"
+
+/**
+ * A skewed-associative cache block. The contents of a block, as
+ * opposed to its position (set and way), can be moved to another
+ * position when a zcache relocates it.
+ */
+class SkewedAssocBlk : public CacheBlk
+{
+  public:
+    SkewedAssocBlk() : CacheBlk(), lastTouch(0) {}
+
+    /** Last access, used for LRU replacement. */
+    uint64_t lastTouch;
+
+    /**
+     * Exchange the contents of two blocks, keeping their positions.
+     * @param other The block to exchange contents with.
+     */
+    void swapContents(SkewedAssocBlk &other);
+};
+
+/**
+ * A skewed-associative tag store (Seznec, ISCA 1993) with LRU
+ * replacement, which optionally performs zcache replacement walks
+ * (Sanchez and Kozyrakis, MICRO 2010).
+ *
+ * Each way is indexed with its own H3 hash of the block address, so
+ * blocks that conflict in one way are unlikely to conflict in the
+ * others. With a single walk level this is a plain skewed-associative
+ * cache: the replacement candidates are the block at the position of
+ * the address in each way. With more levels, the walk also considers
+ * the positions the candidates could be moved to in the other ways,
+ * and the candidates along the path to the victim are relocated. This
+ * provides many more replacement candidates, and thus higher effective
+ * associativity, while a lookup still only probes one position per
+ * way.
+ *
+ * Since the set of a block depends on its way, the tag holds the whole
+ * block number and the block address is regenerated from the tag only.
+ */
+class SkewedAssoc : public BaseTags
+{
+  protected:
+    /** The associativity of the cache. */
+    const unsigned assoc;
+
+    /** The number of blocks per way. */
+    const unsigned numSets;
+
+    /** Mask out all bits that aren't part of a way index. */
+    const unsigned setMask;
+
+    /** The amount to shift the address to get the block number. */
+    const int tagShift;
+
+    /** Number of levels of the replacement walk. */
+    const unsigned walkLevels;
+
+    /** Maximum number of replacement candidates of a walk. */
+    const unsigned maxCandidates;
+
+    /** Number of blocks sampled to estimate the eviction priority. */
+    const unsigned assocDistSamples;
+
+    /** Whether tags and data are accessed sequentially. */
+    const bool sequentialAccess;
+
+    /** The cache blocks, laid out as [way][set]. */
+    std::vector<SkewedAssocBlk> blks;
+
+    /** The data blocks, 1 per cache block. */
+    std::unique_ptr<uint8_t[]> dataBlks;
+
+    /**
+     * H3 hash functions, one per way, stored as one table per byte of
+     * the block number and laid out as [way][byte][value].
+     */
+    std::vector<uint32_t> hashTables;
+
+    /** Access counter, used as the LRU timestamp. */
+    uint64_t accessCount;
+
+    /** Private generator for the associativity distribution samples. */
+    Random rng;
+
+    /** A replacement candidate found by the walk. */
+    struct Candidate
+    {
+        /** Index of the block in blks. */
+        unsigned pos;
+        /** Candidate the block would be moved into, -1 if none. */
+        int parent;
+        /** Walk level the candidate was found at. */
+        unsigned level;
+    };
+
+    /** Candidates of the current walk, kept to avoid reallocation. */
+    std::vector<Candidate> candidates;
+
+    /**
+     * @addtogroup SkewedAssocStatistics
+     * @{
+     */
+
+    /** Number of replacement candidates per walk. */
+    Stats::Distribution walkCandidates;
+    /** Number of relocations per replacement. */
+    Stats::Distribution walkRelocations;
+    /** Total number of relocated blocks. */
+    Stats::Scalar relocations;
+    /**
+     * Estimated eviction priority of the victims, in percent. A victim
+     * has priority p if p% of the blocks are more recently used, so a
+     * fully associative LRU cache always evicts at 100%.
+     */
+    Stats::Distribution assocDistribution;
+
+    /**
+     * @}
+     */
+
+    /**
+     * Compute the position of a block number in a way.
+     * @param way The way to index.
+     * @param blk_num The block number.
+     * @return Index of the position in blks.
+     */
+    unsigned position(unsigned way, Addr blk_num) const
+    {
+        const uint32_t *table = &hashTables[way * 8 * 256];
+        uint32_t hash = 0;
+        for (; blk_num; blk_num >>= 8, table += 256)
+            hash ^= table[blk_num & 0xff];
+        return way * numSets + (hash & setMask);
+    }
+
+    /**
+     * Check whether a position is already a candidate of the walk.
+     * @param pos Index of the position in blks.
+     * @return True if the position is a candidate.
+     */
+    bool isCandidate(unsigned pos) const;
+
+    /**
+     * Sample the estimated eviction priority of a victim.
+     * @param victim The block being evicted.
+     */
+    void sampleEvictionPriority(const SkewedAssocBlk &victim);
+
+  public:
+    /** Convenience typedef. */
+    typedef SkewedAssocParams Params;
+
+    /**
+     * Construct and initialize this tag store.
+     */
+    SkewedAssoc(const Params *p);
+
+    /**
+     * Destructor
+     */
+    virtual ~SkewedAssoc() {};
+
+    /**
+     * Register local statistics.
+     */
+    void regStats() override;
+
+    CacheBlk *findBlockBySetAndWay(int set, int way) const override;
+
+    void invalidate(CacheBlk *blk) override;
+
+    CacheBlk* accessBlock(Addr addr, bool is_secure, Cycles &lat) override;
+
+    CacheBlk* findBlock(Addr addr, bool is_secure) const override;
+
+    /**
+     * Find a victim for the address provided by walking the candidate
+     * positions. The blocks on the path between the victim and the
+     * position of the address are relocated, so the victim returned is
+     * always at one of the positions of the address.
+     * @param addr The addr to a find a replacement candidate for.
+     * @return The candidate block.
+     */
+    CacheBlk* findVictim(Addr addr) override;
+
+    void insertBlock(PacketPtr pkt, CacheBlk *blk) override;
+
+    /**
+     * Generate the tag, i.e., the block number, from the given address.
+     * @param addr The address to get the tag from.
+     * @return The tag of the address.
+     */
+    Addr extractTag(Addr addr) const override
+    {
+        return (addr >> tagShift);
+    }
+
+    /**
+     * Calculate the set index of the address in the first way.
+     * @param addr The address to get the set from.
+     * @return The set index of the address.
+     */
+    int extractSet(Addr addr) const override
+    {
+        return position(0, extractTag(addr));
+    }
+
+    /**
+     * Regenerate the block address from the tag.
+     * @param tag The tag of the block.
+     * @param set Unused, the tag holds the whole block number.
+     * @return The block address.
+     */
+    Addr regenerateBlkAddr(Addr tag, unsigned set) const override
+    {
+        return (tag << tagShift);
+    }
+
+    void cleanupRefs() override;
+
+    std::string print() const override;
+
+    void computeStats() override;
+
+    void forEachBlk(CacheBlkVisitor &visitor) override
+    {
+        for (auto &blk : blks) {
+            if (!visitor(blk))
+                return;
+        }
+    }
+};
+
+#endif //__MEM_CACHE_TAGS_SKEWED_ASSOC_HH__
@@ -0,0 +1,456 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definition of the channel group front-end.
+ */
+
+#include "mem/channel_group.hh"
+
+#include "base/intmath.hh"
+#include "base/trace.hh"
+#include "debug/ChannelGroup.hh"
+#include "debug/Drain.hh"
+#include "mem/abstract_mem.hh"
+
+ChannelGroup::ChannelGroup(const ChannelGroupParams* p) :
+    MemObject(p),
+    port(name() + ".port", *this),
+    crossingLatency(p->crossing_latency),
+    bufferSize(p->channel_buffer_size),
+    intlvLowBit(0), intlvMask(0), retryReq(false), respInFlight(0)
+{
+    fatal_if(p->port_channels_connection_count != p->mem_ctrls.size(),
+             "%s has %d channel ports connected but %d channels, use "
+             "attachChannels\n", name(), p->port_channels_connection_count,
+             p->mem_ctrls.size());
+    fatal_if(p->mem_ctrls.empty(), "%s has no channels\n", name());
+    fatal_if(bufferSize == 0, "%s channel buffer size must be non-zero\n",
+             name());
+
+    for (int i = 0; i < p->mem_ctrls.size(); ++i) {
+        Channel* ch = new Channel(csprintf("%s.channels[%d]", name(), i),
+                                  *this, i, p->mem_ctrls[i]->eventQueue(),
+                                  bufferSize);
+        ch->crossing = ch->eventq != eventQueue();
+        channels.push_back(ch);
+    }
+}
+
+ChannelGroup::~ChannelGroup()
+{
+    for (auto ch : channels)
+        delete ch;
+}
+
+BaseMasterPort&
+ChannelGroup::getMasterPort(const std::string& if_name, PortID idx)
+{
+    if (if_name == "channels" && idx < channels.size()) {
+        return channels[idx]->port;
+    } else {
+        return MemObject::getMasterPort(if_name, idx);
+    }
+}
+
+BaseSlavePort&
+ChannelGroup::getSlavePort(const std::string& if_name, PortID idx)
+{
+    if (if_name == "port") {
+        return port;
+    } else {
+        return MemObject::getSlavePort(if_name, idx);
+    }
+}
+
+void
+ChannelGroup::init()
+{
+    MemObject::init();
+
+    if (!port.isConnected())
+        fatal("%s is not connected on all sides.\n", name());
+
+    const ChannelGroupParams* p =
+        dynamic_cast<const ChannelGroupParams*>(params());
+
+    std::vector<AddrRange> ranges;
+    for (auto m : p->mem_ctrls)
+        ranges.push_back(m->getAddrRange());
+
+    for (auto ch : channels) {
+        fatal_if(ch->crossing &&
+                 std::max(crossingLatency, simQuantum) == 0,
+                 "%s has channels on other event queues, which requires a "
+                 "non-zero crossing latency or simulation quantum\n",
+                 name());
+    }
+
+    // if the channels stripe a single range without hashing, we can
+    // route by looking up the interleaving bits, determining which
+    // channel each stripe belongs to by probing the first chunk of
+    // the range
+    const AddrRange& first = ranges.front();
+    bool use_table = first.interleaved() && !first.hashed() &&
+        first.stripes() == channels.size();
+    for (const auto& r : ranges)
+        use_table = use_table && r.mergesWith(first);
+
+    if (use_table) {
+        const Addr chunk = first.granularity() * first.stripes();
+        const Addr base = roundUp(first.start(), chunk);
+        use_table = base + chunk - 1 <= first.end();
+
+        if (use_table) {
+            intlvLowBit = floorLog2(first.granularity());
+            intlvMask = first.stripes() - 1;
+            routeTable.assign(first.stripes(), InvalidPortID);
+
+            for (int s = 0; s < routeTable.size(); ++s) {
+                const Addr probe = base + s * first.granularity();
+                for (int i = 0; i < ranges.size(); ++i) {
+                    if (ranges[i].contains(probe))
+                        routeTable[s] = i;
+                }
+                use_table = use_table && routeTable[s] != InvalidPortID;
+            }
+        }
+    }
+
+    if (!use_table)
+        routeTable.clear();
+
+    DPRINTF(ChannelGroup, "Routing %d channels by %s\n", channels.size(),
+            use_table ? "table lookup" : "range search");
+
+    port.sendRangeChange();
+}
+
+PortID
+ChannelGroup::route(Addr addr) const
+{
+    if (!routeTable.empty())
+        return routeTable[(addr >> intlvLowBit) & intlvMask];
+
+    const ChannelGroupParams* p =
+        dynamic_cast<const ChannelGroupParams*>(params());
+    for (int i = 0; i < p->mem_ctrls.size(); ++i) {
+        if (p->mem_ctrls[i]->getAddrRange().contains(addr))
+            return i;
+    }
+
+    panic("%s has no channel for address %#x\n", name(), addr);
+}
+
+bool
+ChannelGroup::recvTimingReq(PacketPtr pkt)
+{
+    const PortID id = route(pkt->getAddr());
+    Channel& ch = *channels[id];
+
+    DPRINTF(ChannelGroup, "recvTimingReq: %s addr %#x to channel %d\n",
+            pkt->cmdString(), pkt->getAddr(), id);
+
+    if (!ch.crossing) {
+        // same event queue, let the channel decide and relay its
+        // retry when it comes
+        if (!ch.port.sendTimingReq(pkt)) {
+            DPRINTF(ChannelGroup, "Channel %d busy\n", id);
+            retryReq = true;
+            ++refusedReqs;
+            return false;
+        }
+    } else {
+        // another event queue, send the request over if the channel
+        // has room for it
+        if (ch.credits == 0) {
+            DPRINTF(ChannelGroup, "Channel %d out of credits\n", id);
+            retryReq = true;
+            ++refusedReqs;
+            return false;
+        }
+
+        --ch.credits;
+        ++crossingReqs;
+        {
+            std::lock_guard<std::mutex> lock(ch.crossingLock);
+            ch.inCrossing.push_back(pkt);
+        }
+        ch.eventq->schedule(new EventFunctionWrapper(
+                                [this, &ch, pkt]{ sendToChannel(ch, pkt); },
+                                name() + ".crossReqEvent", true),
+                            crossingTime(), true);
+    }
+
+    ++channelReqs[id];
+    return true;
+}
+
+void
+ChannelGroup::sendToChannel(Channel& ch, PacketPtr pkt)
+{
+    {
+        std::lock_guard<std::mutex> lock(ch.crossingLock);
+        assert(ch.inCrossing.front() == pkt);
+        ch.inCrossing.pop_front();
+    }
+
+    // keep the requests in order behind any waiting for a retry
+    if (ch.waitingRetry || !ch.port.sendTimingReq(pkt)) {
+        ch.waiting.push_back(pkt);
+        ch.waitingRetry = true;
+    } else {
+        returnCredit(ch);
+    }
+}
+
+void
+ChannelGroup::returnCredit(Channel& ch)
+{
+    eventQueue()->schedule(new EventFunctionWrapper(
+                               [this, &ch]{
+                                   ++ch.credits;
+                                   trySendRetry();
+                                   checkDrained();
+                               },
+                               name() + ".creditEvent", true),
+                           crossingTime(), true);
+}
+
+void
+ChannelGroup::recvReqRetry(PortID id)
+{
+    Channel& ch = *channels[id];
+
+    if (!ch.crossing) {
+        trySendRetry();
+        return;
+    }
+
+    ch.waitingRetry = false;
+    while (!ch.waiting.empty()) {
+        if (!ch.port.sendTimingReq(ch.waiting.front())) {
+            ch.waitingRetry = true;
+            return;
+        }
+        ch.waiting.pop_front();
+        returnCredit(ch);
+    }
+}
+
+void
+ChannelGroup::trySendRetry()
+{
+    if (retryReq) {
+        retryReq = false;
+        port.sendRetryReq();
+    }
+}
+
+bool
+ChannelGroup::recvTimingResp(PortID id, PacketPtr pkt)
+{
+    DPRINTF(ChannelGroup, "recvTimingResp: %s addr %#x from channel %d\n",
+            pkt->cmdString(), pkt->getAddr(), id);
+
+    if (!channels[id]->crossing) {
+        port.schedTimingResp(pkt, curTick());
+    } else {
+        // cross back to our event queue, where the response is queued
+        ++respInFlight;
+        eventQueue()->schedule(new EventFunctionWrapper(
+                                   [this, pkt]{
+                                       --respInFlight;
+                                       port.schedTimingResp(pkt, curTick());
+                                       checkDrained();
+                                   },
+                                   name() + ".crossRespEvent", true),
+                               crossingTime(), true);
+    }
+
+    return true;
+}
+
+Tick
+ChannelGroup::recvAtomic(PacketPtr pkt)
+{
+    Channel& ch = *channels[route(pkt->getAddr())];
+
+    // atomic accesses are only used when the timing does not matter,
+    // so simply take over the event queue of the channel
+    EventQueue::ScopedMigration migrate(ch.eventq, ch.crossing);
+    return ch.port.sendAtomic(pkt);
+}
+
+void
+ChannelGroup::recvFunctional(PacketPtr pkt)
+{
+    Channel& ch = *channels[route(pkt->getAddr())];
+
+    // take over the event queue of the channel, as for atomic
+    // accesses, so that the channel does not change underneath us
+    EventQueue::ScopedMigration migrate(ch.eventq, ch.crossing);
+
+    if (ch.crossing) {
+        // requests already accepted, but still crossing over or
+        // waiting for the channel, may hold newer data than the
+        // channel, so check them from the newest
+        std::lock_guard<std::mutex> lock(ch.crossingLock);
+        for (auto p = ch.inCrossing.rbegin(); p != ch.inCrossing.rend();
+             ++p) {
+            if (pkt->checkFunctional(*p)) {
+                pkt->makeResponse();
+                return;
+            }
+        }
+        for (auto p = ch.waiting.rbegin(); p != ch.waiting.rend(); ++p) {
+            if (pkt->checkFunctional(*p)) {
+                pkt->makeResponse();
+                return;
+            }
+        }
+    }
+
+    ch.port.sendFunctional(pkt);
+}
+
+AddrRangeList
+ChannelGroup::getAddrRanges() const
+{
+    const ChannelGroupParams* p =
+        dynamic_cast<const ChannelGroupParams*>(params());
+
+    AddrRangeList ranges;
+    for (auto m : p->mem_ctrls)
+        ranges.push_back(m->getAddrRange());
+    return ranges;
+}
+
+void
+ChannelGroup::checkDrained()
+{
+    if (drainState() == DrainState::Draining &&
+        drain() == DrainState::Drained) {
+        DPRINTF(Drain, "ChannelGroup done draining\n");
+        signalDrainDone();
+    }
+}
+
+DrainState
+ChannelGroup::drain()
+{
+    bool idle = respInFlight == 0;
+    for (auto ch : channels)
+        idle = idle && (!ch->crossing || ch->credits == bufferSize);
+
+    return idle ? DrainState::Drained : DrainState::Draining;
+}
+
+void
+ChannelGroup::regStats()
+{
+    using namespace Stats;
+
+    MemObject::regStats();
+
+    channelReqs
+        .init(channels.size())
+        .name(name() + ".channelReqs")
+        .desc("Number of requests routed to each channel");
+
+    for (int i = 0; i < channels.size(); ++i)
+        channelReqs.subname(i, csprintf("channel%d", i));
+
+    crossingReqs
+        .name(name() + ".crossingReqs")
+        .desc("Number of requests sent to channels on other event queues");
+
+    refusedReqs
+        .name(name() + ".refusedReqs")
+        .desc("Number of requests refused due to a busy channel");
+}
+
+ChannelGroup::CpuSidePort::CpuSidePort(const std::string& name,
+                                       ChannelGroup& _group)
+    : QueuedSlavePort(name, &_group, queue), queue(_group, *this),
+      group(_group)
+{ }
+
+Tick
+ChannelGroup::CpuSidePort::recvAtomic(PacketPtr pkt)
+{
+    return group.recvAtomic(pkt);
+}
+
+void
+ChannelGroup::CpuSidePort::recvFunctional(PacketPtr pkt)
+{
+    pkt->pushLabel(group.name());
+
+    if (!queue.checkFunctional(pkt)) {
+        group.recvFunctional(pkt);
+    }
+
+    pkt->popLabel();
+}
+
+bool
+ChannelGroup::CpuSidePort::recvTimingReq(PacketPtr pkt)
+{
+    return group.recvTimingReq(pkt);
+}
+
+AddrRangeList
+ChannelGroup::CpuSidePort::getAddrRanges() const
+{
+    return group.getAddrRanges();
+}
+
+ChannelGroup::ChannelPort::ChannelPort(const std::string& name,
+                                       ChannelGroup& _group, PortID id)
+    : MasterPort(name, &_group, id), group(_group)
+{ }
+
+bool
+ChannelGroup::ChannelPort::recvTimingResp(PacketPtr pkt)
+{
+    return group.recvTimingResp(id, pkt);
+}
+
+void
+ChannelGroup::ChannelPort::recvReqRetry()
+{
+    group.recvReqRetry(id);
+}
+
+ChannelGroup*
+ChannelGroupParams::create()
+{
+    return new ChannelGroup(this);
+}
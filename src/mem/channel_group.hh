@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * ChannelGroup declaration
+ */
+
+#ifndef __MEM_CHANNEL_GROUP_HH__
+#define __MEM_CHANNEL_GROUP_HH__
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/mem_object.hh"
+#include "mem/qport.hh"
+#include "params/ChannelGroup.hh"
+
+/**
+ * The channel group is a front-end that owns a number of memory
+ * channels with interleaved address ranges. Requests are routed to
+ * their channel with a table lookup on the interleaving bits, falling
+ * back to searching the channel ranges if they are hashed or not
+ * interleaved, and are forwarded without any added latency.
+ *
+ * A channel on the same event queue as the group is accessed
+ * directly, with the group relaying the flow control. A channel on
+ * another event queue is accessed by scheduling the forwarding on the
+ * queue of the channel, at least a simulation quantum ahead, and the
+ * responses cross back the same way. The group then limits the
+ * requests in flight to each such channel using credits, returned as
+ * the channel accepts the requests, so that the group never has to
+ * wait for a channel synchronously.
+ */
+class ChannelGroup : public MemObject
+{
+
+  private:
+
+    class CpuSidePort : public QueuedSlavePort
+    {
+
+        RespPacketQueue queue;
+        ChannelGroup& group;
+
+      public:
+
+        CpuSidePort(const std::string& name, ChannelGroup& _group);
+
+      protected:
+
+        Tick recvAtomic(PacketPtr pkt);
+
+        void recvFunctional(PacketPtr pkt);
+
+        bool recvTimingReq(PacketPtr pkt);
+
+        AddrRangeList getAddrRanges() const;
+
+    };
+
+    class ChannelPort : public MasterPort
+    {
+
+        ChannelGroup& group;
+
+      public:
+
+        ChannelPort(const std::string& name, ChannelGroup& _group,
+                    PortID id);
+
+      protected:
+
+        bool recvTimingResp(PacketPtr pkt);
+
+        void recvReqRetry();
+
+        void recvRangeChange() { }
+
+    };
+
+    /**
+     * The state of a channel. The requests waiting for the channel to
+     * retry are only accessed with the event queue of the channel
+     * held, the credits only from the event queue of the group, and
+     * the requests crossing over with the crossing lock held.
+     */
+    struct Channel {
+
+        Channel(const std::string& name, ChannelGroup& group, PortID id,
+                EventQueue* _eventq, unsigned int _credits)
+            : port(name, group, id), eventq(_eventq), crossing(false),
+              credits(_credits), waitingRetry(false)
+        { }
+
+        ChannelPort port;
+
+        /** Event queue the channel runs on */
+        EventQueue* eventq;
+
+        /** Is the channel on another event queue than the group */
+        bool crossing;
+
+        /** Requests the group may still send to a crossing channel */
+        unsigned int credits;
+
+        /** Requests on their way to a crossing channel, in order */
+        std::deque<PacketPtr> inCrossing;
+
+        /** Lock protecting the requests on their way over */
+        std::mutex crossingLock;
+
+        /** Requests refused by the channel, in order */
+        std::deque<PacketPtr> waiting;
+
+        /** Is the channel expected to send a retry */
+        bool waitingRetry;
+
+    };
+
+    CpuSidePort port;
+
+    std::vector<Channel*> channels;
+
+    /** Latency of crossing between the event queues */
+    const Tick crossingLatency;
+
+    /** Credits of each crossing channel */
+    const unsigned int bufferSize;
+
+    /**
+     * Channel index for each value of the interleaving bits, empty if
+     * the ranges cannot be routed by table lookup.
+     */
+    std::vector<PortID> routeTable;
+
+    /** Lowest bit of the interleaving bits */
+    unsigned int intlvLowBit;
+
+    /** Mask of the interleaving bits, after shifting */
+    Addr intlvMask;
+
+    /** Did we refuse a request and owe the requestor a retry */
+    bool retryReq;
+
+    /** Responses crossing back from the channels */
+    std::atomic<unsigned int> respInFlight;
+
+    Stats::Vector channelReqs;
+    Stats::Scalar crossingReqs;
+    Stats::Scalar refusedReqs;
+
+    /**
+     * Determine the channel an address belongs to.
+     *
+     * @param addr Address to route
+     * @return The index of the channel
+     */
+    PortID route(Addr addr) const;
+
+    /**
+     * Forward a request to a channel, called on the event queue of the
+     * channel.
+     *
+     * @param ch The channel to send to
+     * @param pkt The request
+     */
+    void sendToChannel(Channel& ch, PacketPtr pkt);
+
+    /**
+     * Return a credit once a crossing channel accepted a request,
+     * called on the event queue of the channel.
+     *
+     * @param ch The channel that accepted the request
+     */
+    void returnCredit(Channel& ch);
+
+    /**
+     * Send a retry to the requestor if we owe it one.
+     */
+    void trySendRetry();
+
+    /**
+     * Check if there is nothing in flight to or from a crossing
+     * channel, and if so signal that we are drained.
+     */
+    void checkDrained();
+
+    /** Time of a crossing from the current tick */
+    Tick crossingTime() const
+    { return curTick() + std::max(crossingLatency, simQuantum); }
+
+    bool recvTimingReq(PacketPtr pkt);
+
+    bool recvTimingResp(PortID id, PacketPtr pkt);
+
+    void recvReqRetry(PortID id);
+
+    Tick recvAtomic(PacketPtr pkt);
+
+    void recvFunctional(PacketPtr pkt);
+
+    AddrRangeList getAddrRanges() const;
+
+  public:
+
+    ChannelGroup(const ChannelGroupParams* p);
+    ~ChannelGroup();
+
+    BaseMasterPort& getMasterPort(const std::string& if_name,
+                                  PortID idx = InvalidPortID) override;
+
+    BaseSlavePort& getSlavePort(const std::string& if_name,
+                                PortID idx = InvalidPortID) override;
+
+    void init() override;
+
+    void regStats() override;
+
+    DrainState drain() override;
+
+};
+
+#endif //__MEM_CHANNEL_GROUP_HH__
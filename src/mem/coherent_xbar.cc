@@ -299,6 +299,11 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
     if (snoopFilter && snoop_caches) {
         // Let the snoop filter know about the success of the send operation
         snoopFilter->finishRequest(!success, addr, pkt->isSecure());
+
+        // now that the request is accepted, remove any lines the
+        // snoop filter dropped to make room for it from the caches
+        // above
+        sendBackInvalidations(true);
     }
 
     // check if we were successful in sending the packet onwards
@@ -757,6 +762,11 @@ CoherentXBar::recvAtomic(PacketPtr pkt, PortID slave_port_id)
             // between and change the filter state
             snoopFilter->finishRequest(false, pkt->getAddr(), pkt->isSecure());
 
+            // remove any lines the snoop filter dropped to make room
+            // for this request from the caches above, again before
+            // any other snoops or requests are sent
+            sendBackInvalidations(false);
+
             if (pkt->isEviction()) {
                 // for block-evicting packets, i.e. writebacks and
                 // clean evictions, there is no need to snoop up, as
@@ -907,6 +917,41 @@ CoherentXBar::recvAtomicSnoop(PacketPtr pkt, PortID master_port_id)
     return snoop_response_latency;
 }
 
+void
+CoherentXBar::sendBackInvalidations(bool is_timing)
+{
+    auto& back_invs = snoopFilter->getBackInvalidations();
+    for (const auto& inv : back_invs) {
+        // the request has no destination flags, so that a dirty copy
+        // is written back to the level below this crossbar and stays
+        // there
+        Request::Flags flags = Request::CLEAN | Request::INVALIDATE;
+        if (inv.isSecure)
+            flags.set(Request::SECURE);
+        Request req(inv.addr, system->cacheLineSize(), flags,
+                    snoopFilter->backInvalidationMasterId());
+        Packet snoop_pkt(&req, MemCmd::CleanInvalidReq);
+        snoop_pkt.setExpressSnoop();
+        snoop_pkt.setBackInvalidation();
+
+        DPRINTF(CoherentXBar, "%s: back-invalidating %s at %d ports\n",
+                __func__, snoop_pkt.print(), inv.ports.size());
+
+        for (const auto& p : inv.ports) {
+            if (is_timing) {
+                p->sendTimingSnoopReq(&snoop_pkt);
+            } else {
+                p->sendAtomicSnoop(&snoop_pkt);
+            }
+            snoops++;
+        }
+
+        // caches do not respond to cache maintenance snoops
+        assert(!snoop_pkt.cacheResponding());
+    }
+    back_invs.clear();
+}
+
 std::pair<MemCmd, Tick>
 CoherentXBar::forwardAtomic(PacketPtr pkt, PortID exclude_slave_port_id,
                            PortID source_master_port_id,
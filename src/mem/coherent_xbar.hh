@@ -382,6 +382,16 @@ class CoherentXBar : public BaseXBar
                                           const std::vector<QueuedSlavePort*>&
                                           dests);
 
+    /**
+     * Send cleaning and invalidating snoops to the caches above that
+     * hold lines which the snoop filter had to drop due to its
+     * limited capacity. Dirty copies are written back to the memory
+     * below as part of handling the snoop.
+     *
+     * @param is_timing Whether to send timing or atomic snoops
+     */
+    void sendBackInvalidations(bool is_timing);
+
     /** Function called by the port when the crossbar is recieving a Functional
         transaction.*/
     void recvFunctional(PacketPtr pkt, PortID slave_port_id);
@@ -0,0 +1,635 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/dram_cache.hh"
+
+#include <algorithm>
+
+#include "base/trace.hh"
+#include "debug/DRAMCache.hh"
+#include "debug/Drain.hh"
+#include "sim/system.hh"
+
+DRAMCache::DRAMCache(const DRAMCacheParams* p) :
+    AbstractMemory(p),
+    port(name() + ".port", *this),
+    cachePort(name() + ".cache_port", *this),
+    memPort(name() + ".mem_port", *this),
+    tagLocation(p->tag_location), tagSize(p->tag_size),
+    tagLatency(p->tag_latency), staticLatency(p->static_latency),
+    missPredictor(p->miss_predictor), bufferSize(p->buffer_size),
+    masterId(Request::invldMasterId), lineSize(0), entrySize(0),
+    cacheStart(0), predictor(p->predictor_entries, 0),
+    numTransactions(0), outstanding(0), retryReq(false)
+{
+    fatal_if(p->trace_file != "", "%s does not support access "
+             "tracing\n", name());
+    fatal_if(missPredictor && predictor.empty(),
+             "%s needs at least one miss predictor entry\n", name());
+    fatal_if(bufferSize == 0, "%s needs a non-zero buffer size\n", name());
+}
+
+BaseMasterPort&
+DRAMCache::getMasterPort(const std::string& if_name, PortID idx)
+{
+    if (if_name == "cache_port") {
+        return cachePort;
+    } else if (if_name == "mem_port") {
+        return memPort;
+    } else {
+        return MemObject::getMasterPort(if_name, idx);
+    }
+}
+
+BaseSlavePort&
+DRAMCache::getSlavePort(const std::string& if_name, PortID idx)
+{
+    if (if_name == "port") {
+        return port;
+    } else {
+        return MemObject::getSlavePort(if_name, idx);
+    }
+}
+
+void
+DRAMCache::init()
+{
+    AbstractMemory::init();
+
+    if (!port.isConnected() || !cachePort.isConnected() ||
+        !memPort.isConnected())
+        fatal("DRAMCache %s is not connected on all sides.\n", name());
+
+    masterId = system()->getMasterId(name());
+    lineSize = system()->cacheLineSize();
+    entrySize = lineSize + (tagsInDRAM() ? tagSize : 0);
+
+    // the capacity is given by the cache controller
+    AddrRangeList ranges = cachePort.getAddrRanges();
+    fatal_if(ranges.size() != 1, "%s expects a single cache range\n",
+             name());
+    cacheStart = ranges.front().start();
+    uint64_t num_sets = ranges.front().size() / entrySize;
+    fatal_if(num_sets == 0, "%s cache cannot hold a single line\n", name());
+    tags.assign(num_sets, Tag{0, false, false});
+
+    DPRINTF(DRAMCache, "%d sets of %d bytes\n", num_sets, entrySize);
+
+    port.sendRangeChange();
+}
+
+bool
+DRAMCache::lookup(Addr addr, bool is_write, Addr& cache_addr,
+                  Addr& victim_addr)
+{
+    Addr line_num = addr / lineSize;
+    uint64_t set = line_num % tags.size();
+    Tag& tag = tags[set];
+
+    cache_addr = cacheStart + set * entrySize;
+    victim_addr = MaxAddr;
+
+    bool hit = tag.valid && tag.lineNum == line_num;
+    if (!hit) {
+        if (tag.valid && tag.dirty) {
+            victim_addr = tag.lineNum * lineSize;
+            dirtyEvictions++;
+        }
+        tag.lineNum = line_num;
+        tag.valid = true;
+        tag.dirty = false;
+    }
+    if (is_write) {
+        tag.dirty = true;
+    }
+
+    DPRINTF(DRAMCache, "%s %s for %#llx in set %d\n", is_write ? "Write" :
+            "Read", hit ? "hit" : "miss", addr, set);
+
+    return hit;
+}
+
+uint8_t&
+DRAMCache::predictorEntry(PacketPtr pkt)
+{
+    Addr index = pkt->req->hasPC() ? pkt->req->getPC() :
+        pkt->req->masterId();
+    return predictor[(index ^ (index >> 12)) % predictor.size()];
+}
+
+void
+DRAMCache::sendReq(MemSidePort& mem_side, Transaction* txn, ReqKind kind,
+                   MemCmd cmd, Addr addr, unsigned int size)
+{
+    RequestPtr req = new Request(addr, size, 0, masterId);
+    PacketPtr pkt = new Packet(req, cmd);
+    pkt->allocate();
+    pkt->pushSenderState(new DRAMCacheSenderState(txn, kind));
+
+    if (txn)
+        ++txn->pending;
+    ++outstanding;
+
+    if (&mem_side == &cachePort)
+        cacheBytes += size;
+    else
+        memBytes += size;
+
+    mem_side.sendQueue.push_back(pkt);
+    mem_side.trySend();
+}
+
+Tick
+DRAMCache::sendAtomicReq(MemSidePort& mem_side, MemCmd cmd, Addr addr,
+                         unsigned int size)
+{
+    Request req(addr, size, 0, masterId);
+    Packet pkt(&req, cmd);
+    pkt.allocate();
+    return mem_side.sendAtomic(&pkt);
+}
+
+void
+DRAMCache::fill(Addr cache_addr, Addr victim_addr, bool victim_read)
+{
+    bool dirty_victim = victim_addr != MaxAddr;
+
+    // with the tags in SRAM the victim is not yet read
+    if (dirty_victim && victim_read)
+        sendReq(cachePort, nullptr, Background, MemCmd::ReadReq, cache_addr,
+                lineSize);
+
+    sendReq(cachePort, nullptr, Background, MemCmd::WriteReq, cache_addr,
+            entrySize);
+
+    if (dirty_victim)
+        sendReq(memPort, nullptr, Background, MemCmd::WriteReq, victim_addr,
+                lineSize);
+}
+
+void
+DRAMCache::respond(Transaction* txn)
+{
+    assert(!txn->responded);
+    txn->responded = true;
+
+    if (txn->pkt) {
+        PacketPtr pkt = txn->pkt;
+        Tick response_time = curTick() + responseLatency() +
+            pkt->headerDelay + pkt->payloadDelay;
+        pkt->headerDelay = pkt->payloadDelay = 0;
+        port.schedTimingResp(pkt, response_time);
+        txn->pkt = nullptr;
+    }
+}
+
+void
+DRAMCache::checkDone(Transaction* txn)
+{
+    if (txn->responded && txn->pending == 0) {
+        delete txn;
+        assert(numTransactions != 0);
+        --numTransactions;
+    }
+}
+
+void
+DRAMCache::checkRetryAndDrain()
+{
+    if (retryReq && numTransactions < bufferSize &&
+        cachePort.sendQueue.size() < bufferSize &&
+        memPort.sendQueue.size() < bufferSize) {
+        retryReq = false;
+        port.sendRetryReq();
+    }
+
+    if (drainState() == DrainState::Draining && outstanding == 0) {
+        DPRINTF(Drain, "DRAMCache done draining\n");
+        signalDrainDone();
+    }
+}
+
+Tick
+DRAMCache::recvAtomic(PacketPtr pkt)
+{
+    panic_if(pkt->cacheResponding(), "Should not see packets where cache "
+             "is responding");
+
+    if (pkt->cmd == MemCmd::CleanEvict ||
+        pkt->cmd == MemCmd::WritebackClean) {
+        return 0;
+    }
+
+    const bool is_read = pkt->isRead();
+    const Addr addr = pkt->getAddr();
+    const unsigned int size = pkt->getSize();
+    const bool cacheable = !pkt->req->isUncacheable() &&
+        (is_read || (addr % lineSize == 0 && size == lineSize));
+
+    access(pkt);
+
+    Tick latency = responseLatency();
+    if (!cacheable) {
+        latency += sendAtomicReq(memPort, is_read ? MemCmd::ReadReq :
+                                 MemCmd::WriteReq, addr, size);
+    } else {
+        Addr cache_addr;
+        Addr victim_addr;
+        bool hit = lookup(addr, !is_read, cache_addr, victim_addr);
+        if (is_read) {
+            hit ? readHits++ : readMisses++;
+            if (hit || tagsInDRAM())
+                latency += sendAtomicReq(cachePort, MemCmd::ReadReq,
+                                         cache_addr, entrySize);
+            if (!hit)
+                latency += sendAtomicReq(memPort, MemCmd::ReadReq,
+                                         addr & ~Addr(lineSize - 1),
+                                         lineSize);
+        } else {
+            hit ? writeHits++ : writeMisses++;
+        }
+    }
+
+    return latency;
+}
+
+void
+DRAMCache::recvFunctional(PacketPtr pkt)
+{
+    // we hold all the data
+    functionalAccess(pkt);
+}
+
+bool
+DRAMCache::recvTimingReq(PacketPtr pkt)
+{
+    DPRINTF(DRAMCache, "recvTimingReq: request %s addr %#llx size %d\n",
+            pkt->cmdString(), pkt->getAddr(), pkt->getSize());
+
+    panic_if(pkt->cacheResponding(), "Should not see packets where cache "
+             "is responding");
+
+    // nothing to do for clean evictions
+    if (pkt->cmd == MemCmd::CleanEvict ||
+        pkt->cmd == MemCmd::WritebackClean) {
+        pendingDelete.reset(pkt);
+        return true;
+    }
+
+    // we should not get a new request after committing to retry the
+    // current one
+    if (retryReq)
+        return false;
+
+    if (numTransactions >= bufferSize ||
+        cachePort.sendQueue.size() >= bufferSize ||
+        memPort.sendQueue.size() >= bufferSize) {
+        DPRINTF(DRAMCache, "Buffers full, not accepting\n");
+        retryReq = true;
+        return false;
+    }
+
+    const bool needs_response = pkt->needsResponse();
+    const bool is_read = pkt->isRead();
+    const Addr addr = pkt->getAddr();
+    const unsigned int size = pkt->getSize();
+    const Addr line_addr = addr & ~Addr(lineSize - 1);
+    const bool cacheable = !pkt->req->isUncacheable() &&
+        (is_read || (addr == line_addr && size == lineSize));
+
+    if (!cacheable) {
+        // send the access straight to the main memory, and respond
+        // once it is done
+        bypassed++;
+        Transaction* txn = new Transaction{nullptr, false, line_addr, 0,
+                                          MaxAddr, true, true, false,
+                                          false, 0};
+        ++numTransactions;
+        sendReq(memPort, txn, Bypass, is_read ? MemCmd::ReadReq :
+                MemCmd::WriteReq, addr, size);
+        access(pkt);
+        if (needs_response)
+            txn->pkt = pkt;
+        else
+            pendingDelete.reset(pkt);
+        return true;
+    }
+
+    Addr cache_addr;
+    Addr victim_addr;
+    bool hit = lookup(addr, !is_read, cache_addr, victim_addr);
+
+    if (is_read) {
+        hit ? readHits++ : readMisses++;
+
+        // with the tags in SRAM a miss does not read the cache
+        Transaction* txn = new Transaction{nullptr, hit, line_addr,
+                                          cache_addr, victim_addr, false,
+                                          !tagsInDRAM() && !hit, false,
+                                          false, 0};
+        ++numTransactions;
+
+        if (tagsInDRAM()) {
+            if (missPredictor) {
+                // two-bit saturating counter, predicting a miss when
+                // the upper bit is set
+                uint8_t& counter = predictorEntry(pkt);
+                bool predict_miss = counter >= 2;
+                if (predict_miss == hit)
+                    mispredictions++;
+                counter = hit ? (counter ? counter - 1 : 0) :
+                    std::min(counter + 1, 3);
+
+                if (predict_miss) {
+                    predictedMisses++;
+                    txn->memIssued = true;
+                    sendReq(memPort, txn, MemRead, MemCmd::ReadReq,
+                            line_addr, lineSize);
+                }
+            }
+            sendReq(cachePort, txn, Probe, MemCmd::ReadReq, cache_addr,
+                    entrySize);
+        } else if (hit) {
+            sendReq(cachePort, txn, Probe, MemCmd::ReadReq, cache_addr,
+                    lineSize);
+        } else {
+            txn->memIssued = true;
+            sendReq(memPort, txn, MemRead, MemCmd::ReadReq, line_addr,
+                    lineSize);
+        }
+
+        access(pkt);
+        txn->pkt = pkt;
+    } else {
+        hit ? writeHits++ : writeMisses++;
+
+        // with the tags in DRAM the tag has to be read before writing
+        // to know if the victim is dirty, and the victim data comes
+        // along with it
+        if (tagsInDRAM())
+            sendReq(cachePort, nullptr, Background, MemCmd::ReadReq,
+                    cache_addr, entrySize);
+        fill(cache_addr, victim_addr, !tagsInDRAM());
+
+        access(pkt);
+        if (needs_response) {
+            Tick response_time = curTick() + responseLatency() +
+                pkt->headerDelay + pkt->payloadDelay;
+            pkt->headerDelay = pkt->payloadDelay = 0;
+            port.schedTimingResp(pkt, response_time);
+        } else {
+            pendingDelete.reset(pkt);
+        }
+    }
+
+    return true;
+}
+
+bool
+DRAMCache::recvTimingResp(PacketPtr pkt)
+{
+    DRAMCacheSenderState* state =
+        dynamic_cast<DRAMCacheSenderState*>(pkt->popSenderState());
+    panic_if(!state, "%s got a response without sender state\n", name());
+
+    Transaction* txn = state->txn;
+    ReqKind kind = state->kind;
+
+    delete state;
+    delete pkt->req;
+    delete pkt;
+
+    assert(outstanding != 0);
+    --outstanding;
+
+    if (txn) {
+        assert(txn->pending != 0);
+        --txn->pending;
+
+        switch (kind) {
+          case Probe:
+            txn->probeDone = true;
+            if (txn->hit) {
+                usefulBytes += lineSize;
+                respond(txn);
+            } else if (!txn->memIssued) {
+                // the miss was not predicted
+                txn->memIssued = true;
+                sendReq(memPort, txn, MemRead, MemCmd::ReadReq,
+                        txn->lineAddr, lineSize);
+            } else if (txn->memDone) {
+                respond(txn);
+                fill(txn->cacheAddr, txn->victimAddr, false);
+            }
+            break;
+
+          case MemRead:
+            txn->memDone = true;
+            if (txn->hit) {
+                // a predicted miss that turned out to hit
+                wastedMemBytes += lineSize;
+            } else if (txn->probeDone) {
+                respond(txn);
+                fill(txn->cacheAddr, txn->victimAddr, !tagsInDRAM());
+            }
+            break;
+
+          case Bypass:
+            respond(txn);
+            break;
+
+          default:
+            panic("%s unexpected response kind %d\n", name(), kind);
+        }
+
+        checkDone(txn);
+    }
+
+    checkRetryAndDrain();
+
+    return true;
+}
+
+DrainState
+DRAMCache::drain()
+{
+    if (outstanding != 0) {
+        DPRINTF(Drain, "DRAMCache not drained, %d outstanding\n",
+                outstanding);
+        return DrainState::Draining;
+    } else {
+        return DrainState::Drained;
+    }
+}
+
+void
+DRAMCache::regStats()
+{
+    using namespace Stats;
+
+    AbstractMemory::regStats();
+
+    readHits
+        .name(name() + ".readHits")
+        .desc("Number of read hits");
+
+    readMisses
+        .name(name() + ".readMisses")
+        .desc("Number of read misses");
+
+    writeHits
+        .name(name() + ".writeHits")
+        .desc("Number of write hits");
+
+    writeMisses
+        .name(name() + ".writeMisses")
+        .desc("Number of write misses");
+
+    dirtyEvictions
+        .name(name() + ".dirtyEvictions")
+        .desc("Number of dirty lines written back to the main memory");
+
+    bypassed
+        .name(name() + ".bypassed")
+        .desc("Number of accesses bypassing the cache");
+
+    hitRate
+        .name(name() + ".hitRate")
+        .desc("Hit rate of the cacheable accesses")
+        .precision(4);
+
+    hitRate = (readHits + writeHits) /
+        (readHits + readMisses + writeHits + writeMisses);
+
+    predictedMisses
+        .name(name() + ".predictedMisses")
+        .desc("Number of reads predicted to miss");
+
+    mispredictions
+        .name(name() + ".mispredictions")
+        .desc("Number of reads with a wrong hit or miss prediction");
+
+    usefulBytes
+        .name(name() + ".usefulBytes")
+        .desc("Bytes of data returned from the cache on hits");
+
+    cacheBytes
+        .name(name() + ".cacheBytes")
+        .desc("Total bytes read from and written to the cache");
+
+    memBytes
+        .name(name() + ".memBytes")
+        .desc("Total bytes read from and written to the main memory");
+
+    wastedMemBytes
+        .name(name() + ".wastedMemBytes")
+        .desc("Bytes read from the main memory for reads that hit");
+
+    bandwidthBloat
+        .name(name() + ".bandwidthBloat")
+        .desc("Cache bytes moved per useful byte")
+        .precision(2);
+
+    bandwidthBloat = cacheBytes / usefulBytes;
+}
+
+DRAMCache::CpuSidePort::CpuSidePort(const std::string& name,
+                                    DRAMCache& _cache)
+    : QueuedSlavePort(name, &_cache, queue), queue(_cache, *this),
+      cache(_cache)
+{ }
+
+Tick
+DRAMCache::CpuSidePort::recvAtomic(PacketPtr pkt)
+{
+    return cache.recvAtomic(pkt);
+}
+
+void
+DRAMCache::CpuSidePort::recvFunctional(PacketPtr pkt)
+{
+    pkt->pushLabel(cache.name());
+
+    if (!queue.checkFunctional(pkt)) {
+        cache.recvFunctional(pkt);
+    }
+
+    pkt->popLabel();
+}
+
+bool
+DRAMCache::CpuSidePort::recvTimingReq(PacketPtr pkt)
+{
+    return cache.recvTimingReq(pkt);
+}
+
+AddrRangeList
+DRAMCache::CpuSidePort::getAddrRanges() const
+{
+    AddrRangeList ranges;
+    ranges.push_back(cache.getAddrRange());
+    return ranges;
+}
+
+DRAMCache::MemSidePort::MemSidePort(const std::string& name,
+                                    DRAMCache& _cache)
+    : MasterPort(name, &_cache), cache(_cache), blocked(false)
+{ }
+
+void
+DRAMCache::MemSidePort::trySend()
+{
+    while (!blocked && !sendQueue.empty()) {
+        if (sendTimingReq(sendQueue.front())) {
+            sendQueue.pop_front();
+        } else {
+            blocked = true;
+        }
+    }
+}
+
+bool
+DRAMCache::MemSidePort::recvTimingResp(PacketPtr pkt)
+{
+    return cache.recvTimingResp(pkt);
+}
+
+void
+DRAMCache::MemSidePort::recvReqRetry()
+{
+    assert(blocked);
+    blocked = false;
+    trySend();
+    cache.checkRetryAndDrain();
+}
+
+DRAMCache*
+DRAMCacheParams::create()
+{
+    return new DRAMCache(this);
+}
@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * DRAMCache declaration
+ */
+
+#ifndef __MEM_DRAM_CACHE_HH__
+#define __MEM_DRAM_CACHE_HH__
+
+#include <deque>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "enums/DRAMCacheTags.hh"
+#include "mem/abstract_mem.hh"
+#include "mem/qport.hh"
+#include "params/DRAMCache.hh"
+
+/**
+ * The DRAM cache is a direct-mapped memory-side cache with the
+ * organisation of the Alloy cache, using one controller for the cache
+ * (e.g. stacked HBM) and one for the main memory. The DRAM cache
+ * holds the data of its entire range, and the requests it sends to
+ * the two controllers only serve to capture the latency and the
+ * bandwidth of every access. The tags are either kept in DRAM, and
+ * read and written together with the data, or kept in SRAM.
+ *
+ * With the tags in DRAM every access first has to read the line and
+ * its tag, and only on a miss goes to the main memory. To avoid
+ * serialising the two accesses, a miss predictor starts the main
+ * memory read in parallel for likely misses. The bytes moved to and
+ * from the cache beyond the useful data returned on hits, i.e. the
+ * tags, fills, writebacks and predicted misses, are accounted for as
+ * the bandwidth bloat.
+ */
+class DRAMCache : public AbstractMemory
+{
+
+  private:
+
+    class CpuSidePort : public QueuedSlavePort
+    {
+
+        RespPacketQueue queue;
+        DRAMCache& cache;
+
+      public:
+
+        CpuSidePort(const std::string& name, DRAMCache& _cache);
+
+      protected:
+
+        Tick recvAtomic(PacketPtr pkt);
+
+        void recvFunctional(PacketPtr pkt);
+
+        bool recvTimingReq(PacketPtr pkt);
+
+        AddrRangeList getAddrRanges() const;
+
+    };
+
+    class MemSidePort : public MasterPort
+    {
+
+        DRAMCache& cache;
+
+      public:
+
+        /** Packets waiting to be sent */
+        std::deque<PacketPtr> sendQueue;
+
+        /** Remember if we are waiting for a retry */
+        bool blocked;
+
+        MemSidePort(const std::string& name, DRAMCache& _cache);
+
+        /**
+         * Send the queued packets until the port is blocked.
+         */
+        void trySend();
+
+      protected:
+
+        bool recvTimingResp(PacketPtr pkt);
+
+        void recvReqRetry();
+
+        void recvRangeChange() { }
+
+    };
+
+    /**
+     * An outstanding read (or bypassing access) waiting for the
+     * cache or the main memory before responding.
+     */
+    struct Transaction
+    {
+        /** The response packet, already holding the data */
+        PacketPtr pkt;
+
+        /** Outcome of the tag lookup */
+        bool hit;
+
+        /** Line and location in the cache of a miss to fill */
+        Addr lineAddr;
+        Addr cacheAddr;
+
+        /** Dirty victim of a miss, or MaxAddr */
+        Addr victimAddr;
+
+        /** Is the main memory read issued */
+        bool memIssued;
+
+        /** Have the cache and main memory reads completed */
+        bool probeDone;
+        bool memDone;
+
+        /** Has the response been sent */
+        bool responded;
+
+        /** Number of outstanding requests to the controllers */
+        unsigned int pending;
+    };
+
+    /**
+     * The kind of request sent to a controller, determining what to
+     * do with the response.
+     */
+    enum ReqKind {
+        /** Tag and/or data read from the cache */
+        Probe,
+        /** Read of a line from the main memory */
+        MemRead,
+        /** Access made on behalf of the requestor, bypassing the cache */
+        Bypass,
+        /** Fills, writebacks and other requests nobody waits for */
+        Background
+    };
+
+    class DRAMCacheSenderState : public Packet::SenderState
+    {
+
+      public:
+
+        DRAMCacheSenderState(Transaction* _txn, ReqKind _kind)
+            : txn(_txn), kind(_kind)
+        { }
+
+        Transaction* const txn;
+        const ReqKind kind;
+
+    };
+
+    /** Tag of a line in the cache */
+    struct Tag
+    {
+        Addr lineNum;
+        bool valid;
+        bool dirty;
+    };
+
+    CpuSidePort port;
+    MemSidePort cachePort;
+    MemSidePort memPort;
+
+    const Enums::DRAMCacheTags tagLocation;
+    const unsigned int tagSize;
+    const Tick tagLatency;
+    const Tick staticLatency;
+    const bool missPredictor;
+    const unsigned int bufferSize;
+
+    /** Own master id for the requests to the controllers */
+    MasterID masterId;
+
+    /** Line size, and the size of a line as stored in the cache */
+    unsigned int lineSize;
+    unsigned int entrySize;
+
+    /** Start of the range of the cache controller */
+    Addr cacheStart;
+
+    /** The tags of the direct-mapped cache, one per set */
+    std::vector<Tag> tags;
+
+    /** Saturating counters of the miss predictor */
+    std::vector<uint8_t> predictor;
+
+    /** Number of outstanding transactions */
+    unsigned int numTransactions;
+
+    /** Number of outstanding requests to the controllers */
+    unsigned int outstanding;
+
+    /** Remember if we have to retry a request when available */
+    bool retryReq;
+
+    /**
+     * Upstream caches need this packet until true is returned, so
+     * hold it for deletion until a subsequent call
+     */
+    std::unique_ptr<Packet> pendingDelete;
+
+    bool tagsInDRAM() const
+    { return tagLocation == Enums::dram; }
+
+    /**
+     * Look up and update the tags for an access.
+     *
+     * @param addr Address of the access
+     * @param is_write Does the access write the line
+     * @param cache_addr Location of the line in the cache
+     * @param victim_addr Address of a dirty victim, or MaxAddr
+     * @return true on a hit
+     */
+    bool lookup(Addr addr, bool is_write, Addr& cache_addr,
+                Addr& victim_addr);
+
+    /**
+     * Get the latency of the controller itself for a response.
+     */
+    Tick responseLatency() const
+    { return staticLatency + (tagsInDRAM() ? 0 : tagLatency); }
+
+    /**
+     * Get the miss predictor entry for a packet.
+     */
+    uint8_t& predictorEntry(PacketPtr pkt);
+
+    /**
+     * Create and queue a request to one of the controllers.
+     */
+    void sendReq(MemSidePort& mem_side, Transaction* txn, ReqKind kind,
+                 MemCmd cmd, Addr addr, unsigned int size);
+
+    /**
+     * Send an atomic request to one of the controllers.
+     *
+     * @return The latency of the request
+     */
+    Tick sendAtomicReq(MemSidePort& mem_side, MemCmd cmd, Addr addr,
+                       unsigned int size);
+
+    /**
+     * Queue the fill of a line that missed, and the writeback of its
+     * dirty victim.
+     */
+    void fill(Addr cache_addr, Addr victim_addr, bool victim_read);
+
+    /**
+     * Respond to the requestor once the data is available.
+     */
+    void respond(Transaction* txn);
+
+    /**
+     * Delete a transaction once it is done.
+     */
+    void checkDone(Transaction* txn);
+
+    /**
+     * Let the requestor retry if there is space again, or signal the
+     * end of draining.
+     */
+    void checkRetryAndDrain();
+
+    Tick recvAtomic(PacketPtr pkt);
+
+    void recvFunctional(PacketPtr pkt);
+
+    bool recvTimingReq(PacketPtr pkt);
+
+    bool recvTimingResp(PacketPtr pkt);
+
+    // Statistics
+    Stats::Scalar readHits;
+    Stats::Scalar readMisses;
+    Stats::Scalar writeHits;
+    Stats::Scalar writeMisses;
+    Stats::Scalar dirtyEvictions;
+    Stats::Scalar bypassed;
+    Stats::Formula hitRate;
+    Stats::Scalar predictedMisses;
+    Stats::Scalar mispredictions;
+    Stats::Scalar usefulBytes;
+    Stats::Scalar cacheBytes;
+    Stats::Scalar memBytes;
+    Stats::Scalar wastedMemBytes;
+    Stats::Formula bandwidthBloat;
+
+  public:
+
+    DRAMCache(const DRAMCacheParams* p);
+
+    BaseMasterPort& getMasterPort(const std::string& if_name,
+                                  PortID idx = InvalidPortID) override;
+
+    BaseSlavePort& getSlavePort(const std::string& if_name,
+                                PortID idx = InvalidPortID) override;
+
+    void init() override;
+    void regStats() override;
+
+    DrainState drain() override;
+
+};
+
+#endif //__MEM_DRAM_CACHE_HH__
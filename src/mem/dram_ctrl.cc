@@ -47,6 +47,9 @@
 
 #include "mem/dram_ctrl.hh"
 
+#include <algorithm>
+#include <limits>
+
 #include "base/bitfield.hh"
 #include "base/trace.hh"
 #include "debug/DRAM.hh"
@@ -66,6 +69,8 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
     busStateNext(READ),
     nextReqEvent([this]{ processNextReqEvent(); }, name()),
     respondEvent([this]{ processRespondEvent(); }, name()),
+    approximate(p->approximate), approxBusFreeAt(0),
+    approxRetryEvent([this]{ processApproxRetryEvent(); }, name()),
     deviceSize(p->device_size),
     deviceBusWidth(p->device_bus_width), burstLength(p->burst_length),
     deviceRowBufferSize(p->device_rowbuffer_size),
@@ -78,6 +83,7 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
     bankGroupsPerRank(p->bank_groups_per_rank),
     bankGroupArch(p->bank_groups_per_rank > 0),
     banksPerRank(p->banks_per_rank), channels(p->channels), rowsPerBank(0),
+    rankXorMasks(p->rank_xor_masks), bankXorMasks(p->bank_xor_masks),
     readBufferSize(p->read_buffer_size),
     writeBufferSize(p->write_buffer_size),
     writeHighThreshold(writeBufferSize * p->write_high_thresh_perc / 100.0),
@@ -90,8 +96,9 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
     tRRD_L(p->tRRD_L), tXAW(p->tXAW), tXP(p->tXP), tXS(p->tXS),
     activationLimit(p->activation_limit),
     memSchedPolicy(p->mem_sched_policy), addrMapping(p->addr_mapping),
-    pageMgmt(p->page_policy),
+    pageMgmt(p->page_policy), masterSched(p),
     maxAccessesPerRow(p->max_accesses_per_row),
+    bulkRefresh(p->bulk_refresh),
     frontendLatency(p->static_frontend_latency),
     backendLatency(p->static_backend_latency),
     busBusyUntil(0), prevArrival(0),
@@ -111,6 +118,10 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
         ranks.push_back(rank);
     }
 
+    readQueue.init(ranksPerChannel * banksPerRank);
+    writeQueue.init(ranksPerChannel * banksPerRank);
+    approxBanks.resize(ranksPerChannel * banksPerRank);
+
     // perform a basic check of the write thresholds
     if (p->write_low_thresh_perc >= p->write_high_thresh_perc)
         fatal("Write buffer low threshold %d must be smaller than the "
@@ -138,6 +149,38 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
 
     rowsPerBank = capacity / (rowBufferSize * banksPerRank * ranksPerChannel);
 
+    // the XOR permutation needs one mask per rank or bank index bit,
+    // and the masks must not include any of the bits that select the
+    // rank or bank in the first place, as the mapping would otherwise
+    // not be one-to-one
+    if (!rankXorMasks.empty() || !bankXorMasks.empty()) {
+        fatal_if(!rankXorMasks.empty() && (!isPowerOf2(ranksPerChannel) ||
+                 rankXorMasks.size() != ceilLog2(ranksPerChannel)),
+                 "%s needs a power of two ranks per channel, and one rank "
+                 "XOR mask per rank bit, got %d\n", name(),
+                 rankXorMasks.size());
+        fatal_if(!bankXorMasks.empty() && (!isPowerOf2(banksPerRank) ||
+                 bankXorMasks.size() != ceilLog2(banksPerRank)),
+                 "%s needs a power of two banks per rank, and one bank XOR "
+                 "mask per bank bit, got %d\n", name(), bankXorMasks.size());
+
+        Addr index_bits = 0;
+        for (int b = 0; b < 64; b++) {
+            uint8_t rank, bank;
+            uint64_t row;
+            mapAddr(Addr(1) << b, rank, bank, row);
+            if (rank || bank)
+                index_bits |= Addr(1) << b;
+        }
+
+        for (const auto& mask : rankXorMasks)
+            fatal_if(mask & index_bits, "%s rank XOR mask %#x overlaps the "
+                     "rank and bank bits %#x\n", name(), mask, index_bits);
+        for (const auto& mask : bankXorMasks)
+            fatal_if(mask & index_bits, "%s bank XOR mask %#x overlaps the "
+                     "rank and bank bits %#x\n", name(), mask, index_bits);
+    }
+
     // some basic sanity checks
     if (tREFI <= tRP || tREFI <= tRFC) {
         fatal("tREFI (%d) must be larger than tRP (%d) and tRFC (%d)\n",
@@ -230,9 +273,14 @@ DRAMCtrl::init()
 void
 DRAMCtrl::startup()
 {
+    AbstractMemory::startup();
+
     // remember the memory system mode of operation
     isTimingMode = system()->isTimingMode();
 
+    // all masters are known by now
+    masterSched.startup(system());
+
     if (isTimingMode) {
         // timestamp offset should be in clock cycles for DRAMPower
         timeStampOffset = divCeil(curTick(), tCK);
@@ -259,6 +307,9 @@ DRAMCtrl::recvAtomic(PacketPtr pkt)
     panic_if(pkt->cacheResponding(), "Should not see packets where cache "
              "is responding");
 
+    if (pkt->isRead() || pkt->isWrite())
+        traceBursts(pkt);
+
     // do the actual memory access and turn the packet into a response
     access(pkt);
 
@@ -290,18 +341,13 @@ DRAMCtrl::writeQueueFull(unsigned int neededEntries) const
     return (writeQueue.size() + neededEntries) > writeBufferSize;
 }
 
-DRAMCtrl::DRAMPacket*
-DRAMCtrl::decodeAddr(PacketPtr pkt, Addr dramPktAddr, unsigned size,
-                       bool isRead)
+void
+DRAMCtrl::mapAddr(Addr dramPktAddr, uint8_t& rank, uint8_t& bank,
+                  uint64_t& row) const
 {
     // decode the address based on the address mapping scheme, with
     // Ro, Ra, Co, Ba and Ch denoting row, rank, column, bank and
     // channel, respectively
-    uint8_t rank;
-    uint8_t bank;
-    // use a 64-bit unsigned during the computations as the row is
-    // always the top bits, and check before creating the DRAMPacket
-    uint64_t row;
 
     // truncate the address to a DRAM burst, which makes it unique to
     // a specific column, row, bank, rank and channel
@@ -379,11 +425,58 @@ DRAMCtrl::decodeAddr(PacketPtr pkt, Addr dramPktAddr, unsigned size,
         row = addr % rowsPerBank;
     } else
         panic("Unknown address mapping policy chosen!");
+}
+
+void
+DRAMCtrl::locateAddr(Addr dramPktAddr, uint8_t& rank, uint8_t& bank,
+                     uint64_t& row) const
+{
+    mapAddr(dramPktAddr, rank, bank, row);
+
+    // optionally permute the rank and bank by XOR-ing every index bit
+    // with the parity of a set of address bits, to spread strided
+    // accesses across the banks
+    for (int i = 0; i < rankXorMasks.size(); i++)
+        rank ^= (popCount(dramPktAddr & rankXorMasks[i]) & 1) << i;
+    for (int i = 0; i < bankXorMasks.size(); i++)
+        bank ^= (popCount(dramPktAddr & bankXorMasks[i]) & 1) << i;
 
     assert(rank < ranksPerChannel);
     assert(bank < banksPerRank);
     assert(row < rowsPerBank);
     assert(row < Bank::NO_ROW);
+}
+
+void
+DRAMCtrl::traceBursts(PacketPtr pkt)
+{
+    if (traceStream == NULL)
+        return;
+
+    Addr addr = pkt->getAddr();
+    while (addr < pkt->getAddr() + pkt->getSize()) {
+        unsigned size = std::min((addr | (burstSize - 1)) + 1,
+                                 pkt->getAddr() + pkt->getSize()) - addr;
+        uint8_t rank;
+        uint8_t bank;
+        uint64_t row;
+        locateAddr(addr, rank, bank, row);
+        traceAccess(curTick(), pkt->cmd, addr, size, pkt->req->masterId(),
+                    rank, bank, row);
+        addr = burstAlign(addr) + burstSize;
+    }
+}
+
+DRAMCtrl::DRAMPacket*
+DRAMCtrl::decodeAddr(PacketPtr pkt, Addr dramPktAddr, unsigned size,
+                       bool isRead)
+{
+    uint8_t rank;
+    uint8_t bank;
+    // use a 64-bit unsigned during the computations as the row is
+    // always the top bits, and check before creating the DRAMPacket
+    uint64_t row;
+    locateAddr(dramPktAddr, rank, bank, row);
 
     DPRINTF(DRAM, "Address: %lld Rank %d Bank %d Row %d\n",
             dramPktAddr, rank, bank, row);
@@ -603,6 +696,11 @@ DRAMCtrl::recvTimingReq(PacketPtr pkt)
     unsigned offset = pkt->getAddr() & (burstSize - 1);
     unsigned int dram_pkt_count = divCeil(offset + size, burstSize);
 
+    // bypass the queues altogether when using the approximate model
+    if (approximate) {
+        return approxAccess(pkt, dram_pkt_count);
+    }
+
     // check local buffers and do not accept if full
     if (pkt->isRead()) {
         assert(size != 0);
@@ -613,6 +711,7 @@ DRAMCtrl::recvTimingReq(PacketPtr pkt)
             numRdRetry++;
             return false;
         } else {
+            traceBursts(pkt);
             addToReadQueue(pkt, dram_pkt_count);
             readReqs++;
             bytesReadSys += size;
@@ -627,6 +726,7 @@ DRAMCtrl::recvTimingReq(PacketPtr pkt)
             numWrRetry++;
             return false;
         } else {
+            traceBursts(pkt);
             addToWriteQueue(pkt, dram_pkt_count);
             writeReqs++;
             bytesWrittenSys += size;
@@ -636,6 +736,214 @@ DRAMCtrl::recvTimingReq(PacketPtr pkt)
     return true;
 }
 
+bool
+DRAMCtrl::approxAccess(PacketPtr pkt, unsigned int pktCount)
+{
+    approxRetire();
+
+    const bool is_read = pkt->isRead();
+    auto& in_flight = is_read ? approxReadsInFlight : approxWritesInFlight;
+    const unsigned int buffer_size = is_read ? readBufferSize :
+        writeBufferSize;
+
+    // bound the number of bursts in flight by the buffer size, and
+    // let the requestor retry once the oldest ones are done
+    if (!in_flight.empty() && in_flight.size() + pktCount > buffer_size) {
+        DPRINTF(DRAM, "Approximate model has %d %s bursts in flight, not "
+                "accepting\n", in_flight.size(), is_read ? "read" : "write");
+        if (is_read) {
+            retryRdReq = true;
+            numRdRetry++;
+        } else {
+            retryWrReq = true;
+            numWrRetry++;
+        }
+        if (!approxRetryEvent.scheduled()) {
+            schedule(approxRetryEvent, in_flight.top());
+        }
+        return false;
+    }
+
+    const bool close_page = pageMgmt == Enums::close ||
+        pageMgmt == Enums::close_adaptive;
+
+    Addr addr = pkt->getAddr();
+    Tick done_at = curTick();
+    for (int cnt = 0; cnt < pktCount; ++cnt) {
+        unsigned size = std::min((addr | (burstSize - 1)) + 1,
+                        pkt->getAddr() + pkt->getSize()) - addr;
+
+        uint8_t rank;
+        uint8_t bank;
+        uint64_t row;
+        locateAddr(addr, rank, bank, row);
+        traceAccess(curTick(), pkt->cmd, addr, size, pkt->req->masterId(),
+                    rank, bank, row);
+
+        ApproxBank& bank_ref = approxBanks[rank * banksPerRank + bank];
+
+        // the column access is delayed by any preceding access to the
+        // bank, and by the precharge and activate needed on a miss
+        Tick col_at = std::max(bank_ref.freeAt, curTick());
+        const bool row_hit = bank_ref.openRow == row;
+        if (!row_hit) {
+            if (bank_ref.openRow != Bank::NO_ROW) {
+                col_at += tRP;
+                bankConflicts[rank][bank]++;
+            }
+            col_at += tRCD;
+        }
+
+        // account for refresh by pushing any access falling within
+        // the refresh window of the rank beyond it, assuming all
+        // ranks refresh in phase every tREFI
+        const Tick ref_phase = col_at % tREFI;
+        if (ref_phase < tRFC) {
+            col_at += tRFC - ref_phase;
+        }
+
+        // the data transfer is serialised on the shared data bus
+        const Tick data_at = std::max(col_at + tCL, approxBusFreeAt) +
+            tBURST;
+        approxBusFreeAt = data_at;
+
+        if (close_page) {
+            bank_ref.openRow = Bank::NO_ROW;
+            bank_ref.freeAt = col_at + tBURST + tRP;
+        } else {
+            bank_ref.openRow = row;
+            bank_ref.freeAt = col_at + tBURST;
+        }
+
+        in_flight.push(data_at);
+        done_at = std::max(done_at, data_at);
+
+        if (is_read) {
+            readBursts++;
+            readPktSize[ceilLog2(size)]++;
+            perBankRdBursts[rank * banksPerRank + bank]++;
+            if (row_hit)
+                readRowHits++;
+            bytesReadDRAM += burstSize;
+            approxTotRdLat += data_at - curTick();
+
+            // contribute to the averaged latencies like a detailed
+            // burst, with the column access as the command time
+            totQLat += col_at - curTick();
+            totBusLat += tBURST;
+            totMemAccLat += data_at - curTick();
+        } else {
+            writeBursts++;
+            writePktSize[ceilLog2(size)]++;
+            perBankWrBursts[rank * banksPerRank + bank]++;
+            if (row_hit)
+                writeRowHits++;
+            bytesWritten += burstSize;
+        }
+
+        addr = (addr | (burstSize - 1)) + 1;
+    }
+
+    DPRINTF(DRAM, "Approximate model %s addr %lld done at %lld\n",
+            pkt->cmdString(), pkt->getAddr(), done_at);
+
+    if (is_read) {
+        readReqs++;
+        bytesReadSys += pkt->getSize();
+        approxRdBursts += pktCount;
+        accessAndRespond(pkt, done_at - curTick() + frontendLatency +
+                         backendLatency);
+    } else {
+        writeReqs++;
+        bytesWrittenSys += pkt->getSize();
+        approxWrBursts += pktCount;
+        // writes are acknowledged as soon as they are accepted
+        accessAndRespond(pkt, frontendLatency);
+    }
+
+    return true;
+}
+
+void
+DRAMCtrl::approxRetire()
+{
+    while (!approxReadsInFlight.empty() &&
+           approxReadsInFlight.top() <= curTick()) {
+        approxReadsInFlight.pop();
+    }
+    while (!approxWritesInFlight.empty() &&
+           approxWritesInFlight.top() <= curTick()) {
+        approxWritesInFlight.pop();
+    }
+}
+
+void
+DRAMCtrl::processApproxRetryEvent()
+{
+    approxRetire();
+
+    if (retryRdReq && approxReadsInFlight.size() < readBufferSize) {
+        retryRdReq = false;
+        port.sendRetryReq();
+    } else if (retryWrReq && approxWritesInFlight.size() < writeBufferSize) {
+        retryWrReq = false;
+        port.sendRetryReq();
+    }
+
+    // keep waiting if the retry did not go through
+    if ((retryRdReq || retryWrReq) && !approxRetryEvent.scheduled()) {
+        Tick when = MaxTick;
+        if (!approxReadsInFlight.empty())
+            when = std::min(when, approxReadsInFlight.top());
+        if (!approxWritesInFlight.empty())
+            when = std::min(when, approxWritesInFlight.top());
+        if (when != MaxTick)
+            schedule(approxRetryEvent, when);
+    }
+}
+
+void
+DRAMCtrl::setApproximate(bool approx)
+{
+    fatal_if(drainState() != DrainState::Drained,
+             "%s: the system must be drained to switch DRAM model\n",
+             name());
+
+    DPRINTF(DRAM, "Switching to the %s model\n",
+            approx ? "approximate" : "detailed");
+
+    // all queues are empty once drained, and every rank is idle with
+    // all its banks precharged (see allRanksDrained), thus the
+    // detailed model has no open rows to carry over
+    for (auto r : ranks) {
+        assert(r->inPwrIdleState());
+        for (int b = 0; b < banksPerRank; b++) {
+            Bank& bank = r->banks[b];
+            assert(bank.openRow == Bank::NO_ROW);
+
+            // when going back to the detailed model, the rows left
+            // open by the approximate model are closed, and a bank
+            // is not activated before it is free and precharged
+            if (approximate && !approx) {
+                const ApproxBank& approx_bank =
+                    approxBanks[r->rank * banksPerRank + b];
+                Tick free_at = approx_bank.freeAt;
+                if (approx_bank.openRow != Bank::NO_ROW)
+                    free_at += tRP;
+                bank.actAllowedAt = std::max(bank.actAllowedAt, free_at);
+            }
+        }
+    }
+    if (approximate && !approx)
+        busBusyUntil = std::max(busBusyUntil, approxBusFreeAt);
+
+    approximate = approx;
+    approxBanks.assign(ranksPerChannel * banksPerRank, ApproxBank());
+    approxBusFreeAt = curTick();
+    approxReadsInFlight = decltype(approxReadsInFlight)();
+    approxWritesInFlight = decltype(approxWritesInFlight)();
+}
+
 void
 DRAMCtrl::processRespondEvent()
 {
@@ -730,8 +1038,50 @@ DRAMCtrl::processRespondEvent()
     }
 }
 
+void
+DRAMCtrl::DRAMPacketQueue::push_back(DRAMPacket* dram_pkt)
+{
+    packets.push_back(dram_pkt);
+
+    BankQueue& bank_queue = banks[dram_pkt->bankId];
+    bank_queue.rows[dram_pkt->row].emplace_back(nextSeqNum++, dram_pkt);
+    ++bank_queue.size;
+}
+
+void
+DRAMCtrl::DRAMPacketQueue::pop_front()
+{
+    DRAMPacket* dram_pkt = packets.front();
+    packets.pop_front();
+
+    // the scheduler always picks the oldest packet of a row, so the
+    // search normally ends at the first entry
+    BankQueue& bank_queue = banks[dram_pkt->bankId];
+    auto row_it = bank_queue.rows.find(dram_pkt->row);
+    assert(row_it != bank_queue.rows.end());
+    RowQueue& row_queue = row_it->second;
+    auto i = row_queue.begin();
+    while (i->second != dram_pkt) {
+        ++i;
+        assert(i != row_queue.end());
+    }
+    row_queue.erase(i);
+    if (row_queue.empty())
+        bank_queue.rows.erase(row_it);
+    --bank_queue.size;
+}
+
+void
+DRAMCtrl::DRAMPacketQueue::moveToFront(DRAMPacket* dram_pkt)
+{
+    auto i = std::find(packets.begin(), packets.end(), dram_pkt);
+    assert(i != packets.end());
+    packets.erase(i);
+    packets.push_front(dram_pkt);
+}
+
 bool
-DRAMCtrl::chooseNext(std::deque<DRAMPacket*>& queue, Tick extra_col_delay)
+DRAMCtrl::chooseNext(DRAMPacketQueue& queue, Tick extra_col_delay)
 {
     // This method does the arbitration between requests. The chosen
     // packet is simply moved to the head of the queue. The other
@@ -753,13 +1103,14 @@ DRAMCtrl::chooseNext(std::deque<DRAMPacket*>& queue, Tick extra_col_delay)
         return found_packet;
     }
 
-    if (memSchedPolicy == Enums::fcfs) {
+    if (masterSched.enabled()) {
+        found_packet = prioritizeQueue(queue);
+    } else if (memSchedPolicy == Enums::fcfs) {
         // check if there is a packet going to a free rank
         for (auto i = queue.begin(); i != queue.end() ; ++i) {
             DRAMPacket* dram_pkt = *i;
             if (ranks[dram_pkt->rank]->inRefIdleState()) {
-                queue.erase(i);
-                queue.push_front(dram_pkt);
+                queue.moveToFront(dram_pkt);
                 found_packet = true;
                 break;
             }
@@ -772,96 +1123,152 @@ DRAMCtrl::chooseNext(std::deque<DRAMPacket*>& queue, Tick extra_col_delay)
 }
 
 bool
-DRAMCtrl::reorderQueue(std::deque<DRAMPacket*>& queue, Tick extra_col_delay)
+DRAMCtrl::reorderQueue(DRAMPacketQueue& queue, Tick extra_col_delay)
 {
-    // Only determine this if needed
-    uint64_t earliest_banks = 0;
-    bool hidden_bank_prep = false;
-
-    // search for seamless row hits first, if no seamless row hit is
-    // found then determine if there are other packets that can be issued
-    // without incurring additional bus delay due to bank timing
-    // Will select closed rows first to enable more open row possibilies
-    // in future selections
-    bool found_hidden_bank = false;
-
-    // remember if we found a row hit, not seamless, but bank prepped
-    // and ready
-    bool found_prepped_pkt = false;
-
-    // if we have no row hit, prepped or not, and no seamless packet,
-    // just go for the earliest possible
-    bool found_earliest_pkt = false;
-
-    auto selected_pkt_it = queue.end();
+    // The policy, expressed in terms of a scan of the queue in
+    // arrival order, is to go for the first seamless row hit. If
+    // there is none, pick the first row miss to one of the banks
+    // that can be prepared the earliest if the bank commands can be
+    // hidden, and otherwise the first row hit (prepped but not
+    // seamless), or failing that the first row miss to one of the
+    // earliest banks. Closed rows are thus selected first to enable
+    // more open row possibilities in future selections. Rather than
+    // scanning the queue, use the per-bank index to find the
+    // candidates of each bank, and compare their arrival order.
+    const uint64_t no_pkt = std::numeric_limits<uint64_t>::max();
+    uint64_t seamless_seq = no_pkt;
+    DRAMPacket* seamless_pkt = nullptr;
+    uint64_t prepped_seq = no_pkt;
+    DRAMPacket* prepped_pkt = nullptr;
+    bool got_miss = false;
 
     // time we need to issue a column command to be seamless
     const Tick min_col_at = std::max(busBusyUntil - tCL + extra_col_delay,
                                      curTick());
 
-    for (auto i = queue.begin(); i != queue.end() ; ++i) {
-        DRAMPacket* dram_pkt = *i;
-        const Bank& bank = dram_pkt->bankRef;
-
-        // check if rank is not doing a refresh and thus is available, if not,
-        // jump to the next packet
-        if (dram_pkt->rankRef.inRefIdleState()) {
-            // check if it is a row hit
-            if (bank.openRow == dram_pkt->row) {
-                // no additional rank-to-rank or same bank-group
-                // delays, or we switched read/write and might as well
-                // go for the row hit
-                if (bank.colAllowedAt <= min_col_at) {
-                    // FCFS within the hits, giving priority to
-                    // commands that can issue seamlessly, without
-                    // additional delay, such as same rank accesses
-                    // and/or different bank-group accesses
-                    DPRINTF(DRAM, "Seamless row buffer hit\n");
-                    selected_pkt_it = i;
-                    // no need to look through the remaining queue entries
-                    break;
-                } else if (!found_hidden_bank && !found_prepped_pkt) {
-                    // if we did not find a packet to a closed row that can
-                    // issue the bank commands without incurring delay, and
-                    // did not yet find a packet to a prepped row, remember
-                    // the current one
-                    selected_pkt_it = i;
-                    found_prepped_pkt = true;
-                    DPRINTF(DRAM, "Prepped row buffer hit\n");
-                }
-            } else if (!found_earliest_pkt) {
-                // if we have not initialised the bank status, do it
-                // now, and only once per scheduling decisions
-                if (earliest_banks == 0) {
-                    // determine entries with earliest bank delay
-                    pair<uint64_t, bool> bankStatus =
-                        minBankPrep(queue, min_col_at);
-                    earliest_banks = bankStatus.first;
-                    hidden_bank_prep = bankStatus.second;
+    const uint16_t num_banks = ranksPerChannel * banksPerRank;
+    for (uint16_t bank_id = 0; bank_id < num_banks; ++bank_id) {
+        const DRAMPacketQueue::BankQueue& bank_queue = queue.bank(bank_id);
+
+        // check if rank is not doing a refresh and thus is available,
+        // if not, skip its banks
+        const Rank& rank = *ranks[bank_id / banksPerRank];
+        if (!bank_queue.size || !rank.inRefIdleState())
+            continue;
+
+        const Bank& bank = rank.banks[bank_id % banksPerRank];
+        auto hits = bank_queue.rows.find(bank.openRow);
+        unsigned num_hits = 0;
+        if (hits != bank_queue.rows.end()) {
+            num_hits = hits->second.size();
+            const auto& oldest_hit = hits->second.front();
+
+            // no additional rank-to-rank or same bank-group delays, or
+            // we switched read/write and might as well go for the row
+            // hit
+            if (bank.colAllowedAt <= min_col_at) {
+                if (oldest_hit.first < seamless_seq) {
+                    seamless_seq = oldest_hit.first;
+                    seamless_pkt = oldest_hit.second;
                 }
+            } else if (oldest_hit.first < prepped_seq) {
+                prepped_seq = oldest_hit.first;
+                prepped_pkt = oldest_hit.second;
+            }
+        }
+        got_miss |= bank_queue.size > num_hits;
+    }
+
+    DRAMPacket* selected_pkt = nullptr;
 
-                // bank is amongst first available banks
-                // minBankPrep will give priority to packets that can
-                // issue seamlessly
-                if (bits(earliest_banks, dram_pkt->bankId, dram_pkt->bankId)) {
-                    found_earliest_pkt = true;
-                    found_hidden_bank = hidden_bank_prep;
-
-                    // give priority to packets that can issue
-                    // bank commands 'behind the scenes'
-                    // any additional delay if any will be due to
-                    // col-to-col command requirements
-                    if (hidden_bank_prep || !found_prepped_pkt)
-                        selected_pkt_it = i;
+    if (seamless_pkt) {
+        // FCFS within the hits, giving priority to commands that can
+        // issue seamlessly, without additional delay, such as same
+        // rank accesses and/or different bank-group accesses
+        DPRINTF(DRAM, "Seamless row buffer hit\n");
+        selected_pkt = seamless_pkt;
+    } else {
+        // determine the oldest miss to one of the banks with the
+        // earliest bank delay, if there are any misses at all
+        uint64_t earliest_seq = no_pkt;
+        DRAMPacket* earliest_pkt = nullptr;
+        bool hidden_bank_prep = false;
+        if (got_miss) {
+            pair<uint64_t, bool> bankStatus = minBankPrep(queue, min_col_at);
+            uint64_t earliest_banks = bankStatus.first;
+            hidden_bank_prep = bankStatus.second;
+
+            for (uint16_t bank_id = 0; bank_id < num_banks; ++bank_id) {
+                if (!bits(earliest_banks, bank_id, bank_id))
+                    continue;
+
+                const Bank& bank =
+                    ranks[bank_id / banksPerRank]->banks[bank_id %
+                                                         banksPerRank];
+                for (const auto& r : queue.bank(bank_id).rows) {
+                    if (r.first != bank.openRow &&
+                        r.second.front().first < earliest_seq) {
+                        earliest_seq = r.second.front().first;
+                        earliest_pkt = r.second.front().second;
+                    }
                 }
             }
         }
+
+        // give priority to packets that can issue bank commands
+        // 'behind the scenes', any additional delay if any will be
+        // due to col-to-col command requirements
+        if (earliest_pkt && (hidden_bank_prep || !prepped_pkt)) {
+            selected_pkt = earliest_pkt;
+        } else if (prepped_pkt) {
+            DPRINTF(DRAM, "Prepped row buffer hit\n");
+            selected_pkt = prepped_pkt;
+        }
     }
 
-    if (selected_pkt_it != queue.end()) {
-        DRAMPacket* selected_pkt = *selected_pkt_it;
-        queue.erase(selected_pkt_it);
-        queue.push_front(selected_pkt);
+    if (selected_pkt) {
+        queue.moveToFront(selected_pkt);
+        return true;
+    }
+
+    return false;
+}
+
+bool
+DRAMCtrl::prioritizeQueue(DRAMPacketQueue& queue)
+{
+    masterSched.update(curTick());
+
+    // scan in arrival order, and only replace the selected packet on
+    // a strictly better match, which makes the choice FCFS among
+    // equals
+    const bool row_hit_first = memSchedPolicy != Enums::fcfs;
+    DRAMPacket* selected_pkt = nullptr;
+    uint64_t selected_prio = 0;
+    bool selected_hit = false;
+
+    for (const auto& dram_pkt : queue) {
+        // skip packets to ranks that are refreshing
+        if (!dram_pkt->rankRef.inRefIdleState())
+            continue;
+
+        uint64_t prio = masterSched.priority(dram_pkt->masterId,
+                                             dram_pkt->entryTime, curTick());
+        bool row_hit = row_hit_first &&
+            dram_pkt->bankRef.openRow == dram_pkt->row;
+
+        if (!selected_pkt || prio > selected_prio ||
+            (prio == selected_prio && row_hit && !selected_hit)) {
+            selected_pkt = dram_pkt;
+            selected_prio = prio;
+            selected_hit = row_hit;
+        }
+    }
+
+    if (selected_pkt) {
+        DPRINTF(DRAM, "Selected packet of master %d with priority %#x\n",
+                selected_pkt->masterId, selected_prio);
+        queue.moveToFront(selected_pkt);
         return true;
     }
 
@@ -1087,6 +1494,7 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
 
         // If there is a page open, precharge it.
         if (bank.openRow != Bank::NO_ROW) {
+            bankConflicts[dram_pkt->rank][dram_pkt->bank]++;
             prechargeBank(rank, bank, std::max(bank.preAllowedAt, curTick()));
         }
 
@@ -1181,7 +1589,7 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
         bool got_bank_conflict = false;
 
         // either look at the read queue or write queue
-        const deque<DRAMPacket*>& queue = dram_pkt->isRead ? readQueue :
+        const DRAMPacketQueue& queue = dram_pkt->isRead ? readQueue :
             writeQueue;
         auto p = queue.begin();
         // make sure we are not considering the packet that we are
@@ -1245,7 +1653,12 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
     // we will wake up sooner than we have to.
     nextReqTime = busBusyUntil - (tRP + tRCD + tCL);
 
+    // let the scheduler account for the service of the master
+    if (masterSched.enabled())
+        masterSched.serviced(dram_pkt->masterId, tBURST);
+
     // Update the stats and schedule the next request
+    const bool known_master = dram_pkt->masterId < system()->maxMasters();
     if (dram_pkt->isRead) {
         ++readsThisTime;
         if (row_hit)
@@ -1257,12 +1670,21 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
         totMemAccLat += dram_pkt->readyTime - dram_pkt->entryTime;
         totBusLat += tBURST;
         totQLat += cmd_at - dram_pkt->entryTime;
+
+        if (known_master) {
+            masterReadBursts[dram_pkt->masterId]++;
+            masterTotReadLat[dram_pkt->masterId] +=
+                dram_pkt->readyTime - dram_pkt->entryTime;
+        }
     } else {
         ++writesThisTime;
         if (row_hit)
             writeRowHits++;
         bytesWritten += burstSize;
         perBankWrBursts[dram_pkt->bankId]++;
+
+        if (known_master)
+            masterWriteBursts[dram_pkt->masterId]++;
     }
 }
 
@@ -1525,7 +1947,7 @@ DRAMCtrl::processNextReqEvent()
 }
 
 pair<uint64_t, bool>
-DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
+DRAMCtrl::minBankPrep(const DRAMPacketQueue& queue,
                       Tick min_col_at) const
 {
     uint64_t bank_mask = 0;
@@ -1545,9 +1967,13 @@ DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
     // determine if we have queued transactions targetting the
     // bank in question
     vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (const auto& p : queue) {
-        if (p->rankRef.inRefIdleState())
-            got_waiting[p->bankId] = true;
+    for (int i = 0; i < ranksPerChannel; i++) {
+        if (ranks[i]->inRefIdleState()) {
+            for (int j = 0; j < banksPerRank; j++) {
+                uint16_t bank_id = i * banksPerRank + j;
+                got_waiting[bank_id] = queue.bank(bank_id).size != 0;
+            }
+        }
     }
 
     // Find command with optimal bank timing
@@ -1610,7 +2036,7 @@ DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
 DRAMCtrl::Rank::Rank(DRAMCtrl& _memory, const DRAMCtrlParams* _p, int rank)
     : EventManager(&_memory), memory(_memory),
       pwrStateTrans(PWR_IDLE), pwrStatePostRefresh(PWR_IDLE),
-      pwrStateTick(0), refreshDueAt(0), pwrState(PWR_IDLE),
+      pwrStateTick(0), refreshDueAt(0), bulkRefreshAt(0), pwrState(PWR_IDLE),
       refreshState(REF_IDLE), inLowPowerState(false), rank(rank),
       readEntries(0), writeEntries(0), outstandingEvents(0),
       wakeUpAllowedAt(0), power(_p, false), banks(_p->banks_per_rank),
@@ -1701,7 +2127,7 @@ DRAMCtrl::Rank::checkDrainDone()
 }
 
 void
-DRAMCtrl::Rank::flushCmdList()
+DRAMCtrl::Rank::flushCmdList(Tick until)
 {
     // at the moment sort the list of commands and update the counters
     // for DRAMPower libray when doing a refresh
@@ -1711,18 +2137,18 @@ DRAMCtrl::Rank::flushCmdList()
     // push to commands to DRAMPower
     for ( ; next_iter != cmdList.end() ; ++next_iter) {
          Command cmd = *next_iter;
-         if (cmd.timeStamp <= curTick()) {
-             // Move all commands at or before curTick to DRAMPower
+         if (cmd.timeStamp <= until) {
+             // Move all commands at or before until to DRAMPower
              power.powerlib.doCommand(cmd.type, cmd.bank,
                                       divCeil(cmd.timeStamp, memory.tCK) -
                                       memory.timeStampOffset);
          } else {
-             // done - found all commands at or before curTick()
-             // next_iter references the 1st command after curTick
+             // done - found all commands at or before until
+             // next_iter references the 1st command after until
              break;
          }
     }
-    // reset cmdList to only contain commands after curTick
+    // reset cmdList to only contain commands after until
     // if there are no commands after curTick, updated cmdList will be empty
     // in this case, next_iter is cmdList.end()
     cmdList.assign(next_iter, cmdList.end());
@@ -1782,6 +2208,13 @@ DRAMCtrl::Rank::processWriteDoneEvent()
 void
 DRAMCtrl::Rank::processRefreshEvent()
 {
+    // an idle rank does not need the full refresh state machine
+    if (memory.bulkRefresh && (refreshState == REF_IDLE) &&
+        bulkRefreshReady()) {
+        startBulkRefresh();
+        return;
+    }
+
     // when first preparing the refresh, remember when it was due
     if ((refreshState == REF_IDLE) || (refreshState == REF_SREF_EXIT)) {
         // remember when the refresh is due
@@ -1935,6 +2368,9 @@ DRAMCtrl::Rank::processRefreshEvent()
 
         assert(!powerEvent.scheduled());
 
+        // a refresh issued in bulk has been reached by now
+        updateBulkRefresh();
+
         if ((memory.drainState() == DrainState::Draining) ||
             (memory.drainState() == DrainState::Drained)) {
             // if draining, do not re-enter low-power mode.
@@ -1979,6 +2415,96 @@ DRAMCtrl::Rank::processRefreshEvent()
     }
 }
 
+bool
+DRAMCtrl::Rank::bulkRefreshReady() const
+{
+    // nothing queued, in flight or about to be issued for this rank,
+    // which is what the refresh state machine would wait for
+    if ((readEntries != 0) || (writeEntries != 0) ||
+        (outstandingEvents != 0) || (numBanksActive != 0) ||
+        powerEvent.scheduled() || wakeUpEvent.scheduled() ||
+        activateEvent.scheduled() || prechargeEvent.scheduled() ||
+        ((rank == memory.activeRank) && memory.nextReqEvent.scheduled()))
+        return false;
+
+    // either precharged and idle, or in precharge power-down and
+    // allowed to wake up right away
+    if (pwrState == PWR_PRE_PDN)
+        return inLowPowerState && (wakeUpAllowedAt <= curTick());
+
+    return (pwrState == PWR_IDLE) && !inLowPowerState;
+}
+
+void
+DRAMCtrl::Rank::startBulkRefresh()
+{
+    DPRINTF(DRAM, "Refresh due, issuing it in bulk\n");
+
+    // same bookkeeping as when starting and completing the drain
+    refreshDueAt = curTick();
+    ++outstandingEvents;
+    ++bulkRefreshes;
+
+    Tick ref_at = curTick();
+
+    if (pwrState == PWR_PRE_PDN) {
+        // wake up and return to the low-power state after refresh,
+        // the refresh is issued once the power-down exit is done
+        pwrStatePostRefresh = PWR_PRE_PDN;
+        pwrStateTrans = PWR_IDLE;
+        inLowPowerState = false;
+        ref_at += memory.tXP;
+
+        for (auto &b : banks) {
+            b.colAllowedAt = std::max(ref_at, b.colAllowedAt);
+            b.preAllowedAt = std::max(ref_at, b.preAllowedAt);
+        }
+
+        cmdList.push_back(Command(MemCommand::PUP_PRE, 0, curTick()));
+        DPRINTF(DRAMPower, "%llu,PUP_PRE,0,%d\n", divCeil(curTick(),
+                memory.tCK) - memory.timeStampOffset, rank);
+
+        totalIdleTime += curTick() - pwrStateTick;
+    } else {
+        pwrStateTrans = PWR_REF;
+    }
+
+    // the power-down exit is accounted as refresh time, just as when
+    // waking up through the power event
+    pwrStateTime[pwrState] += curTick() - pwrStateTick;
+    pwrState = PWR_REF;
+    pwrStateTick = curTick();
+
+    Tick ref_done_at = ref_at + memory.tRFC;
+
+    for (auto &b : banks) {
+        b.actAllowedAt = ref_done_at;
+    }
+
+    cmdList.push_back(Command(MemCommand::REF, 0, ref_at));
+
+    DPRINTF(DRAMPower, "%llu,REF,0,%d\n", divCeil(ref_at, memory.tCK) -
+            memory.timeStampOffset, rank);
+
+    // the DRAMPower window has to end at the refresh, if it is still
+    // ahead of us remember to close the window once we pass it
+    if (ref_at == curTick()) {
+        updatePowerStats();
+    } else {
+        bulkRefreshAt = ref_at;
+    }
+
+    refreshDueAt += memory.tREFI;
+
+    if (refreshDueAt < ref_done_at) {
+        fatal("Refresh was delayed so long we cannot catch up\n");
+    }
+
+    // from here on the refresh completes as any other
+    refreshState = REF_RUN;
+    schedule(refreshEvent, ref_done_at);
+}
+
 void
 DRAMCtrl::Rank::schedulePowerEvent(PowerState pwr_state, Tick tick)
 {
@@ -2232,18 +2758,38 @@ DRAMCtrl::Rank::processPowerEvent()
     }
 }
 
+void
+DRAMCtrl::Rank::updateBulkRefresh()
+{
+    if ((bulkRefreshAt != 0) && (bulkRefreshAt <= curTick())) {
+        Tick ref_at = bulkRefreshAt;
+        bulkRefreshAt = 0;
+
+        // if we are at the refresh the current window ends there
+        if (ref_at < curTick())
+            updatePowerStats(ref_at);
+    }
+}
+
 void
 DRAMCtrl::Rank::updatePowerStats()
+{
+    updateBulkRefresh();
+    updatePowerStats(curTick());
+}
+
+void
+DRAMCtrl::Rank::updatePowerStats(Tick until)
 {
     // All commands up to refresh have completed
     // flush cmdList to DRAMPower
-    flushCmdList();
+    flushCmdList(until);
 
     // Call the function that calculates window energy at intermediate update
     // events like at refresh, stats dump as well as at simulation exit.
     // Window starts at the last time the calcWindowEnergy function was called
     // and is upto current time.
-    power.powerlib.calcWindowEnergy(divCeil(curTick(), memory.tCK) -
+    power.powerlib.calcWindowEnergy(divCeil(until, memory.tCK) -
                                     memory.timeStampOffset);
 
     // Get the energy from DRAMPower
@@ -2271,7 +2817,7 @@ DRAMCtrl::Rank::updatePowerStats()
     // power (mW) = ----------- * ----------
     //              time (tick)   tick_frequency
     averagePower = (totalEnergy.value() /
-                    (curTick() - memory.lastStatsResetTick)) *
+                    (until - memory.lastStatsResetTick)) *
                     (SimClock::Frequency / 1000000000.0);
 }
 
@@ -2293,7 +2839,14 @@ void
 DRAMCtrl::Rank::resetStats() {
     // The only way to clear the counters in DRAMPower is to call
     // calcWindowEnergy function as that then calls clearCounters. The
-    // clearCounters method itself is private.
+    // clearCounters method itself is private. A window ending at a
+    // refresh issued in bulk is closed first, and discarded.
+    if ((bulkRefreshAt != 0) && (bulkRefreshAt <= curTick())) {
+        flushCmdList(bulkRefreshAt);
+        power.powerlib.calcWindowEnergy(divCeil(bulkRefreshAt, memory.tCK) -
+                                        memory.timeStampOffset);
+        bulkRefreshAt = 0;
+    }
     power.powerlib.calcWindowEnergy(divCeil(curTick(), memory.tCK) -
                                     memory.timeStampOffset);
 
@@ -2367,6 +2920,11 @@ DRAMCtrl::Rank::regStats()
         .name(name() + ".totalIdleTime")
         .desc("Total Idle time Per DRAM Rank");
 
+    bulkRefreshes
+        .name(name() + ".bulkRefreshes")
+        .desc("Number of refreshes of an idle rank issued in bulk")
+        .flags(nozero);
+
     registerDumpCallback(new RankDumpCallback(this));
     registerResetCallback(new RankResetCallback(this));
 }
@@ -2423,6 +2981,36 @@ DRAMCtrl::regStats()
         .name(name() + ".perBankWrBursts")
         .desc("Per bank write bursts");
 
+    bankConflicts
+        .init(ranksPerChannel, banksPerRank)
+        .name(name() + ".bankConflicts")
+        .desc("Row buffer conflicts per rank (rows) and bank (columns)")
+        .flags(nozero);
+
+    for (int i = 0; i < ranksPerChannel; i++)
+        bankConflicts.subname(i, csprintf("rank%d", i));
+    for (int j = 0; j < banksPerRank; j++)
+        bankConflicts.ysubname(j, csprintf("bank%d", j));
+
+    approxRdBursts
+        .name(name() + ".approxRdBursts")
+        .desc("Number of read bursts serviced by the approximate model");
+
+    approxWrBursts
+        .name(name() + ".approxWrBursts")
+        .desc("Number of write bursts serviced by the approximate model");
+
+    approxTotRdLat
+        .name(name() + ".approxTotRdLat")
+        .desc("Total ticks spent on read bursts in the approximate model");
+
+    approxAvgRdLat
+        .name(name() + ".approxAvgRdLat")
+        .desc("Average read burst latency in the approximate model")
+        .precision(2);
+
+    approxAvgRdLat = approxTotRdLat / approxRdBursts;
+
     avgRdQLen
         .name(name() + ".avgRdQLen")
         .desc("Average read queue length when enqueuing")
@@ -2629,6 +3217,69 @@ DRAMCtrl::regStats()
 
     pageHitRate = (writeRowHits + readRowHits) /
         (writeBursts - mergedWrBursts + readBursts - servicedByWrQ) * 100;
+
+    masterReadBursts
+        .init(system()->maxMasters())
+        .name(name() + ".masterReadBursts")
+        .desc("Read bursts serviced by the DRAM per master")
+        .flags(nozero | nonan);
+
+    masterWriteBursts
+        .init(system()->maxMasters())
+        .name(name() + ".masterWriteBursts")
+        .desc("Write bursts written to the DRAM per master")
+        .flags(nozero | nonan);
+
+    masterTotReadLat
+        .init(system()->maxMasters())
+        .name(name() + ".masterTotReadLat")
+        .desc("Total ticks from burst creation until serviced by the DRAM "
+              "per master")
+        .flags(nozero | nonan);
+
+    masterAvgReadLat
+        .name(name() + ".masterAvgReadLat")
+        .desc("Average memory access latency per DRAM read burst per master")
+        .flags(nozero | nonan)
+        .precision(2);
+
+    masterAvgReadLat = masterTotReadLat / masterReadBursts;
+
+    masterReadBW
+        .name(name() + ".masterReadBW")
+        .desc("Average DRAM read bandwidth per master in MiByte/s")
+        .flags(nozero | nonan)
+        .precision(2);
+
+    masterReadBW = (masterReadBursts * burstSize / 1000000) / simSeconds;
+
+    masterWriteBW
+        .name(name() + ".masterWriteBW")
+        .desc("Average DRAM write bandwidth per master in MiByte/s")
+        .flags(nozero | nonan)
+        .precision(2);
+
+    masterWriteBW = (masterWriteBursts * burstSize / 1000000) / simSeconds;
+
+    masterSlowdown
+        .name(name() + ".masterSlowdown")
+        .desc("Average read latency per master relative to an unloaded "
+              "closed-row access")
+        .flags(nozero | nonan)
+        .precision(2);
+
+    masterSlowdown = masterAvgReadLat / (tRCD + tCL + tBURST);
+
+    for (int i = 0; i < system()->maxMasters(); i++) {
+        const std::string master = system()->getMasterName(i);
+        masterReadBursts.subname(i, master);
+        masterWriteBursts.subname(i, master);
+        masterTotReadLat.subname(i, master);
+        masterAvgReadLat.subname(i, master);
+        masterReadBW.subname(i, master);
+        masterWriteBW.subname(i, master);
+        masterSlowdown.subname(i, master);
+    }
 }
 
 void
@@ -55,7 +55,10 @@
 #define __MEM_DRAM_CTRL_HH__
 
 #include <deque>
+#include <functional>
+#include <queue>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "base/callback.hh"
@@ -64,6 +67,7 @@
 #include "enums/MemSched.hh"
 #include "enums/PageManage.hh"
 #include "mem/abstract_mem.hh"
+#include "mem/dram_sched.hh"
 #include "mem/qport.hh"
 #include "params/DRAMCtrl.hh"
 #include "sim/eventq.hh"
@@ -366,11 +370,53 @@ class DRAMCtrl : public AbstractMemory
          */
         Stats::Vector pwrStateTime;
 
+        /**
+         * Time of a refresh issued in bulk for which the DRAMPower
+         * window has not been calculated yet, zero if there is none.
+         */
+        Tick bulkRefreshAt;
+
+        /**
+         * Number of refreshes issued in bulk.
+         */
+        Stats::Scalar bulkRefreshes;
+
         /**
          * Function to update Power Stats
          */
         void updatePowerStats();
 
+        /**
+         * Flush the commands up to a given tick to DRAMPower and
+         * accumulate the energy of the window ending at that tick.
+         *
+         * @param until Tick at which the window ends
+         */
+        void updatePowerStats(Tick until);
+
+        /**
+         * Calculate the DRAMPower window of a refresh issued in bulk,
+         * if the refresh has been reached, so that the windows are
+         * split exactly as when the refresh is issued by an event.
+         */
+        void updateBulkRefresh();
+
+        /**
+         * Check if the refresh that is due can be issued in bulk, that
+         * is, if the rank is idle and either in precharge power-down or
+         * precharged with nothing outstanding.
+         *
+         * @return true if the rank is idle
+         */
+        bool bulkRefreshReady() const;
+
+        /**
+         * Issue a refresh in bulk, accounting for the power-down exit
+         * and the power state transitions directly and scheduling the
+         * end of the refresh.
+         */
+        void startBulkRefresh();
+
         /**
          * Schedule a power state transition in the future, and
          * potentially override an already scheduled transition.
@@ -520,11 +566,13 @@ class DRAMCtrl : public AbstractMemory
 
         /**
          * Push command out of cmdList queue that are scheduled at
-         * or before curTick() to DRAMPower library
+         * or before the given tick to DRAMPower library
          * All commands before curTick are guaranteed to be complete
          * and can safely be flushed.
+         *
+         * @param until Tick up to which commands are flushed
          */
-        void flushCmdList();
+        void flushCmdList(Tick until);
 
         /*
          * Function to register Stats
@@ -654,6 +702,9 @@ class DRAMCtrl : public AbstractMemory
         /** This comes from the outside world */
         const PacketPtr pkt;
 
+        /** Master of the request, kept as the packet may go away */
+        const MasterID masterId;
+
         const bool isRead;
 
         /** Will be populated by address decoder */
@@ -694,13 +745,84 @@ class DRAMCtrl : public AbstractMemory
                    uint32_t _row, uint16_t bank_id, Addr _addr,
                    unsigned int _size, Bank& bank_ref, Rank& rank_ref)
             : entryTime(curTick()), readyTime(curTick()),
-              pkt(_pkt), isRead(is_read), rank(_rank), bank(_bank), row(_row),
+              pkt(_pkt), masterId(_pkt->req->masterId()), isRead(is_read),
+              rank(_rank), bank(_bank), row(_row),
               bankId(bank_id), addr(_addr), size(_size), burstHelper(NULL),
               bankRef(bank_ref), rankRef(rank_ref)
         { }
 
     };
 
+    /**
+     * A read or write queue of DRAM packets. The packets are kept in
+     * arrival order, and the scheduler moves the selected packet to
+     * the head of the queue. In addition, the packets are indexed per
+     * bank, and within a bank per row, with the arrival order of
+     * every packet, so that the scheduler can find the oldest row hit
+     * or the oldest row miss of a bank without scanning the whole
+     * queue.
+     */
+    class DRAMPacketQueue
+    {
+      public:
+
+        /** Packets to a single row of a bank, oldest first */
+        typedef std::deque<std::pair<uint64_t, DRAMPacket*>> RowQueue;
+
+        /** Packets to a single bank, bucketed per row */
+        struct BankQueue
+        {
+            std::unordered_map<uint32_t, RowQueue> rows;
+            unsigned size = 0;
+        };
+
+        typedef std::deque<DRAMPacket*>::const_iterator const_iterator;
+
+        DRAMPacketQueue() : nextSeqNum(0) { }
+
+        /**
+         * Set up the per-bank index.
+         *
+         * @param num_banks Number of banks across all ranks
+         */
+        void init(unsigned num_banks) { banks.resize(num_banks); }
+
+        bool empty() const { return packets.empty(); }
+        size_t size() const { return packets.size(); }
+        DRAMPacket* front() const { return packets.front(); }
+        const_iterator begin() const { return packets.begin(); }
+        const_iterator end() const { return packets.end(); }
+
+        /** Get the packets queued for a bank, using its global id */
+        const BankQueue& bank(uint16_t bank_id) const
+        {
+            return banks[bank_id];
+        }
+
+        /** Add a packet at the tail of the queue */
+        void push_back(DRAMPacket* dram_pkt);
+
+        /** Remove the packet at the head of the queue */
+        void pop_front();
+
+        /** Move a queued packet to the head of the queue */
+        void moveToFront(DRAMPacket* dram_pkt);
+
+      private:
+
+        /**
+         * All packets in arrival order, apart from the packet the
+         * scheduler moved to the head
+         */
+        std::deque<DRAMPacket*> packets;
+
+        /** The per-bank index */
+        std::vector<BankQueue> banks;
+
+        /** Arrival order of the next packet */
+        uint64_t nextSeqNum;
+    };
+
     /**
      * Bunch of things requires to setup "events" in gem5
      * When event "respondEvent" occurs for example, the method
@@ -713,6 +835,71 @@ class DRAMCtrl : public AbstractMemory
     void processRespondEvent();
     EventFunctionWrapper respondEvent;
 
+    /**
+     * State of a bank in the approximate model, merely tracking the
+     * open row and when the bank can accept its next access.
+     */
+    struct ApproxBank
+    {
+        uint32_t openRow;
+        Tick freeAt;
+
+        ApproxBank() : openRow(Bank::NO_ROW), freeAt(0) { }
+    };
+
+    /**
+     * Remember if we are using the approximate model, in which case
+     * all requests are serviced directly on arrival, without any
+     * queueing in the controller or scheduling of DRAM commands.
+     */
+    bool approximate;
+
+    /**
+     * Per-bank state of the approximate model, indexed by the flat
+     * bank id (rank * banksPerRank + bank).
+     */
+    std::vector<ApproxBank> approxBanks;
+
+    /**
+     * Tick at which the data bus is free in the approximate model.
+     */
+    Tick approxBusFreeAt;
+
+    /**
+     * Completion times of the requests in flight in the approximate
+     * model, used to bound the number of outstanding requests by the
+     * read and write buffer sizes, and thus capture the queueing
+     * delay seen by the requestors.
+     */
+    std::priority_queue<Tick, std::vector<Tick>,
+                        std::greater<Tick>> approxReadsInFlight;
+    std::priority_queue<Tick, std::vector<Tick>,
+                        std::greater<Tick>> approxWritesInFlight;
+
+    /**
+     * Service a request using the approximate model, estimating the
+     * latency of each burst based on the state of its bank and the
+     * occupancy of the data bus.
+     *
+     * @param pkt The request packet from the outside world
+     * @param pktCount The number of DRAM bursts the pkt translates to
+     * @return false if there are too many requests in flight
+     */
+    bool approxAccess(PacketPtr pkt, unsigned int pktCount);
+
+    /**
+     * Retire the requests in flight in the approximate model that are
+     * complete at the current tick.
+     */
+    void approxRetire();
+
+    /**
+     * Once requests in flight complete, let the requestor retry
+     * after we rejected a request in the approximate model.
+     */
+    void processApproxRetryEvent();
+    EventFunctionWrapper approxRetryEvent;
+
     /**
      * Check if the read queue has room for more entries
      *
@@ -781,6 +968,40 @@ class DRAMCtrl : public AbstractMemory
      */
     void accessAndRespond(PacketPtr pkt, Tick static_latency);
 
+    /**
+     * Apply the address mapping policy to determine the rank, bank
+     * and row of an address, before any XOR permutation.
+     *
+     * @param dramPktAddr The address to map
+     * @param rank Rank index of the address
+     * @param bank Bank index within the rank
+     * @param row Row index within the bank
+     */
+    void mapAddr(Addr dramPktAddr, uint8_t& rank, uint8_t& bank,
+                 uint64_t& row) const;
+
+    /**
+     * Determine the rank, bank and row of an address, including the
+     * optional XOR permutation of the rank and bank.
+     *
+     * @param dramPktAddr The address to map
+     * @param rank Rank index of the address
+     * @param bank Bank index within the rank
+     * @param row Row index within the bank
+     */
+    void locateAddr(Addr dramPktAddr, uint8_t& rank, uint8_t& bank,
+                    uint64_t& row) const;
+
+    /**
+     * Record the bursts of a request in the access trace, if enabled,
+     * stamped with the current tick. Requests are recorded as they
+     * are accepted, so that the trace keeps their arrival order and
+     * spacing.
+     *
+     * @param pkt The request packet from the outside world
+     */
+    void traceBursts(PacketPtr pkt);
+
     /**
      * Address decoder to figure out physical mapping onto ranks,
      * banks, and rows. This function is called multiple times on the same
@@ -808,18 +1029,31 @@ class DRAMCtrl : public AbstractMemory
      * @return true if a packet is scheduled to a rank which is available else
      * false
      */
-    bool chooseNext(std::deque<DRAMPacket*>& queue, Tick extra_col_delay);
+    bool chooseNext(DRAMPacketQueue& queue, Tick extra_col_delay);
 
     /**
      * For FR-FCFS policy reorder the read/write queue depending on row buffer
-     * hits and earliest bursts available in DRAM
+     * hits and earliest bursts available in DRAM. The selection is
+     * done using the per-bank index of the queue, and picks the same
+     * packet as a scan of the queue in arrival order would.
      *
      * @param queue Queued requests to consider
      * @param extra_col_delay Any extra delay due to a read/write switch
      * @return true if a packet is scheduled to a rank which is available else
      * false
      */
-    bool reorderQueue(std::deque<DRAMPacket*>& queue, Tick extra_col_delay);
+    bool reorderQueue(DRAMPacketQueue& queue, Tick extra_col_delay);
+
+    /**
+     * For the QoS and thread-aware policies, reorder the read/write
+     * queue by the priority of the masters, and then by row buffer
+     * hits (unless using FCFS) and age.
+     *
+     * @param queue Queued requests to consider
+     * @return true if a packet is scheduled to a rank which is available else
+     * false
+     */
+    bool prioritizeQueue(DRAMPacketQueue& queue);
 
     /**
      * Find which are the earliest banks ready to issue an activate
@@ -831,7 +1065,7 @@ class DRAMCtrl : public AbstractMemory
      * @return One-hot encoded mask of bank indices
      * @return boolean indicating burst can issue seamlessly, with no gaps
      */
-    std::pair<uint64_t, bool> minBankPrep(const std::deque<DRAMPacket*>& queue,
+    std::pair<uint64_t, bool> minBankPrep(const DRAMPacketQueue& queue,
                                           Tick min_col_at) const;
 
     /**
@@ -878,8 +1112,8 @@ class DRAMCtrl : public AbstractMemory
     /**
      * The controller's main read and write queues
      */
-    std::deque<DRAMPacket*> readQueue;
-    std::deque<DRAMPacket*> writeQueue;
+    DRAMPacketQueue readQueue;
+    DRAMPacketQueue writeQueue;
 
     /**
      * To avoid iterating over the write queue to check for
@@ -926,6 +1160,13 @@ class DRAMCtrl : public AbstractMemory
     const uint32_t banksPerRank;
     const uint32_t channels;
     uint32_t rowsPerBank;
+
+    /**
+     * Address bit masks for the XOR permutation of the rank and bank
+     * index, with one mask per index bit, least significant first
+     */
+    const std::vector<Addr> rankXorMasks;
+    const std::vector<Addr> bankXorMasks;
     const uint32_t readBufferSize;
     const uint32_t writeBufferSize;
     const uint32_t writeHighThreshold;
@@ -967,12 +1208,21 @@ class DRAMCtrl : public AbstractMemory
     Enums::AddrMap addrMapping;
     Enums::PageManage pageMgmt;
 
+    /** Per-master priorities for the QoS and thread-aware policies */
+    DRAMMasterSched masterSched;
+
     /**
      * Max column accesses (read and write) per row, before forefully
      * closing it.
      */
     const uint32_t maxAccessesPerRow;
 
+    /**
+     * Refresh idle ranks in bulk, collapsing the wake-up, power and
+     * refresh events into the event that starts the refresh.
+     */
+    const bool bulkRefresh;
+
     /**
      * Pipeline latency of the controller frontend. The frontend
      * contribution is added to writes (that complete when they are in
@@ -1017,6 +1267,11 @@ class DRAMCtrl : public AbstractMemory
     Stats::Scalar neitherReadNorWrite;
     Stats::Vector perBankRdBursts;
     Stats::Vector perBankWrBursts;
+    Stats::Vector2d bankConflicts;
+    Stats::Scalar approxRdBursts;
+    Stats::Scalar approxWrBursts;
+    Stats::Scalar approxTotRdLat;
+    Stats::Formula approxAvgRdLat;
     Stats::Scalar numRdRetry;
     Stats::Scalar numWrRetry;
     Stats::Scalar totGap;
@@ -1062,6 +1317,15 @@ class DRAMCtrl : public AbstractMemory
     // DRAM Power Calculation
     Stats::Formula pageHitRate;
 
+    // Per-master statistics
+    Stats::Vector masterReadBursts;
+    Stats::Vector masterWriteBursts;
+    Stats::Vector masterTotReadLat;
+    Stats::Formula masterAvgReadLat;
+    Stats::Formula masterReadBW;
+    Stats::Formula masterWriteBW;
+    Stats::Formula masterSlowdown;
+
     // Holds the value of the rank of burst issued
     uint8_t activeRank;
 
@@ -1125,6 +1389,25 @@ class DRAMCtrl : public AbstractMemory
      */
     bool allRanksDrained() const;
 
+    /**
+     * Switch between the detailed and the approximate model. The
+     * controller has to be drained when switching, which leaves all
+     * banks closed, so the approximate model starts with closed banks.
+     * Going back to the detailed model closes the rows the approximate
+     * model left open, and the banks and the data bus stay busy until
+     * the approximate model had them free and precharged.
+     *
+     * The refresh and power-state events of the ranks keep running
+     * in the approximate model, so refresh is still accounted for in
+     * the power and energy stats. The approximate model itself only
+     * estimates the refresh delay, by pushing any access that falls
+     * in the tRFC window at the start of every tREFI beyond it, as if
+     * all ranks refreshed in phase.
+     *
+     * @param approx true to use the approximate model
+     */
+    void setApproximate(bool approx);
+
   protected:
 
     Tick recvAtomic(PacketPtr pkt);
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * DRAMMasterSched definitions
+ */
+
+#include "mem/dram_sched.hh"
+
+#include <algorithm>
+#include <numeric>
+
+#include "base/logging.hh"
+#include "sim/system.hh"
+
+DRAMMasterSched::DRAMMasterSched(const DRAMCtrlParams* p)
+    : policy(p->mem_sched_policy),
+      qosMasters(p->qos_masters), qosPriorities(p->qos_priorities),
+      quantum(p->sched_quantum), blissThreshold(p->bliss_threshold),
+      blissClearInterval(p->bliss_clear_interval),
+      atlasHistoryWeight(p->atlas_history_weight),
+      atlasStarvationThreshold(p->atlas_starvation_threshold),
+      tcmClusterFraction(p->tcm_cluster_fraction),
+      tcmShuffleInterval(p->tcm_shuffle_interval),
+      nextQuantum(0), nextBlacklistClear(0), nextShuffle(0),
+      lastMaster(Request::invldMasterId), streak(0)
+{
+    fatal_if(qosMasters.size() != qosPriorities.size(), "%d QoS masters "
+             "given, but %d priorities\n", qosMasters.size(),
+             qosPriorities.size());
+    fatal_if(quantum == 0 || blissClearInterval == 0 ||
+             tcmShuffleInterval == 0, "Scheduler intervals must be "
+             "non-zero\n");
+    fatal_if(atlasHistoryWeight < 0 || atlasHistoryWeight >= 1,
+             "ATLAS history weight must be in [0, 1)\n");
+}
+
+void
+DRAMMasterSched::startup(System* sys)
+{
+    masters.resize(sys->maxMasters());
+
+    // a master is matched either by its full name, or by the name of
+    // the object it belongs to, e.g. "system.cpu0" covers both the
+    // instruction and data side of a CPU
+    for (MasterID m = 0; m < masters.size(); ++m) {
+        const std::string name = sys->getMasterName(m);
+        for (int i = 0; i < qosMasters.size(); ++i) {
+            const std::string& prefix = qosMasters[i];
+            if (name == prefix ||
+                (name.compare(0, prefix.size(), prefix) == 0 &&
+                 name[prefix.size()] == '.')) {
+                masters[m].prioClass = qosPriorities[i];
+            }
+        }
+    }
+}
+
+bool
+DRAMMasterSched::enabled() const
+{
+    return !qosMasters.empty() ||
+        (policy != Enums::fcfs && policy != Enums::frfcfs);
+}
+
+void
+DRAMMasterSched::update(Tick now)
+{
+    if (policy == Enums::bliss && now >= nextBlacklistClear) {
+        for (auto& m : masters)
+            m.blacklisted = false;
+        nextBlacklistClear = now + blissClearInterval;
+    }
+
+    if ((policy == Enums::atlas || policy == Enums::tcm) &&
+        now >= nextQuantum) {
+        rankMasters();
+        nextQuantum = now + quantum;
+        nextShuffle = now + tcmShuffleInterval;
+    }
+
+    if (policy == Enums::tcm && now >= nextShuffle) {
+        shuffleBandwidthCluster();
+        nextShuffle = now + tcmShuffleInterval;
+    }
+}
+
+void
+DRAMMasterSched::rankMasters()
+{
+    std::vector<MasterID> order(masters.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    if (policy == Enums::atlas) {
+        for (auto& m : masters) {
+            m.totalService = atlasHistoryWeight * m.totalService +
+                (1 - atlasHistoryWeight) * m.quantumService;
+        }
+
+        // the least attained service gets the highest rank
+        std::stable_sort(order.begin(), order.end(),
+                         [this](MasterID a, MasterID b)
+                         { return masters[a].totalService >
+                                 masters[b].totalService; });
+        for (unsigned i = 0; i < order.size(); ++i)
+            masters[order[i]].rank = i;
+    } else {
+        assert(policy == Enums::tcm);
+
+        // lightest masters first, and they form the latency-sensitive
+        // cluster as long as they stay within their share of the
+        // total bandwidth
+        std::stable_sort(order.begin(), order.end(),
+                         [this](MasterID a, MasterID b)
+                         { return masters[a].quantumService <
+                                 masters[b].quantumService; });
+
+        Tick total = 0;
+        for (const auto& m : masters)
+            total += m.quantumService;
+
+        const unsigned num_masters = order.size();
+        Tick cluster_service = 0;
+        bandwidthCluster.clear();
+        for (unsigned i = 0; i < num_masters; ++i) {
+            MasterState& m = masters[order[i]];
+            cluster_service += m.quantumService;
+            if (bandwidthCluster.empty() &&
+                cluster_service <= tcmClusterFraction * total) {
+                // ranked above all of the bandwidth-sensitive cluster
+                m.rank = 2 * num_masters - i;
+            } else {
+                bandwidthCluster.push_back(order[i]);
+            }
+        }
+
+        // start the bandwidth-sensitive cluster with the lightest
+        // master at the top, the shuffling then rotates the order
+        for (unsigned i = 0; i < bandwidthCluster.size(); ++i)
+            masters[bandwidthCluster[i]].rank = bandwidthCluster.size() - i;
+    }
+
+    for (auto& m : masters)
+        m.quantumService = 0;
+}
+
+void
+DRAMMasterSched::shuffleBandwidthCluster()
+{
+    if (bandwidthCluster.size() < 2)
+        return;
+
+    std::rotate(bandwidthCluster.begin(), bandwidthCluster.begin() + 1,
+                bandwidthCluster.end());
+    for (unsigned i = 0; i < bandwidthCluster.size(); ++i)
+        masters[bandwidthCluster[i]].rank = bandwidthCluster.size() - i;
+}
+
+uint64_t
+DRAMMasterSched::priority(MasterID master, Tick entry_time, Tick now) const
+{
+    if (master >= masters.size())
+        return 0;
+
+    const MasterState& m = masters[master];
+
+    // the priority class takes precedence over anything else, then
+    // starving requests, and finally the rank of the master
+    uint64_t prio = uint64_t(m.prioClass) << 40;
+
+    switch (policy) {
+      case Enums::bliss:
+        prio |= m.blacklisted ? 0 : 1;
+        break;
+      case Enums::atlas:
+        if (now - entry_time > atlasStarvationThreshold)
+            prio |= uint64_t(1) << 39;
+        prio |= m.rank;
+        break;
+      case Enums::tcm:
+        prio |= m.rank;
+        break;
+      default:
+        break;
+    }
+
+    return prio;
+}
+
+void
+DRAMMasterSched::serviced(MasterID master, Tick service)
+{
+    // masters not registered with the system are left unscheduled
+    if (master >= masters.size())
+        return;
+
+    MasterState& m = masters[master];
+    m.quantumService += service;
+
+    if (policy == Enums::bliss) {
+        if (master == lastMaster) {
+            if (++streak >= blissThreshold)
+                m.blacklisted = true;
+        } else {
+            lastMaster = master;
+            streak = 1;
+        }
+    }
+}
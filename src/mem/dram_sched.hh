@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * DRAMMasterSched declaration
+ */
+
+#ifndef __MEM_DRAM_SCHED_HH__
+#define __MEM_DRAM_SCHED_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+#include "enums/MemSched.hh"
+#include "mem/request.hh"
+#include "params/DRAMCtrl.hh"
+
+class System;
+
+/**
+ * Per-master prioritisation for the DRAM controller scheduler. It
+ * combines static priority classes, assigned to masters by name, with
+ * the dynamic ranking of the thread-aware scheduling policies:
+ *
+ * - BLISS: masters that are served a number of requests in a row are
+ *   blacklisted, and the blacklist is cleared periodically.
+ * - ATLAS: masters are ranked every quantum by their least attained
+ *   service, using an exponentially weighted history, and requests
+ *   that wait beyond a threshold go first.
+ * - TCM: masters are split every quantum into a latency-sensitive
+ *   cluster of the lightest masters, ranked by bandwidth, and a
+ *   bandwidth-sensitive cluster that is ranked below it and whose
+ *   order is shuffled periodically.
+ *
+ * The controller picks the highest-priority request to an available
+ * rank, and among requests of equal priority it prefers row hits
+ * (unless using FCFS), and then the oldest request.
+ */
+class DRAMMasterSched
+{
+
+  public:
+
+    DRAMMasterSched(const DRAMCtrlParams* p);
+
+    /**
+     * Resolve the master names of the priority classes, and size the
+     * per-master state. Must be called once all masters are
+     * registered with the system.
+     *
+     * @param sys System the controller belongs to
+     */
+    void startup(System* sys);
+
+    /**
+     * Is any prioritisation needed at all, or can the controller stick
+     * to its plain FCFS or FR-FCFS scheduling?
+     */
+    bool enabled() const;
+
+    /**
+     * Advance the ranking state to the current tick, i.e. clear the
+     * blacklist, recompute the ranks, or shuffle the clusters as the
+     * policy requires.
+     *
+     * @param now Current tick
+     */
+    void update(Tick now);
+
+    /**
+     * Get the priority of a request, higher is more important.
+     *
+     * @param master Master id of the request
+     * @param entry_time When the request entered the controller
+     * @param now Current tick
+     * @return Priority, comparable across masters
+     */
+    uint64_t priority(MasterID master, Tick entry_time, Tick now) const;
+
+    /**
+     * Account for a burst being issued on behalf of a master. Like
+     * priority(), this ignores masters that are not registered.
+     *
+     * @param master Master id of the request
+     * @param service Data bus time used by the burst
+     */
+    void serviced(MasterID master, Tick service);
+
+  private:
+
+    /** Per-master scheduling state */
+    struct MasterState {
+        /** Static priority class, higher is more important */
+        unsigned prioClass = 0;
+        /** Dynamic rank, higher is more important */
+        unsigned rank = 0;
+        /** Service attained during the current quantum */
+        Tick quantumService = 0;
+        /** Weighted service history (ATLAS) */
+        double totalService = 0;
+        /** Blacklisted for being served too many requests in a row */
+        bool blacklisted = false;
+    };
+
+    /** Recompute the ranks at the end of a quantum */
+    void rankMasters();
+
+    /** Rotate the ranks of the bandwidth-sensitive cluster (TCM) */
+    void shuffleBandwidthCluster();
+
+    const Enums::MemSched policy;
+
+    /** Master names and the corresponding priority classes */
+    const std::vector<std::string> qosMasters;
+    const std::vector<unsigned> qosPriorities;
+
+    const Tick quantum;
+    const unsigned blissThreshold;
+    const Tick blissClearInterval;
+    const double atlasHistoryWeight;
+    const Tick atlasStarvationThreshold;
+    const double tcmClusterFraction;
+    const Tick tcmShuffleInterval;
+
+    std::vector<MasterState> masters;
+
+    /** Masters in the bandwidth-sensitive cluster, in rank order */
+    std::vector<MasterID> bandwidthCluster;
+
+    /** Next ticks at which the ranking state changes */
+    Tick nextQuantum;
+    Tick nextBlacklistClear;
+    Tick nextShuffle;
+
+    /** Master served last, and how many requests in a row (BLISS) */
+    MasterID lastMaster;
+    unsigned streak;
+};
+
+#endif //__MEM_DRAM_SCHED_HH__
@@ -56,6 +56,8 @@ DRAMSim2::DRAMSim2(const Params* p) :
     sendResponseEvent([this]{ sendResponse(); }, name()),
     tickEvent([this]{ tick(); }, name())
 {
+    fatal_if(p->trace_file != "", "%s does not support access "
+             "tracing\n", name());
     DPRINTF(DRAMSim2,
             "Instantiated DRAMSim2 with clock %d ns and queue size %d\n",
             wrapper.clockPeriod(), wrapper.queueSize());
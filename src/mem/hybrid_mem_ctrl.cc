@@ -0,0 +1,599 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/hybrid_mem_ctrl.hh"
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "base/trace.hh"
+#include "debug/Drain.hh"
+#include "debug/HybridMem.hh"
+
+HybridMemCtrl::HybridMemCtrl(const HybridMemCtrlParams* p) :
+    MemObject(p),
+    cpuPort(name() + ".port", *this),
+    dramPort(name() + ".dram_port", *this, DRAM),
+    nvmPort(name() + ".nvm_port", *this, NVM),
+    system(p->system), masterId(p->system->getMasterId(name())),
+    range(p->range), pageSize(p->page_size),
+    numPages(p->range.size() / p->page_size),
+    dramPages(p->dram_size / p->page_size),
+    migrationInterval(p->migration_interval),
+    migrationThreshold(p->migration_threshold),
+    maxMigrations(p->max_migrations),
+    migrationBurstSize(p->migration_burst_size),
+    frameOf(numPages), pageOf(numPages), counters(numPages, {0, 0}),
+    interval(0), victimHand(0), outstanding(0),
+    memBlocked{false, false}, retryReq{false, false},
+    migrationEvent([this]{ processMigrationEvent(); }, name())
+{
+    fatal_if(range.interleaved(), "%s does not support interleaved "
+             "ranges\n", name());
+    fatal_if(!isPowerOf2(pageSize) || range.size() % pageSize != 0,
+             "%s page size must be a power of two dividing the range\n",
+             name());
+    fatal_if(p->dram_size % pageSize != 0 || dramPages == 0 ||
+             dramPages >= numPages,
+             "%s DRAM tier must be a non-empty part of the range, in whole "
+             "pages\n", name());
+    fatal_if(migrationBurstSize == 0 || pageSize % migrationBurstSize != 0,
+             "%s migration burst size must divide the page size\n",
+             name());
+
+    // start with every page in the frame with the same address
+    for (uint32_t i = 0; i < numPages; ++i) {
+        frameOf[i] = i;
+        pageOf[i] = i;
+    }
+}
+
+BaseMasterPort&
+HybridMemCtrl::getMasterPort(const std::string& if_name, PortID idx)
+{
+    if (if_name == "dram_port") {
+        return dramPort;
+    } else if (if_name == "nvm_port") {
+        return nvmPort;
+    } else {
+        return MemObject::getMasterPort(if_name, idx);
+    }
+}
+
+BaseSlavePort&
+HybridMemCtrl::getSlavePort(const std::string& if_name, PortID idx)
+{
+    if (if_name == "port") {
+        return cpuPort;
+    } else {
+        return MemObject::getSlavePort(if_name, idx);
+    }
+}
+
+void
+HybridMemCtrl::init()
+{
+    MemObject::init();
+
+    if (!cpuPort.isConnected() || !dramPort.isConnected() ||
+        !nvmPort.isConnected())
+        fatal("%s is not connected on all sides.\n", name());
+
+    // make sure the tiers together cover our range
+    const AddrRange tier_ranges[NUM_TIERS] = {
+        AddrRange(range.start(), frameAddr(dramPages) - 1),
+        AddrRange(frameAddr(dramPages), range.end())
+    };
+    for (int t = 0; t < NUM_TIERS; ++t) {
+        AddrRangeList ranges = memPort(Tier(t)).getAddrRanges();
+        bool covered = std::any_of(ranges.begin(), ranges.end(),
+                                   [&](const AddrRange& r)
+                                   { return tier_ranges[t].isSubset(r); });
+        fatal_if(!covered, "%s %s tier does not cover %s\n", name(),
+                 t == DRAM ? "DRAM" : "NVM", tier_ranges[t].to_string());
+    }
+
+    cpuPort.sendRangeChange();
+}
+
+void
+HybridMemCtrl::startup()
+{
+    schedule(migrationEvent, curTick() + migrationInterval);
+}
+
+Addr
+HybridMemCtrl::remapAddr(Addr addr, uint32_t& page, Tier& tier) const
+{
+    assert(range.contains(addr));
+    Addr offset = addr - range.start();
+    page = offset / pageSize;
+    uint32_t frame = frameOf[page];
+    tier = frameTier(frame);
+    return frameAddr(frame) + (offset & (pageSize - 1));
+}
+
+void
+HybridMemCtrl::recordAccess(uint32_t page, Tier tier, bool is_read)
+{
+    if (is_read)
+        tierReads[tier]++;
+    else
+        tierWrites[tier]++;
+
+    PageCounter& counter = counters[page];
+    if (counter.interval != interval) {
+        counter.count = 0;
+        counter.interval = interval;
+    }
+    ++counter.count;
+
+    // only note the page once, when it crosses the threshold
+    if (tier == NVM && counter.count == migrationThreshold) {
+        DPRINTF(HybridMem, "Page %d is hot\n", page);
+        hotPages.push_back(page);
+    }
+}
+
+Tick
+HybridMemCtrl::recvAtomic(PacketPtr pkt)
+{
+    uint32_t page;
+    Tier tier;
+    Addr orig_addr = pkt->getAddr();
+    bool is_read = pkt->isRead();
+    pkt->setAddr(remapAddr(orig_addr, page, tier));
+    Tick latency = memPort(tier).sendAtomic(pkt);
+    pkt->setAddr(orig_addr);
+    recordAccess(page, tier, is_read);
+    return latency;
+}
+
+void
+HybridMemCtrl::recvFunctional(PacketPtr pkt)
+{
+    uint32_t page;
+    Tier tier;
+    Addr orig_addr = pkt->getAddr();
+    Addr end = orig_addr + pkt->getSize();
+
+    if ((orig_addr & ~(pageSize - 1)) == ((end - 1) & ~(pageSize - 1))) {
+        pkt->setAddr(remapAddr(orig_addr, page, tier));
+        memPort(tier).sendFunctional(pkt);
+        pkt->setAddr(orig_addr);
+        return;
+    }
+
+    // neighbouring pages may live in different frames and tiers, so
+    // split an access crossing pages, e.g. from a loader, per page
+    for (Addr addr = orig_addr; addr < end; ) {
+        Addr chunk_end = std::min((addr | (pageSize - 1)) + 1, end);
+        Request req(remapAddr(addr, page, tier), chunk_end - addr,
+                    pkt->req->getFlags(), pkt->req->masterId());
+        Packet chunk(&req, pkt->cmd);
+        chunk.dataStatic(pkt->getPtr<uint8_t>() + (addr - orig_addr));
+        memPort(tier).sendFunctional(&chunk);
+        addr = chunk_end;
+    }
+
+    if (pkt->needsResponse())
+        pkt->makeResponse();
+}
+
+bool
+HybridMemCtrl::recvTimingReq(PacketPtr pkt)
+{
+    panic_if(pkt->cacheResponding(), "Should not see packets where cache "
+             "is responding");
+
+    uint32_t page;
+    Tier tier;
+    Addr orig_addr = pkt->getAddr();
+    Addr addr = remapAddr(orig_addr, page, tier);
+
+    // do not send anything to a tier that owes us a retry
+    if (memBlocked[tier]) {
+        retryReq[tier] = true;
+        return false;
+    }
+
+    bool needs_response = pkt->needsResponse();
+    bool is_read = pkt->isRead();
+    if (needs_response) {
+        pkt->pushSenderState(new HybridSenderState(orig_addr, page));
+    }
+    pkt->setAddr(addr);
+
+    if (!memPort(tier).sendTimingReq(pkt)) {
+        // restore the packet and wait for the tier to retry
+        pkt->setAddr(orig_addr);
+        if (needs_response) {
+            delete pkt->popSenderState();
+        }
+        memBlocked[tier] = true;
+        retryReq[tier] = true;
+        return false;
+    }
+
+    if (needs_response) {
+        ++outstandingPerPage[page];
+        ++outstanding;
+    }
+
+    recordAccess(page, tier, is_read);
+    return true;
+}
+
+bool
+HybridMemCtrl::recvTimingResp(PacketPtr pkt, Tier tier)
+{
+    if (pkt->req->masterId() == masterId) {
+        // a migration request, simply sink the response
+        delete pkt->req;
+        delete pkt;
+    } else {
+        HybridSenderState* state =
+            dynamic_cast<HybridSenderState*>(pkt->popSenderState());
+        panic_if(!state, "%s got a response without sender state\n",
+                 name());
+
+        pkt->setAddr(state->origAddr);
+
+        auto p = outstandingPerPage.find(state->page);
+        assert(p != outstandingPerPage.end());
+        if (--p->second == 0)
+            outstandingPerPage.erase(p);
+
+        delete state;
+
+        // the queued port takes care of any flow control upstream
+        cpuPort.schedTimingResp(pkt, curTick());
+    }
+
+    assert(outstanding != 0);
+    --outstanding;
+    checkDrained();
+
+    return true;
+}
+
+void
+HybridMemCtrl::recvReqRetry(Tier tier)
+{
+    assert(memBlocked[tier]);
+    memBlocked[tier] = false;
+
+    // migration requests go first, as they are never retried by
+    // anyone else
+    sendMigrationReqs(tier);
+
+    if (!memBlocked[tier] && retryReq[tier]) {
+        retryReq[tier] = false;
+        cpuPort.sendRetryReq();
+    }
+}
+
+uint32_t
+HybridMemCtrl::findVictim(uint32_t hot_count)
+{
+    // sweep at most once over all the DRAM frames, looking for a page
+    // that is colder than the hot one and has no outstanding requests
+    for (uint32_t i = 0; i < dramPages; ++i) {
+        uint32_t frame = victimHand;
+        victimHand = (victimHand + 1) % dramPages;
+
+        uint32_t page = pageOf[frame];
+        if (pageCount(page) < std::min(hot_count, migrationThreshold) &&
+            outstandingPerPage.find(page) == outstandingPerPage.end()) {
+            return page;
+        }
+    }
+
+    return numPages;
+}
+
+void
+HybridMemCtrl::accessFrame(uint32_t frame, uint8_t* data, bool is_write)
+{
+    Request req(frameAddr(frame), pageSize, 0, masterId);
+    Packet pkt(&req, is_write ? MemCmd::WriteReq : MemCmd::ReadReq);
+    pkt.dataStatic(data);
+    memPort(frameTier(frame)).sendFunctional(&pkt);
+}
+
+void
+HybridMemCtrl::swapPages(uint32_t hot_page, uint32_t cold_page)
+{
+    uint32_t hot_frame = frameOf[hot_page];
+    uint32_t cold_frame = frameOf[cold_page];
+    assert(frameTier(hot_frame) == NVM && frameTier(cold_frame) == DRAM);
+
+    DPRINTF(HybridMem, "Migrating page %d from frame %d to %d, and page %d "
+            "from frame %d to %d\n", hot_page, hot_frame, cold_frame,
+            cold_page, cold_frame, hot_frame);
+
+    // move the data, the requests to the tiers only account for the
+    // time and bandwidth it takes
+    std::vector<uint8_t> hot_data(pageSize);
+    std::vector<uint8_t> cold_data(pageSize);
+    accessFrame(hot_frame, hot_data.data(), false);
+    accessFrame(cold_frame, cold_data.data(), false);
+    accessFrame(cold_frame, hot_data.data(), true);
+    accessFrame(hot_frame, cold_data.data(), true);
+
+    frameOf[hot_page] = cold_frame;
+    frameOf[cold_page] = hot_frame;
+    pageOf[cold_frame] = hot_page;
+    pageOf[hot_frame] = cold_page;
+
+    migrations++;
+    migratedBytes += 2 * pageSize;
+
+    if (system->isTimingMode()) {
+        // read both pages, and write them to their new frame
+        for (Addr offset = 0; offset < pageSize;
+             offset += migrationBurstSize) {
+            Addr hot_addr = frameAddr(hot_frame) + offset;
+            Addr cold_addr = frameAddr(cold_frame) + offset;
+            migrationQueue[NVM].push_back({hot_addr, false});
+            migrationQueue[DRAM].push_back({cold_addr, false});
+            migrationQueue[DRAM].push_back({cold_addr, true});
+            migrationQueue[NVM].push_back({hot_addr, true});
+        }
+    }
+}
+
+void
+HybridMemCtrl::sendMigrationReqs(Tier tier)
+{
+    auto& queue = migrationQueue[tier];
+    while (!memBlocked[tier] && !queue.empty()) {
+        const MigrationReq& mig_req = queue.front();
+
+        RequestPtr req = new Request(mig_req.addr, migrationBurstSize, 0,
+                                     masterId);
+        PacketPtr pkt = new Packet(req, mig_req.isWrite ?
+                                   MemCmd::WriteReq : MemCmd::ReadReq);
+        pkt->allocate();
+
+        if (mig_req.isWrite) {
+            // the data is already in place, so write what is there to
+            // not overwrite any later writes to the page
+            Request rd_req(mig_req.addr, migrationBurstSize, 0, masterId);
+            Packet rd_pkt(&rd_req, MemCmd::ReadReq);
+            rd_pkt.dataStatic(pkt->getPtr<uint8_t>());
+            memPort(tier).sendFunctional(&rd_pkt);
+        }
+
+        if (memPort(tier).sendTimingReq(pkt)) {
+            queue.pop_front();
+            ++outstanding;
+            migrationReqs++;
+        } else {
+            memBlocked[tier] = true;
+            delete req;
+            delete pkt;
+        }
+    }
+}
+
+void
+HybridMemCtrl::processMigrationEvent()
+{
+    // do not start any new migrations while draining
+    if (drainState() == DrainState::Running && !hotPages.empty()) {
+        // consider the hottest pages first
+        std::sort(hotPages.begin(), hotPages.end(),
+                  [this](uint32_t a, uint32_t b)
+                  { return pageCount(a) > pageCount(b); });
+
+        unsigned int migrated = 0;
+        for (auto page : hotPages) {
+            if (migrated == maxMigrations)
+                break;
+
+            if (outstandingPerPage.find(page) != outstandingPerPage.end()) {
+                skippedMigrations++;
+                continue;
+            }
+
+            uint32_t victim = findVictim(pageCount(page));
+            if (victim == numPages) {
+                noVictim++;
+                break;
+            }
+
+            swapPages(page, victim);
+            ++migrated;
+        }
+
+        for (int t = 0; t < NUM_TIERS; ++t)
+            sendMigrationReqs(Tier(t));
+    }
+
+    // start a new interval, implicitly clearing all the counters
+    hotPages.clear();
+    ++interval;
+
+    schedule(migrationEvent, curTick() + migrationInterval);
+}
+
+void
+HybridMemCtrl::checkDrained()
+{
+    if (drainState() == DrainState::Draining && outstanding == 0 &&
+        migrationQueue[DRAM].empty() && migrationQueue[NVM].empty()) {
+        DPRINTF(Drain, "HybridMemCtrl done draining\n");
+        signalDrainDone();
+    }
+}
+
+DrainState
+HybridMemCtrl::drain()
+{
+    if (outstanding != 0 || !migrationQueue[DRAM].empty() ||
+        !migrationQueue[NVM].empty()) {
+        DPRINTF(Drain, "HybridMemCtrl not drained, %d outstanding\n",
+                outstanding);
+        return DrainState::Draining;
+    } else {
+        return DrainState::Drained;
+    }
+}
+
+void
+HybridMemCtrl::serialize(CheckpointOut &cp) const
+{
+    SERIALIZE_CONTAINER(frameOf);
+}
+
+void
+HybridMemCtrl::unserialize(CheckpointIn &cp)
+{
+    UNSERIALIZE_CONTAINER(frameOf);
+
+    fatal_if(frameOf.size() != numPages, "%s checkpoint has %d pages, "
+             "expected %d\n", name(), frameOf.size(), numPages);
+
+    for (uint32_t i = 0; i < numPages; ++i)
+        pageOf[frameOf[i]] = i;
+}
+
+void
+HybridMemCtrl::regStats()
+{
+    using namespace Stats;
+
+    MemObject::regStats();
+
+    tierReads
+        .init(NUM_TIERS)
+        .name(name() + ".tierReads")
+        .desc("Number of reads serviced by each tier");
+
+    tierWrites
+        .init(NUM_TIERS)
+        .name(name() + ".tierWrites")
+        .desc("Number of writes serviced by each tier");
+
+    tierHitRate
+        .name(name() + ".tierHitRate")
+        .desc("Fraction of the accesses serviced by each tier")
+        .precision(4);
+
+    tierHitRate = (tierReads + tierWrites) /
+        (sum(tierReads) + sum(tierWrites));
+
+    for (int t = 0; t < NUM_TIERS; ++t) {
+        const char* tier_name = t == DRAM ? "dram" : "nvm";
+        tierReads.subname(t, tier_name);
+        tierWrites.subname(t, tier_name);
+        tierHitRate.subname(t, tier_name);
+    }
+
+    migrations
+        .name(name() + ".migrations")
+        .desc("Number of hot pages migrated to the DRAM tier");
+
+    migratedBytes
+        .name(name() + ".migratedBytes")
+        .desc("Bytes moved between the tiers by migrations");
+
+    migrationReqs
+        .name(name() + ".migrationReqs")
+        .desc("Number of requests sent to the tiers for migrations");
+
+    skippedMigrations
+        .name(name() + ".skippedMigrations")
+        .desc("Hot pages not migrated due to outstanding requests");
+
+    noVictim
+        .name(name() + ".noVictim")
+        .desc("Intervals where no cold DRAM page was found");
+}
+
+HybridMemCtrl::CpuSidePort::CpuSidePort(const std::string& name,
+                                        HybridMemCtrl& _ctrl)
+    : QueuedSlavePort(name, &_ctrl, queue), queue(_ctrl, *this),
+      ctrl(_ctrl)
+{ }
+
+Tick
+HybridMemCtrl::CpuSidePort::recvAtomic(PacketPtr pkt)
+{
+    return ctrl.recvAtomic(pkt);
+}
+
+void
+HybridMemCtrl::CpuSidePort::recvFunctional(PacketPtr pkt)
+{
+    pkt->pushLabel(ctrl.name());
+
+    if (!queue.checkFunctional(pkt)) {
+        ctrl.recvFunctional(pkt);
+    }
+
+    pkt->popLabel();
+}
+
+bool
+HybridMemCtrl::CpuSidePort::recvTimingReq(PacketPtr pkt)
+{
+    return ctrl.recvTimingReq(pkt);
+}
+
+AddrRangeList
+HybridMemCtrl::CpuSidePort::getAddrRanges() const
+{
+    AddrRangeList ranges;
+    ranges.push_back(ctrl.range);
+    return ranges;
+}
+
+HybridMemCtrl::MemSidePort::MemSidePort(const std::string& name,
+                                        HybridMemCtrl& _ctrl, Tier _tier)
+    : MasterPort(name, &_ctrl), ctrl(_ctrl), tier(_tier)
+{ }
+
+bool
+HybridMemCtrl::MemSidePort::recvTimingResp(PacketPtr pkt)
+{
+    return ctrl.recvTimingResp(pkt, tier);
+}
+
+void
+HybridMemCtrl::MemSidePort::recvReqRetry()
+{
+    ctrl.recvReqRetry(tier);
+}
+
+HybridMemCtrl*
+HybridMemCtrlParams::create()
+{
+    return new HybridMemCtrl(this);
+}
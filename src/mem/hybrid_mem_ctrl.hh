@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * HybridMemCtrl declaration
+ */
+
+#ifndef __MEM_HYBRID_MEM_CTRL_HH__
+#define __MEM_HYBRID_MEM_CTRL_HH__
+
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/mem_object.hh"
+#include "mem/qport.hh"
+#include "params/HybridMemCtrl.hh"
+#include "sim/system.hh"
+
+/**
+ * The hybrid memory controller combines a DRAM tier and an NVM tier
+ * into one flat memory. The range of the controller is divided in
+ * pages, and every page is mapped to a frame in either tier, with the
+ * frames at the start of the range in the DRAM tier. Initially the
+ * pages are mapped to the frame with the same address, and as the
+ * accesses to the NVM tier are counted, pages that are hot within an
+ * interval are migrated to the DRAM tier by swapping them with a cold
+ * DRAM page, found by a clock sweep over the DRAM frames.
+ *
+ * The data of the two pages is swapped functionally when the
+ * migration is decided, and in timing mode the corresponding reads
+ * and writes are then issued to both tiers to account for the
+ * bandwidth consumed by the migration. Pages with outstanding
+ * requests are not migrated, to ensure the requests see the correct
+ * data.
+ */
+class HybridMemCtrl : public MemObject
+{
+
+  public:
+
+    /** The memory tiers, also used to index the master ports */
+    enum Tier {
+        DRAM = 0,
+        NVM,
+        NUM_TIERS
+    };
+
+  private:
+
+    class CpuSidePort : public QueuedSlavePort
+    {
+
+        RespPacketQueue queue;
+        HybridMemCtrl& ctrl;
+
+      public:
+
+        CpuSidePort(const std::string& name, HybridMemCtrl& _ctrl);
+
+      protected:
+
+        Tick recvAtomic(PacketPtr pkt);
+
+        void recvFunctional(PacketPtr pkt);
+
+        bool recvTimingReq(PacketPtr pkt);
+
+        AddrRangeList getAddrRanges() const;
+
+    };
+
+    class MemSidePort : public MasterPort
+    {
+
+        HybridMemCtrl& ctrl;
+        const Tier tier;
+
+      public:
+
+        MemSidePort(const std::string& name, HybridMemCtrl& _ctrl,
+                    Tier _tier);
+
+      protected:
+
+        bool recvTimingResp(PacketPtr pkt);
+
+        void recvReqRetry();
+
+        void recvRangeChange() { }
+
+    };
+
+    /**
+     * Sender state to restore the original address of a request, and
+     * track the outstanding requests of its page.
+     */
+    class HybridSenderState : public Packet::SenderState
+    {
+
+      public:
+
+        HybridSenderState(Addr _origAddr, uint32_t _page)
+            : origAddr(_origAddr), page(_page)
+        { }
+
+        const Addr origAddr;
+        const uint32_t page;
+
+    };
+
+    /**
+     * A pending migration request, with the packet created only once
+     * it is sent, and the data for a write taken from the tier at
+     * that point.
+     */
+    struct MigrationReq
+    {
+        Addr addr;
+        bool isWrite;
+    };
+
+    /**
+     * Access counter of a page, only valid within the interval it was
+     * last updated in.
+     */
+    struct PageCounter
+    {
+        uint32_t count;
+        uint32_t interval;
+    };
+
+    CpuSidePort cpuPort;
+    MemSidePort dramPort;
+    MemSidePort nvmPort;
+
+    System* system;
+    const MasterID masterId;
+
+    const AddrRange range;
+    const Addr pageSize;
+    const uint32_t numPages;
+    const uint32_t dramPages;
+
+    const Tick migrationInterval;
+    const uint32_t migrationThreshold;
+    const unsigned int maxMigrations;
+    const unsigned int migrationBurstSize;
+
+    /** Frame of every page, and the page held by every frame */
+    std::vector<uint32_t> frameOf;
+    std::vector<uint32_t> pageOf;
+
+    /** Access counters of the pages, and the current interval */
+    std::vector<PageCounter> counters;
+    uint32_t interval;
+
+    /** Pages in the NVM tier that became hot in this interval */
+    std::vector<uint32_t> hotPages;
+
+    /** Position of the clock sweep over the DRAM frames */
+    uint32_t victimHand;
+
+    /** Number of outstanding requests per page */
+    std::unordered_map<uint32_t, unsigned int> outstandingPerPage;
+
+    /** Number of outstanding requests, including migration requests */
+    unsigned int outstanding;
+
+    /**
+     * Per tier, remember if it rejected a request and owes us a
+     * retry, and if the requestor is waiting for the tier.
+     */
+    bool memBlocked[NUM_TIERS];
+    bool retryReq[NUM_TIERS];
+
+    /** Migration requests waiting to be sent to each tier */
+    std::deque<MigrationReq> migrationQueue[NUM_TIERS];
+
+    MemSidePort& memPort(Tier tier)
+    { return tier == DRAM ? dramPort : nvmPort; }
+
+    /**
+     * Translate an address to the frame currently holding its page.
+     *
+     * @param addr Address within the range of the controller
+     * @param page Page of the address
+     * @param tier Tier holding the page
+     * @return The translated address
+     */
+    Addr remapAddr(Addr addr, uint32_t& page, Tier& tier) const;
+
+    /**
+     * Get the tier of a frame.
+     */
+    Tier frameTier(uint32_t frame) const
+    { return frame < dramPages ? DRAM : NVM; }
+
+    /**
+     * Get the address of a frame.
+     */
+    Addr frameAddr(uint32_t frame) const
+    { return range.start() + Addr(frame) * pageSize; }
+
+    /**
+     * Get the number of accesses to a page in the current interval.
+     */
+    uint32_t pageCount(uint32_t page) const
+    {
+        return counters[page].interval == interval ?
+            counters[page].count : 0;
+    }
+
+    /**
+     * Count an access to a page, and note it as a migration candidate
+     * if it is an NVM page becoming hot.
+     */
+    void recordAccess(uint32_t page, Tier tier, bool is_read);
+
+    /**
+     * Find a cold DRAM page to swap with a hot page, advancing the
+     * clock sweep.
+     *
+     * @param hot_count Number of accesses to the hot page
+     * @return The cold page, or numPages if there is none
+     */
+    uint32_t findVictim(uint32_t hot_count);
+
+    /**
+     * Swap two pages, moving the data functionally, and queueing the
+     * migration requests in timing mode.
+     */
+    void swapPages(uint32_t hot_page, uint32_t cold_page);
+
+    /**
+     * Functionally read or write an entire frame.
+     */
+    void accessFrame(uint32_t frame, uint8_t* data, bool is_write);
+
+    /**
+     * Send queued migration requests to a tier until it is blocked.
+     */
+    void sendMigrationReqs(Tier tier);
+
+    /**
+     * Decide on the migrations at the end of an interval.
+     */
+    void processMigrationEvent();
+    EventFunctionWrapper migrationEvent;
+
+    /** Signal that we are drained if there is nothing outstanding */
+    void checkDrained();
+
+    Tick recvAtomic(PacketPtr pkt);
+
+    void recvFunctional(PacketPtr pkt);
+
+    bool recvTimingReq(PacketPtr pkt);
+
+    bool recvTimingResp(PacketPtr pkt, Tier tier);
+
+    void recvReqRetry(Tier tier);
+
+    // Statistics
+    Stats::Vector tierReads;
+    Stats::Vector tierWrites;
+    Stats::Formula tierHitRate;
+    Stats::Scalar migrations;
+    Stats::Scalar migratedBytes;
+    Stats::Scalar migrationReqs;
+    Stats::Scalar skippedMigrations;
+    Stats::Scalar noVictim;
+
+  public:
+
+    HybridMemCtrl(const HybridMemCtrlParams* p);
+
+    BaseMasterPort& getMasterPort(const std::string& if_name,
+                                  PortID idx = InvalidPortID) override;
+
+    BaseSlavePort& getSlavePort(const std::string& if_name,
+                                PortID idx = InvalidPortID) override;
+
+    void init() override;
+    void startup() override;
+    void regStats() override;
+
+    DrainState drain() override;
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
+};
+
+#endif //__MEM_HYBRID_MEM_CTRL_HH__
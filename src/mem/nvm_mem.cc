@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/nvm_mem.hh"
+
+#include <algorithm>
+
+#include "base/trace.hh"
+#include "debug/NVM.hh"
+
+using namespace std;
+
+NVMemory::NVMemory(const NVMemoryParams* p) :
+    AbstractMemory(p),
+    port(name() + ".port", *this),
+    readLatency(p->read_latency), writeLatency(p->write_latency),
+    staticLatency(p->static_latency),
+    numBanks(p->banks), bankInterleave(p->bank_interleave),
+    bankFreeAt(p->banks, 0),
+    bandwidth(p->bandwidth), busFreeAt(0),
+    readBufferSize(p->read_buffer_size),
+    writeBufferSize(p->write_buffer_size),
+    enduranceBlockSize(p->endurance_block_size),
+    maxBlockWrites(p->max_block_writes),
+    retryReq(false),
+    retryEvent([this]{ processRetryEvent(); }, name())
+{
+    fatal_if(p->trace_file != "", "%s does not support access "
+             "tracing\n", name());
+    fatal_if(numBanks == 0, "%s needs at least one bank\n", name());
+    fatal_if(bankInterleave == 0 || enduranceBlockSize == 0,
+             "%s needs a non-zero bank interleaving and endurance block "
+             "size\n", name());
+    fatal_if(readBufferSize == 0 || writeBufferSize == 0,
+             "%s needs non-zero read and write buffers\n", name());
+}
+
+void
+NVMemory::init()
+{
+    AbstractMemory::init();
+
+    if (!port.isConnected()) {
+        fatal("NVMemory %s is unconnected!\n", name());
+    } else {
+        port.sendRangeChange();
+    }
+}
+
+Tick
+NVMemory::recvAtomic(PacketPtr pkt)
+{
+    panic_if(pkt->cacheResponding(), "Should not see packets where cache "
+             "is responding");
+
+    access(pkt);
+
+    // not supposed to be accurate, just enough to keep things going
+    return staticLatency + (pkt->isRead() ? readLatency : 0);
+}
+
+void
+NVMemory::recvFunctional(PacketPtr pkt)
+{
+    // rely on the abstract memory
+    functionalAccess(pkt);
+}
+
+bool
+NVMemory::recvTimingReq(PacketPtr pkt)
+{
+    DPRINTF(NVM, "recvTimingReq: request %s addr %#llx size %d\n",
+            pkt->cmdString(), pkt->getAddr(), pkt->getSize());
+
+    panic_if(pkt->cacheResponding(), "Should not see packets where cache "
+             "is responding");
+
+    panic_if(!(pkt->isRead() || pkt->isWrite()),
+             "Should only see read and writes at memory controller, "
+             "saw %s to %#llx\n", pkt->cmdString(), pkt->getAddr());
+
+    retire();
+
+    const bool is_read = pkt->isRead();
+    auto& in_flight = is_read ? readsInFlight : writesInFlight;
+    if (in_flight.size() >= (is_read ? readBufferSize : writeBufferSize)) {
+        DPRINTF(NVM, "%s buffer full, not accepting\n",
+                is_read ? "Read" : "Write");
+        retryReq = true;
+        numRetries++;
+        if (!retryEvent.scheduled()) {
+            schedule(retryEvent, in_flight.top());
+        }
+        return false;
+    }
+
+    // the packet only reaches us after the header delay, and the
+    // payload has to be received before the write can start
+    Tick receive_delay = pkt->headerDelay + pkt->payloadDelay;
+    pkt->headerDelay = pkt->payloadDelay = 0;
+
+    const unsigned int bank = (pkt->getAddr() / bankInterleave) % numBanks;
+    const Tick transfer = pkt->getSize() * bandwidth;
+    const Tick arrival = curTick() + staticLatency;
+    const Tick start = std::max(arrival, bankFreeAt[bank]);
+    totBankWait += start - arrival;
+
+    Tick response_time;
+    if (is_read) {
+        // the data is sent over the interface once read from the media
+        Tick data_at = std::max(start + readLatency, busFreeAt) + transfer;
+        busFreeAt = data_at;
+        bankFreeAt[bank] = start + readLatency;
+        readsInFlight.push(data_at);
+        response_time = data_at + receive_delay;
+
+        readReqs++;
+        bytesRead += pkt->getSize();
+        totReadLat += response_time - curTick();
+    } else {
+        // the data is sent over the interface before the write, and
+        // the write is acknowledged once accepted
+        busFreeAt = std::max(curTick(), busFreeAt) + transfer;
+        bankFreeAt[bank] = std::max(start, busFreeAt) + writeLatency;
+        writesInFlight.push(bankFreeAt[bank]);
+        response_time = arrival + receive_delay;
+
+        writeReqs++;
+        bytesWritten += pkt->getSize();
+
+        // account for the wear of the block
+        uint64_t& writes = blockWrites[pkt->getAddr() / enduranceBlockSize];
+        if (writes == 0)
+            writtenBlocks++;
+        if (++writes > maxWritesPerBlock.value())
+            maxWritesPerBlock = writes;
+        if (writes == maxBlockWrites) {
+            wornBlocks++;
+            warn_once("%s: block at %#llx exceeded its write endurance\n",
+                      name(), pkt->getAddr());
+        }
+    }
+
+    DPRINTF(NVM, "Bank %d busy until %lld, responding at %lld\n", bank,
+            bankFreeAt[bank], response_time);
+
+    // do the actual memory access which also turns the packet into a
+    // response
+    bool needs_response = pkt->needsResponse();
+    access(pkt);
+
+    if (needs_response) {
+        assert(pkt->isResponse());
+        port.schedTimingResp(pkt, response_time);
+    } else {
+        pendingDelete.reset(pkt);
+    }
+
+    return true;
+}
+
+void
+NVMemory::retire()
+{
+    while (!readsInFlight.empty() && readsInFlight.top() <= curTick())
+        readsInFlight.pop();
+    while (!writesInFlight.empty() && writesInFlight.top() <= curTick())
+        writesInFlight.pop();
+}
+
+void
+NVMemory::processRetryEvent()
+{
+    assert(retryReq);
+    retryReq = false;
+    port.sendRetryReq();
+}
+
+DrainState
+NVMemory::drain()
+{
+    // the media state is not relevant once the responses are sent,
+    // and the port takes care of draining its own queue
+    return DrainState::Drained;
+}
+
+BaseSlavePort&
+NVMemory::getSlavePort(const string &if_name, PortID idx)
+{
+    if (if_name != "port") {
+        return MemObject::getSlavePort(if_name, idx);
+    } else {
+        return port;
+    }
+}
+
+void
+NVMemory::regStats()
+{
+    using namespace Stats;
+
+    AbstractMemory::regStats();
+
+    readReqs
+        .name(name() + ".readReqs")
+        .desc("Number of read requests accepted");
+
+    writeReqs
+        .name(name() + ".writeReqs")
+        .desc("Number of write requests accepted");
+
+    bytesRead
+        .name(name() + ".bytesRead")
+        .desc("Total number of bytes read from the media");
+
+    bytesWritten
+        .name(name() + ".bytesWritten")
+        .desc("Total number of bytes written to the media");
+
+    totReadLat
+        .name(name() + ".totReadLat")
+        .desc("Total ticks from accepting a read to its response");
+
+    avgReadLat
+        .name(name() + ".avgReadLat")
+        .desc("Average read latency per request")
+        .precision(2);
+
+    avgReadLat = totReadLat / readReqs;
+
+    totBankWait
+        .name(name() + ".totBankWait")
+        .desc("Total ticks spent waiting for a busy bank");
+
+    numRetries
+        .name(name() + ".numRetries")
+        .desc("Number of times a request was rejected due to full buffers");
+
+    writtenBlocks
+        .name(name() + ".writtenBlocks")
+        .desc("Number of blocks written at least once");
+
+    maxWritesPerBlock
+        .name(name() + ".maxWritesPerBlock")
+        .desc("Largest number of writes to a single block");
+
+    wornBlocks
+        .name(name() + ".wornBlocks")
+        .desc("Number of blocks that exceeded their write endurance");
+}
+
+NVMemory::MemoryPort::MemoryPort(const std::string& name, NVMemory& _memory)
+    : QueuedSlavePort(name, &_memory, queue), queue(_memory, *this),
+      memory(_memory)
+{ }
+
+AddrRangeList
+NVMemory::MemoryPort::getAddrRanges() const
+{
+    AddrRangeList ranges;
+    ranges.push_back(memory.getAddrRange());
+    return ranges;
+}
+
+void
+NVMemory::MemoryPort::recvFunctional(PacketPtr pkt)
+{
+    pkt->pushLabel(memory.name());
+
+    if (!queue.checkFunctional(pkt)) {
+        memory.recvFunctional(pkt);
+    }
+
+    pkt->popLabel();
+}
+
+Tick
+NVMemory::MemoryPort::recvAtomic(PacketPtr pkt)
+{
+    return memory.recvAtomic(pkt);
+}
+
+bool
+NVMemory::MemoryPort::recvTimingReq(PacketPtr pkt)
+{
+    return memory.recvTimingReq(pkt);
+}
+
+NVMemory*
+NVMemoryParams::create()
+{
+    return new NVMemory(this);
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * NVMemory declaration
+ */
+
+#ifndef __MEM_NVM_MEM_HH__
+#define __MEM_NVM_MEM_HH__
+
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/abstract_mem.hh"
+#include "mem/qport.hh"
+#include "params/NVMemory.hh"
+
+/**
+ * The NVMemory is a single-ported model of a byte-addressable
+ * non-volatile memory. Every access is serviced by one of a number of
+ * banks, occupying it for the read or write latency of the media, and
+ * the data is transferred over an interface with a fixed
+ * bandwidth. Writes are acknowledged once accepted, and the number of
+ * outstanding reads and writes is bounded by the buffer sizes. The
+ * writes to every block of the media are counted to track the wear.
+ */
+class NVMemory : public AbstractMemory
+{
+
+  private:
+
+    class MemoryPort : public QueuedSlavePort
+    {
+
+        RespPacketQueue queue;
+        NVMemory& memory;
+
+      public:
+
+        MemoryPort(const std::string& name, NVMemory& _memory);
+
+      protected:
+
+        Tick recvAtomic(PacketPtr pkt);
+
+        void recvFunctional(PacketPtr pkt);
+
+        bool recvTimingReq(PacketPtr pkt);
+
+        AddrRangeList getAddrRanges() const;
+
+    };
+
+    MemoryPort port;
+
+    /**
+     * Latency of a read and a write access to the media.
+     */
+    const Tick readLatency;
+    const Tick writeLatency;
+
+    /**
+     * Static latency of the controller and PHY.
+     */
+    const Tick staticLatency;
+
+    /**
+     * Bank organisation, and the tick at which each bank is free.
+     */
+    const unsigned int numBanks;
+    const Addr bankInterleave;
+    std::vector<Tick> bankFreeAt;
+
+    /**
+     * Interface bandwidth in ticks per byte, and the tick at which
+     * the interface is free.
+     */
+    const double bandwidth;
+    Tick busFreeAt;
+
+    /**
+     * Completion times of the outstanding reads and writes, bounded
+     * by the buffer sizes.
+     */
+    const unsigned int readBufferSize;
+    const unsigned int writeBufferSize;
+    std::priority_queue<Tick, std::vector<Tick>,
+                        std::greater<Tick>> readsInFlight;
+    std::priority_queue<Tick, std::vector<Tick>,
+                        std::greater<Tick>> writesInFlight;
+
+    /**
+     * Write endurance accounting, with the number of writes to each
+     * block that has been written at least once.
+     */
+    const Addr enduranceBlockSize;
+    const uint64_t maxBlockWrites;
+    std::unordered_map<Addr, uint64_t> blockWrites;
+
+    /**
+     * Remember if we have to retry a request when available.
+     */
+    bool retryReq;
+
+    /**
+     * Retire the reads and writes that are complete at the current
+     * tick.
+     */
+    void retire();
+
+    /**
+     * Let the requestor retry once outstanding requests complete.
+     */
+    void processRetryEvent();
+    EventFunctionWrapper retryEvent;
+
+    /**
+     * Upstream caches need this packet until true is returned, so
+     * hold it for deletion until a subsequent call
+     */
+    std::unique_ptr<Packet> pendingDelete;
+
+    // All statistics that the model needs to capture
+    Stats::Scalar readReqs;
+    Stats::Scalar writeReqs;
+    Stats::Scalar bytesRead;
+    Stats::Scalar bytesWritten;
+    Stats::Scalar totReadLat;
+    Stats::Formula avgReadLat;
+    Stats::Scalar totBankWait;
+    Stats::Scalar numRetries;
+    Stats::Scalar writtenBlocks;
+    Stats::Scalar maxWritesPerBlock;
+    Stats::Scalar wornBlocks;
+
+  public:
+
+    NVMemory(const NVMemoryParams* p);
+
+    DrainState drain() override;
+
+    BaseSlavePort& getSlavePort(const std::string& if_name,
+                                PortID idx = InvalidPortID) override;
+    void init() override;
+    void regStats() override;
+
+  protected:
+
+    Tick recvAtomic(PacketPtr pkt);
+
+    void recvFunctional(PacketPtr pkt);
+
+    bool recvTimingReq(PacketPtr pkt);
+
+};
+
+#endif //__MEM_NVM_MEM_HH__
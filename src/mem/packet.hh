@@ -306,7 +306,11 @@ class Packet : public Printable
 
         // Signal block present to squash prefetch and cache evict packets
         // through express snoop flag
-        BLOCK_CACHED          = 0x00010000
+        BLOCK_CACHED          = 0x00010000,
+
+        // Snoop sent by a bounded snoop filter to remove a line it
+        // no longer tracks from the caches above
+        BACK_INVALIDATION      = 0x00020000
     };
 
     Flags flags;
@@ -620,6 +624,15 @@ class Packet : public Printable
     void setExpressSnoop()      { flags.set(EXPRESS_SNOOP); }
     bool isExpressSnoop() const { return flags.isSet(EXPRESS_SNOOP); }
 
+    /**
+     * Back-invalidations are cache maintenance snoops that a bounded
+     * snoop filter sends to the caches above to drop a line it
+     * replaced. Caches do not respond to them, and leave the data of
+     * a queued writeback to go down.
+     */
+    void setBackInvalidation()      { flags.set(BACK_INVALIDATION); }
+    bool isBackInvalidation() const { return flags.isSet(BACK_INVALIDATION); }
+
     /**
      * On responding to a snoop request (which only happens for
      * Modified or Owned lines), make sure that we can transform an
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_COMMON_ADDRHASHMAP_HH__
+#define __MEM_RUBY_COMMON_ADDRHASHMAP_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/types.hh"
+
+/**
+ * An open-addressed hash map keyed by addresses, for Ruby's address
+ * indexed structures. The slots live in a single array and collisions
+ * are resolved by linear probing, so a lookup touches one or two cache
+ * lines instead of chasing a bucket list. Erasing shifts the following
+ * entries of the probe sequence back instead of leaving tombstones.
+ *
+ * The interface is a subset of std::unordered_map. Unlike it, any
+ * insertion or erasure invalidates all iterators and references to the
+ * values, and the iteration order is unspecified.
+ */
+template <class T>
+class AddrHashMap
+{
+  public:
+    typedef Addr key_type;
+    typedef T mapped_type;
+    typedef std::pair<Addr, T> value_type;
+    typedef size_t size_type;
+
+  private:
+    struct Slot
+    {
+        Slot() : used(false) {}
+
+        value_type kv;
+        bool used;
+    };
+
+    template <class SlotPtr, class Value>
+    class Iterator
+    {
+      public:
+        Iterator() : slot(nullptr), last(nullptr) {}
+        Iterator(SlotPtr _slot, SlotPtr _last)
+            : slot(_slot), last(_last)
+        {
+            skipUnused();
+        }
+
+        template <class OtherPtr, class OtherValue>
+        Iterator(const Iterator<OtherPtr, OtherValue> &other)
+            : slot(other.slot), last(other.last)
+        {}
+
+        Value &operator*() const { return slot->kv; }
+        Value *operator->() const { return &slot->kv; }
+
+        Iterator &
+        operator++()
+        {
+            ++slot;
+            skipUnused();
+            return *this;
+        }
+
+        bool operator==(const Iterator &o) const { return slot == o.slot; }
+        bool operator!=(const Iterator &o) const { return slot != o.slot; }
+
+      private:
+        friend class AddrHashMap;
+        template <class, class> friend class Iterator;
+
+        void
+        skipUnused()
+        {
+            while (slot != last && !slot->used)
+                ++slot;
+        }
+
+        SlotPtr slot;
+        SlotPtr last;
+    };
+
+  public:
+    typedef Iterator<Slot *, value_type> iterator;
+    typedef Iterator<const Slot *, const value_type> const_iterator;
+
+    AddrHashMap() : m_size(0), m_mask(0), m_shift(0) { rehash(minSlots); }
+
+    /** Size the table for n entries without growing. */
+    explicit AddrHashMap(size_type n) : AddrHashMap() { reserve(n); }
+
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    iterator begin() { return iterator(firstSlot(), lastSlot()); }
+    iterator end() { return iterator(lastSlot(), lastSlot()); }
+    const_iterator begin() const
+    { return const_iterator(firstSlot(), lastSlot()); }
+    const_iterator end() const
+    { return const_iterator(lastSlot(), lastSlot()); }
+
+    iterator
+    find(Addr key)
+    {
+        size_t idx = probe(key);
+        Slot *slot = m_slots[idx].used ? &m_slots[idx] : lastSlot();
+        return iterator(slot, lastSlot());
+    }
+
+    const_iterator
+    find(Addr key) const
+    {
+        size_t idx = probe(key);
+        const Slot *slot = m_slots[idx].used ? &m_slots[idx] : lastSlot();
+        return const_iterator(slot, lastSlot());
+    }
+
+    size_type count(Addr key) const { return m_slots[probe(key)].used; }
+
+    std::pair<iterator, bool>
+    insert(const value_type &kv)
+    {
+        size_t idx = probe(kv.first);
+        bool inserted = !m_slots[idx].used;
+        if (inserted)
+            idx = claim(idx, kv);
+        return std::make_pair(iterator(&m_slots[idx], lastSlot()), inserted);
+    }
+
+    T &
+    operator[](Addr key)
+    {
+        size_t idx = probe(key);
+        if (!m_slots[idx].used)
+            idx = claim(idx, value_type(key, T()));
+        return m_slots[idx].kv.second;
+    }
+
+    size_type
+    erase(Addr key)
+    {
+        size_t idx = probe(key);
+        if (!m_slots[idx].used)
+            return 0;
+        eraseSlot(idx);
+        return 1;
+    }
+
+    void erase(iterator it) { eraseSlot(it.slot - firstSlot()); }
+
+    void
+    clear()
+    {
+        for (auto &slot : m_slots)
+            slot = Slot();
+        m_size = 0;
+    }
+
+    /** Grow the table so that n entries fit without rehashing. */
+    void
+    reserve(size_type n)
+    {
+        size_t slots = minSlots;
+        while (slots * maxLoadNum < n * maxLoadDen)
+            slots *= 2;
+        if (slots > m_slots.size())
+            rehash(slots);
+    }
+
+  private:
+    // Keep the load factor at or below 1/2 so probe sequences stay short
+    static const size_t maxLoadNum = 1;
+    static const size_t maxLoadDen = 2;
+    static const size_t minSlots = 8;
+
+    Slot *firstSlot() { return m_slots.data(); }
+    Slot *lastSlot() { return m_slots.data() + m_slots.size(); }
+    const Slot *firstSlot() const { return m_slots.data(); }
+    const Slot *lastSlot() const { return m_slots.data() + m_slots.size(); }
+
+    /**
+     * Line addresses have their low bits clear, so spread every key bit
+     * into the top bits with a multiplicative hash and use those.
+     */
+    size_t
+    home(Addr key) const
+    {
+        return (key * 0x9e3779b97f4a7c15ULL) >> m_shift;
+    }
+
+    /** The slot holding key, or the empty slot where it would go. */
+    size_t
+    probe(Addr key) const
+    {
+        size_t idx = home(key);
+        while (m_slots[idx].used && m_slots[idx].kv.first != key)
+            idx = (idx + 1) & m_mask;
+        return idx;
+    }
+
+    size_t
+    claim(size_t idx, const value_type &kv)
+    {
+        if ((m_size + 1) * maxLoadDen > m_slots.size() * maxLoadNum) {
+            rehash(m_slots.size() * 2);
+            idx = probe(kv.first);
+        }
+        m_slots[idx].kv = kv;
+        m_slots[idx].used = true;
+        ++m_size;
+        return idx;
+    }
+
+    void
+    eraseSlot(size_t hole)
+    {
+        assert(m_slots[hole].used);
+        // Move back any later entry of the probe run whose home slot is
+        // not cyclically between the hole and its current position.
+        size_t idx = hole;
+        while (true) {
+            idx = (idx + 1) & m_mask;
+            if (!m_slots[idx].used)
+                break;
+            size_t h = home(m_slots[idx].kv.first);
+            if (((idx - h) & m_mask) >= ((idx - hole) & m_mask)) {
+                m_slots[hole] = std::move(m_slots[idx]);
+                hole = idx;
+            }
+        }
+        m_slots[hole] = Slot();
+        --m_size;
+    }
+
+    void
+    rehash(size_t slots)
+    {
+        assert(isPowerOf2(slots));
+        std::vector<Slot> old;
+        old.swap(m_slots);
+        m_slots.resize(slots);
+        m_mask = slots - 1;
+        m_shift = 64 - floorLog2(slots);
+
+        for (auto &slot : old) {
+            if (!slot.used)
+                continue;
+            size_t idx = probe(slot.kv.first);
+            m_slots[idx] = std::move(slot);
+        }
+    }
+
+    std::vector<Slot> m_slots;
+    size_type m_size;
+    size_t m_mask;
+    int m_shift;
+};
+
+#endif // __MEM_RUBY_COMMON_ADDRHASHMAP_HH__
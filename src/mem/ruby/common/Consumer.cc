@@ -30,6 +30,35 @@
 
 using namespace std;
 
+Consumer::~Consumer()
+{
+    for (auto *evt : m_wakeup_events) {
+        if (evt->scheduled())
+            em->deschedule(evt);
+        delete evt;
+    }
+}
+
+void
+Consumer::WakeupEvent::process()
+{
+    consumer->m_free_wakeup_events.push_back(this);
+    consumer->wakeup();
+}
+
+Consumer::WakeupEvent *
+Consumer::allocateWakeupEvent()
+{
+    if (m_free_wakeup_events.empty()) {
+        m_wakeup_events.push_back(new WakeupEvent(this));
+        return m_wakeup_events.back();
+    }
+
+    WakeupEvent *evt = m_free_wakeup_events.back();
+    m_free_wakeup_events.pop_back();
+    return evt;
+}
+
 void
 Consumer::scheduleEvent(Cycles timeDelta)
 {
@@ -41,15 +70,26 @@ Consumer::scheduleEventAbsolute(Tick evt_time)
 {
     if (!alreadyScheduled(evt_time)) {
         // This wakeup is not redundant
-        auto *evt = new EventFunctionWrapper(
-            [this]{ wakeup(); }, "Consumer Event", true);
-
-        em->schedule(evt, evt_time);
+        em->schedule(allocateWakeupEvent(), evt_time);
         insertScheduledWakeupTime(evt_time);
     }
 
+    // Forget the wakeups that are in the past
     Tick t = em->clockEdge();
-    set<Tick>::iterator bit = m_scheduled_wakeups.begin();
-    set<Tick>::iterator eit = m_scheduled_wakeups.lower_bound(t);
-    m_scheduled_wakeups.erase(bit,eit);
+    auto eit = lower_bound(m_scheduled_wakeups.begin(),
+                           m_scheduled_wakeups.end(), t);
+    m_scheduled_wakeups.erase(m_scheduled_wakeups.begin(), eit);
+}
+
+void
+Consumer::scheduleRemoteEvent(Tick evt_time)
+{
+    // The set of scheduled wakeups belongs to the consumer's own
+    // thread, so hand the wakeup over as an asynchronous event that
+    // schedules it locally once it is due
+    auto *evt = new EventFunctionWrapper(
+        [this, evt_time]{ scheduleEventAbsolute(evt_time); },
+        "Consumer Remote Event", true);
+
+    em->eventQueue()->schedule(evt, evt_time, true);
 }
@@ -35,8 +35,9 @@
 #ifndef __MEM_RUBY_COMMON_CONSUMER_HH__
 #define __MEM_RUBY_COMMON_CONSUMER_HH__
 
+#include <algorithm>
 #include <iostream>
-#include <set>
+#include <vector>
 
 #include "sim/clocked_object.hh"
 
@@ -48,9 +49,7 @@ class Consumer
     {
     }
 
-    virtual
-    ~Consumer()
-    { }
+    virtual ~Consumer();
 
     virtual void wakeup() = 0;
     virtual void print(std::ostream& out) const = 0;
@@ -59,22 +58,55 @@ class Consumer
     bool
     alreadyScheduled(Tick time)
     {
-        return m_scheduled_wakeups.find(time) != m_scheduled_wakeups.end();
+        return std::binary_search(m_scheduled_wakeups.begin(),
+                                  m_scheduled_wakeups.end(), time);
     }
 
     void
     insertScheduledWakeupTime(Tick time)
     {
-        m_scheduled_wakeups.insert(time);
+        auto it = std::lower_bound(m_scheduled_wakeups.begin(),
+                                   m_scheduled_wakeups.end(), time);
+        if (it == m_scheduled_wakeups.end() || *it != time)
+            m_scheduled_wakeups.insert(it, time);
     }
 
     void scheduleEventAbsolute(Tick timeAbs);
 
+    // Schedule a wakeup from a thread running another event queue.
+    // The time must be at least one simulation quantum ahead.
+    void scheduleRemoteEvent(Tick timeAbs);
+
+    EventQueue *wakeupEventQueue() const { return em->eventQueue(); }
+
   protected:
     void scheduleEvent(Cycles timeDelta);
 
   private:
-    std::set<Tick> m_scheduled_wakeups;
+    /**
+     * Wakeup events are recycled rather than allocated for every
+     * wakeup. An event goes back to the free list as it is processed.
+     */
+    class WakeupEvent : public Event
+    {
+      public:
+        WakeupEvent(Consumer *_consumer) : consumer(_consumer) {}
+
+        void process() override;
+        const char *description() const override { return "Consumer Event"; }
+
+      private:
+        Consumer *consumer;
+    };
+
+    WakeupEvent *allocateWakeupEvent();
+
+    // Pending wakeup times in ascending order. There are only ever a
+    // few, so a sorted vector beats a tree, and it keeps its capacity
+    // once warmed up.
+    std::vector<Tick> m_scheduled_wakeups;
+    std::vector<WakeupEvent *> m_wakeup_events;
+    std::vector<WakeupEvent *> m_free_wakeup_events;
     ClockedObject *em;
 };
 
@@ -26,28 +26,30 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+
 #include "mem/ruby/common/NetDest.hh"
 
 #include <algorithm>
 
+#include "base/bitfield.hh"
+
 NetDest::NetDest()
 {
-  resize();
+    clear();
 }
 
 void
 NetDest::add(MachineID newElement)
 {
-    assert(bitIndex(newElement.num) < m_bits[vecIndex(newElement)].getSize());
-    m_bits[vecIndex(newElement)].add(bitIndex(newElement.num));
+    int index = bitIndex(newElement);
+    m_bits[index / BITS_PER_WORD] |= 1ULL << (index % BITS_PER_WORD);
 }
 
 void
 NetDest::addNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].addSet(netDest.m_bits[i]);
+    for (int i = 0; i < NUM_WORDS; i++) {
+        m_bits[i] |= netDest.m_bits[i];
     }
 }
 
@@ -57,30 +59,34 @@ NetDest::setNetDest(MachineType machine, const Set& set)
     // assure that there is only one set of destinations for this machine
     assert(MachineType_base_level((MachineType)(machine + 1)) -
            MachineType_base_level(machine) == 1);
-    m_bits[MachineType_base_level(machine)] = set;
+    for (NodeID i = 0; i < MachineType_base_count(machine); i++) {
+        MachineID mach = {machine, i};
+        if (set.isElement(i))
+            add(mach);
+        else
+            remove(mach);
+    }
 }
 
 void
 NetDest::remove(MachineID oldElement)
 {
-    m_bits[vecIndex(oldElement)].remove(bitIndex(oldElement.num));
+    int index = bitIndex(oldElement);
+    m_bits[index / BITS_PER_WORD] &= ~(1ULL << (index % BITS_PER_WORD));
 }
 
 void
 NetDest::removeNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].removeSet(netDest.m_bits[i]);
+    for (int i = 0; i < NUM_WORDS; i++) {
+        m_bits[i] &= ~netDest.m_bits[i];
     }
 }
 
 void
 NetDest::clear()
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].clear();
-    }
+    std::fill(m_bits, m_bits + NUM_WORDS, 0);
 }
 
 void
@@ -106,13 +112,9 @@ std::vector<NodeID>
 NetDest::getAllDest()
 {
     std::vector<NodeID> dest;
-    dest.clear();
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (int j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                int id = MachineType_base_number((MachineType)i) + j;
-                dest.push_back((NodeID)id);
-            }
+    for (int i = 0; i < NUM_WORDS; i++) {
+        for (uint64_t word = m_bits[i]; word; word &= word - 1) {
+            dest.push_back(i * BITS_PER_WORD + findLsbSet(word));
         }
     }
     return dest;
@@ -122,8 +124,8 @@ int
 NetDest::count() const
 {
     int counter = 0;
-    for (int i = 0; i < m_bits.size(); i++) {
-        counter += m_bits[i].count();
+    for (int i = 0; i < NUM_WORDS; i++) {
+        counter += popCount(m_bits[i]);
     }
     return counter;
 }
@@ -131,19 +133,30 @@ NetDest::count() const
 NodeID
 NetDest::elementAt(MachineID index)
 {
-    return m_bits[vecIndex(index)].elementAt(bitIndex(index.num));
+    return testBit(bitIndex(index));
+}
+
+MachineID
+NetDest::machineAt(int bit_index) const
+{
+    for (int i = 0; i < MachineType_NUM; i++) {
+        MachineType machine = MachineType_from_base_level(i);
+        int base = MachineType_base_number(machine);
+        if (bit_index < base + MachineType_base_count(machine)) {
+            MachineID mach = {machine, NodeID(bit_index - base)};
+            return mach;
+        }
+    }
+    panic("No machine with network node number %d.", bit_index);
 }
 
 MachineID
 NetDest::smallestElement() const
 {
     assert(count() > 0);
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (NodeID j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                MachineID mach = {MachineType_from_base_level(i), j};
-                return mach;
-            }
+    for (int i = 0; i < NUM_WORDS; i++) {
+        if (m_bits[i]) {
+            return machineAt(i * BITS_PER_WORD + findLsbSet(m_bits[i]));
         }
     }
     panic("No smallest element of an empty set.");
@@ -152,9 +165,10 @@ NetDest::smallestElement() const
 MachineID
 NetDest::smallestElement(MachineType machine) const
 {
-    int size = m_bits[MachineType_base_level(machine)].getSize();
+    int base = MachineType_base_number(machine);
+    int size = MachineType_base_count(machine);
     for (NodeID j = 0; j < size; j++) {
-        if (m_bits[MachineType_base_level(machine)].isElement(j)) {
+        if (testBit(base + j)) {
             MachineID mach = {machine, j};
             return mach;
         }
@@ -167,35 +181,27 @@ NetDest::smallestElement(MachineType machine) const
 bool
 NetDest::isBroadcast() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isBroadcast()) {
-            return false;
-        }
-    }
-    return true;
+    // Only bits of existing machines are ever set
+    return count() == MachineType_base_number(MachineType_NUM);
 }
 
 // Returns true iff no bits are set
 bool
 NetDest::isEmpty() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isEmpty()) {
-            return false;
-        }
+    uint64_t any = 0;
+    for (int i = 0; i < NUM_WORDS; i++) {
+        any |= m_bits[i];
     }
-    return true;
+    return !any;
 }
 
 // returns the logical OR of "this" set and orNetDest
 NetDest
 NetDest::OR(const NetDest& orNetDest) const
 {
-    assert(m_bits.size() == orNetDest.getSize());
-    NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
-        result.m_bits[i] = m_bits[i].OR(orNetDest.m_bits[i]);
-    }
+    NetDest result(*this);
+    result.addNetDest(orNetDest);
     return result;
 }
 
@@ -203,10 +209,9 @@ NetDest::OR(const NetDest& orNetDest) const
 NetDest
 NetDest::AND(const NetDest& andNetDest) const
 {
-    assert(m_bits.size() == andNetDest.getSize());
     NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
-        result.m_bits[i] = m_bits[i].AND(andNetDest.m_bits[i]);
+    for (int i = 0; i < NUM_WORDS; i++) {
+        result.m_bits[i] = m_bits[i] & andNetDest.m_bits[i];
     }
     return result;
 }
@@ -215,53 +220,39 @@ NetDest::AND(const NetDest& andNetDest) const
 bool
 NetDest::intersectionIsNotEmpty(const NetDest& other_netDest) const
 {
-    assert(m_bits.size() == other_netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].intersectionIsEmpty(other_netDest.m_bits[i])) {
-            return true;
-        }
+    uint64_t any = 0;
+    for (int i = 0; i < NUM_WORDS; i++) {
+        any |= m_bits[i] & other_netDest.m_bits[i];
     }
-    return false;
+    return any;
 }
 
 bool
 NetDest::isSuperset(const NetDest& test) const
 {
-    assert(m_bits.size() == test.getSize());
-
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isSuperset(test.m_bits[i])) {
-            return false;
-        }
+    uint64_t missing = 0;
+    for (int i = 0; i < NUM_WORDS; i++) {
+        missing |= test.m_bits[i] & ~m_bits[i];
     }
-    return true;
+    return !missing;
 }
 
 bool
 NetDest::isElement(MachineID element) const
 {
-    return ((m_bits[vecIndex(element)])).isElement(bitIndex(element.num));
-}
-
-void
-NetDest::resize()
-{
-    m_bits.resize(MachineType_base_level(MachineType_NUM));
-    assert(m_bits.size() == MachineType_NUM);
-
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].setSize(MachineType_base_count((MachineType)i));
-    }
+    return testBit(bitIndex(element));
 }
 
 void
 NetDest::print(std::ostream& out) const
 {
-    out << "[NetDest (" << m_bits.size() << ") ";
+    out << "[NetDest (" << int(MachineType_NUM) << ") ";
 
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (int j = 0; j < m_bits[i].getSize(); j++) {
-            out << (bool) m_bits[i].isElement(j) << " ";
+    for (int i = 0; i < MachineType_NUM; i++) {
+        MachineType machine = MachineType_from_base_level(i);
+        int base = MachineType_base_number(machine);
+        for (int j = 0; j < MachineType_base_count(machine); j++) {
+            out << testBit(base + j) << " ";
         }
         out << " - ";
     }
@@ -271,10 +262,5 @@ NetDest::print(std::ostream& out) const
 bool
 NetDest::isEqual(const NetDest& n) const
 {
-    assert(m_bits.size() == n.m_bits.size());
-    for (unsigned int i = 0; i < m_bits.size(); ++i) {
-        if (!m_bits[i].isEqual(n.m_bits[i]))
-            return false;
-    }
-    return true;
+    return std::equal(m_bits, m_bits + NUM_WORDS, n.m_bits);
 }
@@ -29,6 +29,8 @@
 #ifndef __MEM_RUBY_COMMON_NETDEST_HH__
 #define __MEM_RUBY_COMMON_NETDEST_HH__
 
+#include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
@@ -36,9 +38,21 @@
 #include "mem/ruby/common/MachineID.hh"
 
 // NetDest specifies the network destination of a Message
+//
+// The destinations are kept in a single fixed-size bit vector indexed by
+// the network node number of each machine, so a NetDest lives inline in
+// its message and copying one never allocates. The set operations work
+// a whole word at a time over the fixed number of words, which the
+// compiler turns into vector instructions.
 class NetDest
 {
   public:
+    // The number of machines, of all types, a NetDest can name. It is
+    // what one Set per machine type used to hold, capped at 1024.
+    static const int MAX_NODES =
+        MachineType_NUM * NUMBER_BITS_PER_SET < 1024 ?
+        MachineType_NUM * NUMBER_BITS_PER_SET : 1024;
+
     // Constructors
     // creates and empty set
     NetDest();
@@ -84,28 +98,37 @@ class NetDest
     MachineID smallestElement() const;
     MachineID smallestElement(MachineType machine) const;
 
-    void resize();
-    int getSize() const { return m_bits.size(); }
-
     // get element for a index
     NodeID elementAt(MachineID index);
 
     void print(std::ostream& out) const;
 
   private:
-    // returns a value >= MachineType_base_level("this machine")
-    // and < MachineType_base_level("next highest machine")
+    static const int BITS_PER_WORD = 64;
+    static const int NUM_WORDS =
+        (MAX_NODES + BITS_PER_WORD - 1) / BITS_PER_WORD;
+
+    // returns the network node number of machine m
     int
-    vecIndex(MachineID m) const
+    bitIndex(MachineID m) const
     {
-        int vec_index = MachineType_base_level(m.type);
-        assert(vec_index < m_bits.size());
-        return vec_index;
+        int bit_index = MachineType_base_number(m.type) + m.num;
+        assert(m.num < MachineType_base_count(m.type));
+        assert(bit_index < MAX_NODES);
+        return bit_index;
     }
 
-    NodeID bitIndex(NodeID index) const { return index; }
+    // returns the machine with network node number bit_index
+    MachineID machineAt(int bit_index) const;
+
+    bool
+    testBit(int bit_index) const
+    {
+        return (m_bits[bit_index / BITS_PER_WORD] >>
+                (bit_index % BITS_PER_WORD)) & 1;
+    }
 
-    std::vector<Set> m_bits;  // a vector of bit vectors - i.e. Sets
+    uint64_t m_bits[NUM_WORDS];
 };
 
 inline std::ostream&
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/common/SharerSet.hh"
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+const int SharerSet::MAX_POINTERS;
+const int SharerSet::COARSE_BITS;
+
+int SharerSet::s_num_pointers = SharerSet::MAX_POINTERS;
+bool SharerSet::s_num_pointers_set = false;
+
+SharerSet::SharerSet()
+    : m_type(MachineType_NULL), m_num_pointers(0), m_coarse(false),
+      m_vector(0)
+{
+}
+
+void
+SharerSet::setNumPointers(int num_pointers)
+{
+    fatal_if(num_pointers < 1 || num_pointers > MAX_POINTERS,
+             "A sharer set keeps between 1 and %d pointers, not %d.\n",
+             MAX_POINTERS, num_pointers);
+    fatal_if(s_num_pointers_set && num_pointers != s_num_pointers,
+             "Sharer sets keep %d pointers, they cannot also keep %d. All "
+             "directories must use the same number of sharer pointers.\n",
+             s_num_pointers, num_pointers);
+    s_num_pointers = num_pointers;
+    s_num_pointers_set = true;
+}
+
+int
+SharerSet::nodesPerBit() const
+{
+    return divCeil(MachineType_base_count(m_type), COARSE_BITS);
+}
+
+void
+SharerSet::add(MachineID sharer)
+{
+    if (isEmpty())
+        m_type = sharer.type;
+    panic_if(sharer.type != m_type,
+             "Sharer %s is not of type %s like the others.\n",
+             MachineIDToString(sharer), MachineType_to_string(m_type));
+
+    if (m_coarse) {
+        m_vector |= 1ULL << (sharer.num / nodesPerBit());
+        return;
+    }
+
+    for (int i = 0; i < m_num_pointers; i++) {
+        if (m_pointers[i] == sharer.num)
+            return;
+    }
+
+    if (m_num_pointers < s_num_pointers) {
+        m_pointers[m_num_pointers++] = sharer.num;
+        return;
+    }
+
+    // Out of pointers, so switch to the coarse vector
+    m_coarse = true;
+    m_vector = 0;
+    int nodes_per_bit = nodesPerBit();
+    for (int i = 0; i < m_num_pointers; i++)
+        m_vector |= 1ULL << (m_pointers[i] / nodes_per_bit);
+    m_vector |= 1ULL << (sharer.num / nodes_per_bit);
+    m_num_pointers = 0;
+}
+
+void
+SharerSet::remove(MachineID sharer)
+{
+    if (m_coarse || sharer.type != m_type)
+        return;
+
+    for (int i = 0; i < m_num_pointers; i++) {
+        if (m_pointers[i] == sharer.num) {
+            m_pointers[i] = m_pointers[--m_num_pointers];
+            return;
+        }
+    }
+}
+
+void
+SharerSet::clear()
+{
+    m_type = MachineType_NULL;
+    m_num_pointers = 0;
+    m_coarse = false;
+    m_vector = 0;
+}
+
+bool
+SharerSet::isElement(MachineID sharer) const
+{
+    if (isEmpty() || sharer.type != m_type)
+        return false;
+
+    if (m_coarse)
+        return (m_vector >> (sharer.num / nodesPerBit())) & 1;
+
+    for (int i = 0; i < m_num_pointers; i++) {
+        if (m_pointers[i] == sharer.num)
+            return true;
+    }
+    return false;
+}
+
+bool
+SharerSet::isEmpty() const
+{
+    return m_coarse ? m_vector == 0 : m_num_pointers == 0;
+}
+
+int
+SharerSet::count() const
+{
+    return m_coarse ? getDestinations().count() : m_num_pointers;
+}
+
+NetDest
+SharerSet::getDestinations() const
+{
+    NetDest dest;
+    if (!m_coarse) {
+        for (int i = 0; i < m_num_pointers; i++)
+            dest.add(MachineID(m_type, m_pointers[i]));
+        return dest;
+    }
+
+    int nodes_per_bit = nodesPerBit();
+    NodeID num_nodes = MachineType_base_count(m_type);
+    for (uint64_t bits = m_vector; bits; bits &= bits - 1) {
+        NodeID first = findLsbSet(bits) * nodes_per_bit;
+        for (NodeID num = first;
+             num < first + nodes_per_bit && num < num_nodes; num++) {
+            dest.add(MachineID(m_type, num));
+        }
+    }
+    return dest;
+}
+
+void
+SharerSet::print(std::ostream& out) const
+{
+    out << "[SharerSet " << (m_coarse ? "coarse " : "") << getDestinations()
+        << "]";
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_COMMON_SHARERSET_HH__
+#define __MEM_RUBY_COMMON_SHARERSET_HH__
+
+#include <cstdint>
+#include <iostream>
+
+#include "mem/ruby/common/MachineID.hh"
+#include "mem/ruby/common/NetDest.hh"
+
+/**
+ * A compact record of the sharers of a line, for directories that track
+ * many caches. Up to a configurable number of sharers are kept exactly,
+ * as limited pointers. Once more sharers are added, the set turns into a
+ * coarse vector in which each bit stands for a group of neighbouring
+ * machines, and it then over-approximates the real sharers.
+ *
+ * All sharers of a set must be machines of a single type, which is the
+ * case for a directory that tracks one level of caches.
+ */
+class SharerSet
+{
+  public:
+    /** Upper bound on the number of exact sharer pointers. */
+    static const int MAX_POINTERS = 8;
+    /** Number of bits in the coarse vector. */
+    static const int COARSE_BITS = 64;
+
+    SharerSet();
+
+    void add(MachineID sharer);
+    /**
+     * Removing a sharer from a coarse set has no effect, since its bit
+     * may cover other sharers as well.
+     */
+    void remove(MachineID sharer);
+    void clear();
+
+    /** True if sharer is, or in a coarse set may be, a sharer. */
+    bool isElement(MachineID sharer) const;
+    bool isEmpty() const;
+    bool isCoarse() const { return m_coarse; }
+
+    /** Number of machines getDestinations() returns. */
+    int count() const;
+
+    /**
+     * The machines that have to be reached to reach all sharers, e.g.
+     * for invalidations. This is a superset of the sharers once the set
+     * has turned coarse.
+     */
+    NetDest getDestinations() const;
+
+    void print(std::ostream& out) const;
+
+    /**
+     * Set how many sharers are kept exactly before a set turns coarse.
+     * The setting is shared by all sharer sets, so every directory that
+     * sets it has to ask for the same number.
+     */
+    static void setNumPointers(int num_pointers);
+
+  private:
+    // Number of machines each bit of the coarse vector stands for
+    int nodesPerBit() const;
+
+    static int s_num_pointers;
+    static bool s_num_pointers_set;
+
+    MachineType m_type;
+    uint16_t m_pointers[MAX_POINTERS];
+    uint8_t m_num_pointers;
+    bool m_coarse;
+    uint64_t m_vector;
+};
+
+inline std::ostream&
+operator<<(std::ostream& out, const SharerSet& obj)
+{
+    obj.print(out);
+    out << std::flush;
+    return out;
+}
+
+#endif // __MEM_RUBY_COMMON_SHARERSET_HH__
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest-spi.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "mem/ruby/common/NetDest.hh"
+#include "mem/ruby/common/SharerSet.hh"
+
+// SharerSet and NetDest size themselves with the functions generated for
+// the protocol's MachineType, which count the controllers of a running
+// system. Stand in for them with a system of 100 caches and a
+// directory, so that each bit of a coarse vector covers two caches.
+// The machine types are named differently by every protocol, so the
+// first one plays the caches and the second one the directory.
+
+namespace {
+
+const MachineType cacheType = MachineType_FIRST;
+const MachineType dirType = MachineType(MachineType_FIRST + 1);
+const int numCaches = 100;
+
+} // anonymous namespace
+
+int
+MachineType_base_count(const MachineType& obj)
+{
+    if (obj == cacheType)
+        return numCaches;
+    if (obj == dirType)
+        return 1;
+    return 0;
+}
+
+int
+MachineType_base_number(const MachineType& obj)
+{
+    int base = 0;
+    for (int type = MachineType_FIRST; type < obj; ++type)
+        base += MachineType_base_count(MachineType(type));
+    return base;
+}
+
+int
+MachineType_base_level(const MachineType& obj)
+{
+    return obj;
+}
+
+MachineType
+MachineType_from_base_level(int level)
+{
+    return MachineType(level);
+}
+
+MachineType &
+operator++(MachineType& e)
+{
+    e = MachineType(e + 1);
+    return e;
+}
+
+std::string
+MachineType_to_string(const MachineType& obj)
+{
+    return obj == cacheType ? "Cache" : "Directory";
+}
+
+namespace {
+
+MachineID
+cache(NodeID num)
+{
+    return MachineID(cacheType, num);
+}
+
+NetDest
+cacheDest(std::initializer_list<NodeID> nums)
+{
+    NetDest dest;
+    for (auto num : nums)
+        dest.add(cache(num));
+    return dest;
+}
+
+} // anonymous namespace
+
+class SharerSetTest : public testing::Test
+{
+  protected:
+    // Keep two sharers exactly, for all the tests
+    static void SetUpTestCase() { SharerSet::setNumPointers(2); }
+
+    SharerSet sharers;
+};
+
+TEST_F(SharerSetTest, Empty)
+{
+    EXPECT_TRUE(sharers.isEmpty());
+    EXPECT_FALSE(sharers.isCoarse());
+    EXPECT_EQ(sharers.count(), 0);
+    EXPECT_FALSE(sharers.isElement(cache(0)));
+    EXPECT_TRUE(sharers.getDestinations().isEmpty());
+}
+
+TEST_F(SharerSetTest, ExactPointers)
+{
+    sharers.add(cache(3));
+    sharers.add(cache(70));
+    // Adding a sharer twice takes no extra pointer
+    sharers.add(cache(3));
+
+    EXPECT_FALSE(sharers.isCoarse());
+    EXPECT_EQ(sharers.count(), 2);
+    EXPECT_TRUE(sharers.isElement(cache(3)));
+    EXPECT_TRUE(sharers.isElement(cache(70)));
+    EXPECT_FALSE(sharers.isElement(cache(2)));
+    EXPECT_FALSE(sharers.isElement(MachineID(dirType, 0)));
+    EXPECT_TRUE(sharers.getDestinations().isEqual(cacheDest({3, 70})));
+}
+
+TEST_F(SharerSetTest, SwitchToCoarse)
+{
+    sharers.add(cache(3));
+    sharers.add(cache(70));
+    sharers.add(cache(99));
+
+    // Each bit stands for a pair of caches, and all pairs that hold a
+    // sharer are reached
+    EXPECT_TRUE(sharers.isCoarse());
+    EXPECT_FALSE(sharers.isEmpty());
+    EXPECT_EQ(sharers.count(), 6);
+    EXPECT_TRUE(sharers.isElement(cache(2)));
+    EXPECT_TRUE(sharers.isElement(cache(99)));
+    EXPECT_FALSE(sharers.isElement(cache(4)));
+    EXPECT_TRUE(sharers.getDestinations().isEqual(
+                    cacheDest({2, 3, 70, 71, 98, 99})));
+
+    // Further sharers only set their bit
+    sharers.add(cache(0));
+    EXPECT_TRUE(sharers.getDestinations().isEqual(
+                    cacheDest({0, 1, 2, 3, 70, 71, 98, 99})));
+}
+
+TEST_F(SharerSetTest, Remove)
+{
+    sharers.add(cache(3));
+    sharers.add(cache(70));
+    sharers.remove(cache(3));
+    EXPECT_FALSE(sharers.isElement(cache(3)));
+    EXPECT_TRUE(sharers.getDestinations().isEqual(cacheDest({70})));
+
+    // Removing a machine that is not a sharer changes nothing
+    sharers.remove(cache(5));
+    EXPECT_EQ(sharers.count(), 1);
+
+    sharers.remove(cache(70));
+    EXPECT_TRUE(sharers.isEmpty());
+}
+
+TEST_F(SharerSetTest, RemoveFromCoarse)
+{
+    sharers.add(cache(3));
+    sharers.add(cache(70));
+    sharers.add(cache(99));
+
+    // The bit of a sharer may cover another one, so it stays set
+    sharers.remove(cache(3));
+    EXPECT_TRUE(sharers.isCoarse());
+    EXPECT_TRUE(sharers.isElement(cache(3)));
+    EXPECT_EQ(sharers.count(), 6);
+}
+
+TEST_F(SharerSetTest, Clear)
+{
+    sharers.add(cache(3));
+    sharers.add(cache(70));
+    sharers.add(cache(99));
+    sharers.clear();
+
+    EXPECT_TRUE(sharers.isEmpty());
+    EXPECT_FALSE(sharers.isCoarse());
+    EXPECT_EQ(sharers.count(), 0);
+    EXPECT_FALSE(sharers.isElement(cache(3)));
+    EXPECT_TRUE(sharers.getDestinations().isEmpty());
+
+    // A cleared set takes sharers of another type
+    MachineID dir(dirType, 0);
+    sharers.add(dir);
+    EXPECT_TRUE(sharers.isElement(dir));
+    EXPECT_EQ(sharers.count(), 1);
+}
+
+TEST_F(SharerSetTest, ConflictingNumPointers)
+{
+    // Another directory may ask for the same number, but not another one
+    SharerSet::setNumPointers(2);
+    EXPECT_NONFATAL_FAILURE({
+        try {
+            SharerSet::setNumPointers(3);
+        } catch (...) {
+        }
+    }, "same number of sharer pointers");
+}
@@ -292,11 +292,13 @@ MessageBuffer::recycle(Tick current_time, Tick recycle_latency)
 }
 
 void
-MessageBuffer::reanalyzeList(list<MsgPtr> &lt, Tick schdTick)
+MessageBuffer::reanalyzeList(StallList &lt, Tick schdTick)
 {
-    while (!lt.empty()) {
+    while (lt.head) {
         m_msg_counter++;
-        MsgPtr m = lt.front();
+        MsgPtr m = lt.head;
+        lt.head = m->m_stall_next;
+        m->m_stall_next = nullptr;
         m->setLastEnqueueTime(schdTick);
         m->setMsgCounter(m_msg_counter);
 
@@ -305,15 +307,17 @@ MessageBuffer::reanalyzeList(list<MsgPtr> &lt, Tick schdTick)
                   greater<MsgPtr>());
 
         m_consumer->scheduleEventAbsolute(schdTick);
-        lt.pop_front();
     }
+    lt.tail = nullptr;
+    lt.size = 0;
 }
 
 void
 MessageBuffer::reanalyzeMessages(Addr addr, Tick current_time)
 {
     DPRINTF(RubyQueue, "ReanalyzeMessages %#x\n", addr);
-    assert(m_stall_msg_map.count(addr) > 0);
+    StallMsgMapType::iterator map_iter = m_stall_msg_map.find(addr);
+    assert(map_iter != m_stall_msg_map.end());
 
     //
     // Put all stalled messages associated with this address back on the
@@ -321,10 +325,10 @@ MessageBuffer::reanalyzeMessages(Addr addr, Tick current_time)
     // scheduled for the current cycle so that the previously stalled messages
     // will be observed before any younger messages that may arrive this cycle
     //
-    m_stall_map_size -= m_stall_msg_map[addr].size();
+    m_stall_map_size -= map_iter->second.size;
     assert(m_stall_map_size >= 0);
-    reanalyzeList(m_stall_msg_map[addr], current_time);
-    m_stall_msg_map.erase(addr);
+    reanalyzeList(map_iter->second, current_time);
+    m_stall_msg_map.erase(map_iter);
 }
 
 void
@@ -340,7 +344,7 @@ MessageBuffer::reanalyzeAllMessages(Tick current_time)
     //
     for (StallMsgMapType::iterator map_iter = m_stall_msg_map.begin();
          map_iter != m_stall_msg_map.end(); ++map_iter) {
-        m_stall_map_size -= map_iter->second.size();
+        m_stall_map_size -= map_iter->second.size;
         assert(m_stall_map_size >= 0);
         reanalyzeList(map_iter->second, current_time);
     }
@@ -364,7 +368,13 @@ MessageBuffer::stallMessage(Addr addr, Tick current_time)
     // Instead the controller is responsible to call reanalyzeMessages when
     // these addresses change state.
     //
-    (m_stall_msg_map[addr]).push_back(message);
+    StallList &lt = m_stall_msg_map[addr];
+    if (lt.tail)
+        lt.tail->m_stall_next = message;
+    else
+        lt.head = message;
+    lt.tail = message.get();
+    lt.size++;
     m_stall_map_size++;
     m_stall_count++;
 }
@@ -444,10 +454,8 @@ MessageBuffer::functionalWrite(Packet *pkt)
          map_iter != m_stall_msg_map.end();
          ++map_iter) {
 
-        for (std::list<MsgPtr>::iterator it = (map_iter->second).begin();
-            it != (map_iter->second).end(); ++it) {
-
-            Message *msg = (*it).get();
+        for (Message *msg = map_iter->second.head.get(); msg;
+             msg = msg->m_stall_next.get()) {
             if (msg->functionalWrite(pkt)) {
                 num_functional_writes++;
             }
@@ -38,6 +38,7 @@
 #include <cassert>
 #include <functional>
 #include <iostream>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -129,7 +130,20 @@ class MessageBuffer : public SimObject
     uint32_t functionalWrite(Packet *pkt);
 
   private:
-    void reanalyzeList(std::list<MsgPtr> &, Tick);
+    /**
+     * The messages stalled on one line, chained through
+     * Message::m_stall_next so that stalling a message allocates nothing.
+     */
+    struct StallList
+    {
+        StallList() : tail(nullptr), size(0) {}
+
+        MsgPtr head;
+        Message *tail;
+        int size;
+    };
+
+    void reanalyzeList(StallList &, Tick);
 
   private:
     // Data Members (m_ prefix)
@@ -141,7 +155,7 @@ class MessageBuffer : public SimObject
 
     // use a std::map for the stalled messages as this container is
     // sorted and ensures a well-defined iteration order
-    typedef std::map<Addr, std::list<MsgPtr> > StallMsgMapType;
+    typedef std::map<Addr, StallList> StallMsgMapType;
 
     /**
      * A map from line addresses to lists of stalled messages for that line.
@@ -42,6 +42,7 @@
 
 #include "base/logging.hh"
 #include "mem/ruby/common/MachineID.hh"
+#include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/BasicLink.hh"
 #include "mem/ruby/system/RubySystem.hh"
 
@@ -59,6 +60,9 @@ Network::Network(const Params *p)
     // Must make sure this is called after the State Machine constructors
     m_nodes = MachineType_base_number(MachineType_NUM);
     assert(m_nodes != 0);
+    fatal_if(m_nodes > NetDest::MAX_NODES,
+             "The network has %d nodes but a NetDest holds at most %d.\n",
+             m_nodes, NetDest::MAX_NODES);
     assert(m_virtual_networks != 0);
 
     m_topology_ptr = new Topology(p->routers.size(), p->ext_links,
@@ -54,7 +54,13 @@ class CrossbarSwitch : public Consumer
     void print(std::ostream& out) const {};
 
     inline void update_sw_winner(int inport, flit *t_flit)
-    { m_switch_buffer[inport]->insert(t_flit); }
+    {
+        m_switch_buffer[inport]->insert(t_flit);
+        m_num_flits++;
+    }
+
+    // True when no switch buffer holds a flit awaiting traversal
+    inline bool is_idle() const { return m_num_flits == 0; }
 
     inline double get_crossbar_activity() { return m_crossbar_activity; }
 
@@ -64,6 +70,7 @@ class CrossbarSwitch : public Consumer
   private:
     int m_num_vcs;
     int m_num_inports;
+    int m_num_flits;
     double m_crossbar_activity;
     Router *m_router;
     std::vector<flitBuffer *> m_switch_buffer;
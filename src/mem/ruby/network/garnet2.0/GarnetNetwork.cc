@@ -65,6 +65,7 @@ GarnetNetwork::GarnetNetwork(const Params *p)
     m_buffers_per_data_vc = p->buffers_per_data_vc;
     m_buffers_per_ctrl_vc = p->buffers_per_ctrl_vc;
     m_routing_algorithm = p->routing_algorithm;
+    m_partitioned = false;
 
     m_enable_fault_model = p->enable_fault_model;
     if (m_enable_fault_model)
@@ -112,6 +113,14 @@ GarnetNetwork::init()
     assert(m_topology_ptr != NULL);
     m_topology_ptr->createLinks(this);
 
+    // A parallel network places its routers on several event queues,
+    // see configs/network/Network.py. Links check their own latency
+    // against the simulation quantum as they are connected.
+    for (auto *router : m_routers) {
+        if (router->eventQueue() != eventQueue())
+            m_partitioned = true;
+    }
+
     // Initialize topology specific parameters
     if (getNumRows() > 0) {
         // Only for Mesh topology
@@ -444,6 +453,10 @@ GarnetNetwork::functionalWrite(Packet *pkt)
 {
     uint32_t num_functional_writes = 0;
 
+    if (m_partitioned)
+        warn_once("Functional writes to a partitioned garnet network are "
+                  "not synchronised with the other event queues\n");
+
     for (unsigned int i = 0; i < m_routers.size(); i++) {
         num_functional_writes += m_routers[i]->functionalWrite(pkt);
     }
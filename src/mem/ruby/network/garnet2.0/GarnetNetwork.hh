@@ -154,6 +154,9 @@ class GarnetNetwork : public Network
     int m_routing_algorithm;
     bool m_enable_fault_model;
 
+    // Routers are spread over more than one event queue
+    bool m_partitioned;
+
     // Statistical variables
     Stats::Vector m_packets_received;
     Stats::Vector m_packets_injected;
@@ -85,7 +85,7 @@ void
 InputUnit::wakeup()
 {
     flit *t_flit;
-    if (m_in_link->isReady(m_router->curCycle())) {
+    if (has_incoming_flit()) {
 
         t_flit = m_in_link->consumeLink();
         int vc = t_flit->get_vc();
@@ -139,6 +139,12 @@ InputUnit::wakeup()
     }
 }
 
+bool
+InputUnit::has_incoming_flit()
+{
+    return m_in_link->isReady(m_router->curCycle());
+}
+
 // Send a credit back to upstream router for this VC.
 // Called by SwitchAllocator when the flit in this VC wins the Switch.
 void
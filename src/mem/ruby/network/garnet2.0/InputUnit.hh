@@ -52,6 +52,9 @@ class InputUnit : public Consumer
     ~InputUnit();
 
     void wakeup();
+
+    // True when a flit is waiting on the input link this cycle
+    bool has_incoming_flit();
     void print(std::ostream& out) const {};
 
     inline PortDirection get_direction() { return m_direction; }
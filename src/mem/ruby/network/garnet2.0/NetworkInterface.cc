@@ -94,6 +94,10 @@ void
 NetworkInterface::addInPort(NetworkLink *in_link,
                               CreditLink *credit_link)
 {
+    fatal_if(credit_link->eventQueue() != eventQueue(),
+             "%s: credit link %s must share the interface's event queue\n",
+             name(), credit_link->name());
+
     inNetLink = in_link;
     in_link->setLinkConsumer(this);
     outCreditLink = credit_link;
@@ -105,6 +109,10 @@ NetworkInterface::addOutPort(NetworkLink *out_link,
                              CreditLink *credit_link,
                              SwitchID router_id)
 {
+    fatal_if(out_link->eventQueue() != eventQueue(),
+             "%s: network link %s must share the interface's event queue\n",
+             name(), out_link->name());
+
     inCreditLink = credit_link;
     credit_link->setLinkConsumer(this);
 
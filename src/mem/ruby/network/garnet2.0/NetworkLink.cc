@@ -40,7 +40,7 @@ NetworkLink::NetworkLink(const Params *p)
       m_type(NUM_LINK_TYPES_),
       m_latency(p->link_latency),
       linkBuffer(new flitBuffer()), link_consumer(nullptr),
-      link_srcQueue(nullptr), m_link_utilized(0),
+      link_srcQueue(nullptr), m_remote_consumer(false), m_link_utilized(0),
       m_vc_load(p->vcs_per_vnet * p->virt_nets)
 {
 }
@@ -54,6 +54,18 @@ void
 NetworkLink::setLinkConsumer(Consumer *consumer)
 {
     link_consumer = consumer;
+
+    // A link always runs on the event queue of the unit feeding it.
+    // When its consumer runs on another queue, flits cross between the
+    // partitions through the link buffer, and the link latency is the
+    // lookahead that lets the partitions run a quantum apart.
+    m_remote_consumer = consumer->wakeupEventQueue() != eventQueue();
+    if (m_remote_consumer) {
+        fatal_if(simQuantum == 0 || cyclesToTicks(m_latency) < simQuantum,
+                 "%s connects two event queues, the simulation quantum "
+                 "must be non-zero and at most the link latency (%d "
+                 "ticks)\n", name(), cyclesToTicks(m_latency));
+    }
 }
 
 void
@@ -68,10 +80,18 @@ NetworkLink::wakeup()
     if (link_srcQueue->isReady(curCycle())) {
         flit *t_flit = link_srcQueue->getTopFlit();
         t_flit->set_time(curCycle() + m_latency);
-        linkBuffer->insert(t_flit);
-        link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
         m_link_utilized++;
         m_vc_load[t_flit->get_vc()]++;
+
+        {
+            auto lock = lockBuffer();
+            linkBuffer->insert(t_flit);
+        }
+
+        if (m_remote_consumer)
+            link_consumer->scheduleRemoteEvent(clockEdge(m_latency));
+        else
+            link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
     }
 }
 
@@ -100,5 +120,6 @@ CreditLinkParams::create()
 uint32_t
 NetworkLink::functionalWrite(Packet *pkt)
 {
+    auto lock = lockBuffer();
     return linkBuffer->functionalWrite(pkt);
 }
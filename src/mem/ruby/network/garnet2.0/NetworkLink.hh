@@ -35,6 +35,7 @@
 #define __MEM_RUBY_NETWORK_GARNET2_0_NETWORKLINK_HH__
 
 #include <iostream>
+#include <mutex>
 #include <vector>
 
 #include "mem/ruby/common/Consumer.hh"
@@ -64,15 +65,42 @@ class NetworkLink : public ClockedObject, public Consumer
     const std::vector<unsigned int> & getVcLoad() const { return m_vc_load; }
 
     inline bool isReady(Cycles curTime)
-    { return linkBuffer->isReady(curTime); }
+    {
+        auto lock = lockBuffer();
+        return linkBuffer->isReady(curTime);
+    }
 
-    inline flit* peekLink()       { return linkBuffer->peekTopFlit(); }
-    inline flit* consumeLink()    { return linkBuffer->getTopFlit(); }
+    inline flit*
+    peekLink()
+    {
+        auto lock = lockBuffer();
+        return linkBuffer->peekTopFlit();
+    }
+
+    inline flit*
+    consumeLink()
+    {
+        auto lock = lockBuffer();
+        return linkBuffer->getTopFlit();
+    }
 
     uint32_t functionalWrite(Packet *);
     void resetStats();
 
   private:
+    /**
+     * The link buffer of a link whose consumer runs on another event
+     * queue is filled and drained by two threads. Only such links
+     * take the lock.
+     */
+    std::unique_lock<std::mutex>
+    lockBuffer()
+    {
+        return m_remote_consumer ?
+            std::unique_lock<std::mutex>(m_buffer_lock) :
+            std::unique_lock<std::mutex>();
+    }
+
     const int m_id;
     link_type m_type;
     const Cycles m_latency;
@@ -81,6 +109,10 @@ class NetworkLink : public ClockedObject, public Consumer
     Consumer *link_consumer;
     flitBuffer *link_srcQueue;
 
+    // The consumer belongs to another partition of a parallel network
+    bool m_remote_consumer;
+    std::mutex m_buffer_lock;
+
     // Statistical variables
     unsigned int m_link_utilized;
     std::vector<unsigned int> m_vc_load;
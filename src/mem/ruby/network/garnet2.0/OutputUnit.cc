@@ -106,6 +106,20 @@ OutputUnit::has_free_vc(int vnet)
     return false;
 }
 
+// Buffers left in the downstream VCs of a vnet.
+// Used by adaptive routing as a measure of congestion.
+int
+OutputUnit::get_free_credits(int vnet)
+{
+    int credits = 0;
+    int vc_base = vnet*m_vc_per_vnet;
+    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++) {
+        credits += get_credit_count(vc);
+    }
+
+    return credits;
+}
+
 // Assign a free output VC to the winner of Switch Allocation
 int
 OutputUnit::select_free_vc(int vnet)
@@ -132,7 +146,7 @@ OutputUnit::select_free_vc(int vnet)
 void
 OutputUnit::wakeup()
 {
-    if (m_credit_link->isReady(m_router->curCycle())) {
+    if (has_incoming_credit()) {
         Credit *t_credit = (Credit*) m_credit_link->consumeLink();
         increment_credit(t_credit->get_vc());
 
@@ -143,6 +157,12 @@ OutputUnit::wakeup()
     }
 }
 
+bool
+OutputUnit::has_incoming_credit()
+{
+    return m_credit_link->isReady(m_router->curCycle());
+}
+
 flitBuffer*
 OutputUnit::getOutQueue()
 {
@@ -53,6 +53,9 @@ class OutputUnit : public Consumer
     void set_out_link(NetworkLink *link);
     void set_credit_link(CreditLink *credit_link);
     void wakeup();
+
+    // True when a credit is waiting on the credit link this cycle
+    bool has_incoming_credit();
     flitBuffer* getOutQueue();
     void print(std::ostream& out) const {};
     void decrement_credit(int out_vc);
@@ -60,6 +63,7 @@ class OutputUnit : public Consumer
     bool has_credit(int out_vc);
     bool has_free_vc(int vnet);
     int select_free_vc(int vnet);
+    int get_free_credits(int vnet);
 
     inline PortDirection get_direction() { return m_direction; }
 
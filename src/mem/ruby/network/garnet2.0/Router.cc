@@ -54,6 +54,7 @@ Router::Router(const Params *p)
     m_virtual_networks = p->virt_nets;
     m_vc_per_vnet = p->vcs_per_vnet;
     m_num_vcs = m_virtual_networks * m_vc_per_vnet;
+    m_num_buffered_flits = 0;
 
     m_routing_unit = new RoutingUnit(this);
     m_sw_alloc = new SwitchAllocator(this);
@@ -81,14 +82,30 @@ Router::init()
     m_switch->init();
 }
 
+/*
+ * The router only evaluates the units that have work this cycle:
+ * input units with a flit on their link, output units with a credit on
+ * their credit link, the switch allocator while flits are buffered in
+ * the input VCs, and the crossbar while its switch buffers are occupied.
+ * A router with none of these is not rescheduled by any of its units and
+ * stays off the event queue until a link wakes it again.
+ */
 void
 Router::wakeup()
 {
     DPRINTF(RubyNetwork, "Router %d woke up\n", m_id);
 
+    bool active = false;
+
     // check for incoming flits
     for (int inport = 0; inport < m_input_unit.size(); inport++) {
-        m_input_unit[inport]->wakeup();
+        if (m_input_unit[inport]->has_incoming_flit()) {
+            m_input_unit[inport]->wakeup();
+            m_num_buffered_flits++;
+            active = true;
+        } else {
+            m_gated_evaluations++;
+        }
     }
 
     // check for incoming credits
@@ -98,20 +115,44 @@ Router::wakeup()
     // if we want the credit update to take place after SA, this loop should
     // be moved after the SA request
     for (int outport = 0; outport < m_output_unit.size(); outport++) {
-        m_output_unit[outport]->wakeup();
+        if (m_output_unit[outport]->has_incoming_credit()) {
+            m_output_unit[outport]->wakeup();
+            active = true;
+        } else {
+            m_gated_evaluations++;
+        }
     }
 
     // Switch Allocation
-    m_sw_alloc->wakeup();
+    if (m_num_buffered_flits > 0) {
+        m_sw_alloc->wakeup();
+        active = true;
+    } else {
+        m_gated_evaluations++;
+    }
 
     // Switch Traversal
-    m_switch->wakeup();
+    if (!m_switch->is_idle()) {
+        m_switch->wakeup();
+        active = true;
+    } else {
+        m_gated_evaluations++;
+    }
+
+    if (!active) {
+        DPRINTF(RubyNetwork, "Router %d has no pending activity\n", m_id);
+        m_idle_wakeups++;
+    }
 }
 
 void
 Router::addInPort(PortDirection inport_dirn,
                   NetworkLink *in_link, CreditLink *credit_link)
 {
+    fatal_if(credit_link->eventQueue() != eventQueue(),
+             "%s: credit link %s must share the router's event queue\n",
+             name(), credit_link->name());
+
     int port_num = m_input_unit.size();
     InputUnit *input_unit = new InputUnit(port_num, inport_dirn, this);
 
@@ -131,6 +172,10 @@ Router::addOutPort(PortDirection outport_dirn,
                    const NetDest& routing_table_entry, int link_weight,
                    CreditLink *credit_link)
 {
+    fatal_if(out_link->eventQueue() != eventQueue(),
+             "%s: network link %s must share the router's event queue\n",
+             name(), out_link->name());
+
     int port_num = m_output_unit.size();
     OutputUnit *output_unit = new OutputUnit(port_num, outport_dirn, this);
 
@@ -159,7 +204,8 @@ Router::getInportDirection(int inport)
 }
 
 int
-Router::route_compute(RouteInfo route, int inport, PortDirection inport_dirn)
+Router::route_compute(const RouteInfo &route, int inport,
+                      const PortDirection &inport_dirn)
 {
     return m_routing_unit->outportCompute(route, inport, inport_dirn);
 }
@@ -167,6 +213,8 @@ Router::route_compute(RouteInfo route, int inport, PortDirection inport_dirn)
 void
 Router::grant_switch(int inport, flit *t_flit)
 {
+    assert(m_num_buffered_flits > 0);
+    m_num_buffered_flits--;
     m_switch->update_sw_winner(inport, t_flit);
 }
 
@@ -216,6 +264,19 @@ Router::regStats()
         .name(name() + ".sw_output_arbiter_activity")
         .flags(Stats::nozero)
     ;
+
+    m_idle_wakeups
+        .name(name() + ".idle_wakeups")
+        .desc("Number of wakeups that found no flits, credits or "
+              "switch work")
+        .flags(Stats::nozero)
+    ;
+
+    m_gated_evaluations
+        .name(name() + ".gated_evaluations")
+        .desc("Number of unit evaluations skipped for lack of activity")
+        .flags(Stats::nozero)
+    ;
 }
 
 void
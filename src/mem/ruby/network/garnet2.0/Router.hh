@@ -91,7 +91,8 @@ class Router : public BasicRouter, public Consumer
     PortDirection getOutportDirection(int outport);
     PortDirection getInportDirection(int inport);
 
-    int route_compute(RouteInfo route, int inport, PortDirection direction);
+    int route_compute(const RouteInfo &route, int inport,
+                      const PortDirection &direction);
     void grant_switch(int inport, flit *t_flit);
     void schedule_wakeup(Cycles time);
 
@@ -127,6 +128,11 @@ class Router : public BasicRouter, public Consumer
     SwitchAllocator *m_sw_alloc;
     CrossbarSwitch *m_switch;
 
+    // Flits held in the input VCs, waiting for switch allocation.
+    // Together with the crossbar occupancy this tells the router
+    // whether the allocator and switch need to be evaluated at all.
+    int m_num_buffered_flits;
+
     // Statistical variables required for power computations
     Stats::Scalar m_buffer_reads;
     Stats::Scalar m_buffer_writes;
@@ -135,6 +141,10 @@ class Router : public BasicRouter, public Consumer
     Stats::Scalar m_sw_output_arbiter_activity;
 
     Stats::Scalar m_crossbar_activity;
+
+    // Activity gating
+    Stats::Scalar m_idle_wakeups;
+    Stats::Scalar m_gated_evaluations;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_ROUTER_HH__
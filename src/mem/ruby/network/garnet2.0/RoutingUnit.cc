@@ -35,6 +35,7 @@
 
 #include "base/cast.hh"
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
+#include "mem/ruby/network/garnet2.0/OutputUnit.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 
@@ -43,6 +44,10 @@ RoutingUnit::RoutingUnit(Router *router)
     m_router = router;
     m_routing_table.clear();
     m_weight_table.clear();
+
+    for (int dirn = 0; dirn < NUM_MESH_DIRECTIONS_; dirn++) {
+        m_mesh_outports[dirn] = -1;
+    }
 }
 
 void
@@ -65,7 +70,7 @@ RoutingUnit::addWeight(int link_weight)
  */
 
 int
-RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
+RoutingUnit::lookupRoutingTable(int vnet, const NetDest &msg_destination)
 {
     // First find all possible output link candidates
     // For ordered vnet, just choose the first
@@ -127,6 +132,15 @@ RoutingUnit::addOutDirection(PortDirection outport_dirn, int outport_idx)
 {
     m_outports_dirn2idx[outport_dirn] = outport_idx;
     m_outports_idx2dirn[outport_idx]  = outport_dirn;
+
+    if (outport_dirn == "East")
+        m_mesh_outports[EAST_] = outport_idx;
+    else if (outport_dirn == "West")
+        m_mesh_outports[WEST_] = outport_idx;
+    else if (outport_dirn == "North")
+        m_mesh_outports[NORTH_] = outport_idx;
+    else if (outport_dirn == "South")
+        m_mesh_outports[SOUTH_] = outport_idx;
 }
 
 // outportCompute() is called by the InputUnit
@@ -136,8 +150,8 @@ RoutingUnit::addOutDirection(PortDirection outport_dirn, int outport_idx)
 // table is provided here.
 
 int
-RoutingUnit::outportCompute(RouteInfo route, int inport,
-                            PortDirection inport_dirn)
+RoutingUnit::outportCompute(const RouteInfo &route, int inport,
+                            const PortDirection &inport_dirn)
 {
     int outport = -1;
 
@@ -160,6 +174,10 @@ RoutingUnit::outportCompute(RouteInfo route, int inport,
             lookupRoutingTable(route.vnet, route.net_dest); break;
         case XY_:     outport =
             outportComputeXY(route, inport, inport_dirn); break;
+        case WEST_FIRST_: outport =
+            outportComputeWestFirst(route, inport, inport_dirn); break;
+        case ODD_EVEN_: outport =
+            outportComputeOddEven(route, inport, inport_dirn); break;
         // any custom algorithm
         case CUSTOM_: outport =
             outportComputeCustom(route, inport, inport_dirn); break;
@@ -171,27 +189,40 @@ RoutingUnit::outportCompute(RouteInfo route, int inport,
     return outport;
 }
 
+void
+RoutingUnit::getMeshCoordinates(int router, int &x, int &y) const
+{
+    int M5_VAR_USED num_rows = m_router->get_net_ptr()->getNumRows();
+    int num_cols = m_router->get_net_ptr()->getNumCols();
+    assert(num_rows > 0 && num_cols > 0);
+
+    x = router % num_cols;
+    y = router / num_cols;
+}
+
+int
+RoutingUnit::getMeshOutport(MeshDirection dirn) const
+{
+    int outport = m_mesh_outports[dirn];
+    assert(outport != -1);
+    return outport;
+}
+
 // XY routing implemented using port directions
 // Only for reference purpose in a Mesh
 // By default Garnet uses the routing table
 int
-RoutingUnit::outportComputeXY(RouteInfo route,
+RoutingUnit::outportComputeXY(const RouteInfo &route,
                               int inport,
-                              PortDirection inport_dirn)
+                              const PortDirection &inport_dirn)
 {
-    PortDirection outport_dirn = "Unknown";
-
-    int M5_VAR_USED num_rows = m_router->get_net_ptr()->getNumRows();
-    int num_cols = m_router->get_net_ptr()->getNumCols();
-    assert(num_rows > 0 && num_cols > 0);
+    MeshDirection outport_dirn = NUM_MESH_DIRECTIONS_;
 
-    int my_id = m_router->get_id();
-    int my_x = my_id % num_cols;
-    int my_y = my_id / num_cols;
+    int my_x, my_y;
+    getMeshCoordinates(m_router->get_id(), my_x, my_y);
 
-    int dest_id = route.dest_router;
-    int dest_x = dest_id % num_cols;
-    int dest_y = dest_id / num_cols;
+    int dest_x, dest_y;
+    getMeshCoordinates(route.dest_router, dest_x, dest_y);
 
     int x_hops = abs(dest_x - my_x);
     int y_hops = abs(dest_y - my_y);
@@ -205,20 +236,20 @@ RoutingUnit::outportComputeXY(RouteInfo route,
     if (x_hops > 0) {
         if (x_dirn) {
             assert(inport_dirn == "Local" || inport_dirn == "West");
-            outport_dirn = "East";
+            outport_dirn = EAST_;
         } else {
             assert(inport_dirn == "Local" || inport_dirn == "East");
-            outport_dirn = "West";
+            outport_dirn = WEST_;
         }
     } else if (y_hops > 0) {
         if (y_dirn) {
             // "Local" or "South" or "West" or "East"
             assert(inport_dirn != "North");
-            outport_dirn = "North";
+            outport_dirn = NORTH_;
         } else {
             // "Local" or "North" or "West" or "East"
             assert(inport_dirn != "South");
-            outport_dirn = "South";
+            outport_dirn = SOUTH_;
         }
     } else {
         // x_hops == 0 and y_hops == 0
@@ -227,15 +258,127 @@ RoutingUnit::outportComputeXY(RouteInfo route,
         assert(0);
     }
 
-    return m_outports_dirn2idx[outport_dirn];
+    return getMeshOutport(outport_dirn);
+}
+
+/*
+ * Adaptive routing picks among the minimal directions allowed by its
+ * turn model the one whose downstream VCs have the most free buffers.
+ * Packets of an ordered vnet always take the first allowed direction,
+ * so that they all follow the same path.
+ */
+
+int
+RoutingUnit::selectOutport(const MeshDirection *candidates,
+                           int num_candidates, int vnet)
+{
+    assert(num_candidates > 0);
+
+    int outport = getMeshOutport(candidates[0]);
+    if (num_candidates == 1 ||
+        m_router->get_net_ptr()->isVNetOrdered(vnet)) {
+        return outport;
+    }
+
+    std::vector<OutputUnit *> &output_unit = m_router->get_outputUnit_ref();
+    int max_credits = output_unit[outport]->get_free_credits(vnet);
+
+    for (int i = 1; i < num_candidates; i++) {
+        int candidate = getMeshOutport(candidates[i]);
+        int credits = output_unit[candidate]->get_free_credits(vnet);
+        if (credits > max_credits) {
+            outport = candidate;
+            max_credits = credits;
+        }
+    }
+
+    return outport;
+}
+
+// West-first routing in a Mesh
+// All hops to the west are taken first. Packets heading east may then
+// adaptively choose between east and north/south.
+int
+RoutingUnit::outportComputeWestFirst(const RouteInfo &route,
+                                     int inport,
+                                     const PortDirection &inport_dirn)
+{
+    int my_x, my_y;
+    getMeshCoordinates(m_router->get_id(), my_x, my_y);
+
+    int dest_x, dest_y;
+    getMeshCoordinates(route.dest_router, dest_x, dest_y);
+
+    MeshDirection candidates[2];
+    int num_candidates = 0;
+
+    if (dest_x < my_x) {
+        assert(inport_dirn == "Local" || inport_dirn == "East");
+        candidates[num_candidates++] = WEST_;
+    } else {
+        if (dest_x > my_x)
+            candidates[num_candidates++] = EAST_;
+        if (dest_y > my_y)
+            candidates[num_candidates++] = NORTH_;
+        else if (dest_y < my_y)
+            candidates[num_candidates++] = SOUTH_;
+    }
+
+    return selectOutport(candidates, num_candidates, route.vnet);
+}
+
+// Odd-even routing in a Mesh (G.-M. Chiu, IEEE TPDS 2000)
+// Packets may not turn from east to north/south in an even column, nor
+// from north/south to west in an odd column. This leaves more adaptive
+// choices than west-first while staying deadlock free.
+int
+RoutingUnit::outportComputeOddEven(const RouteInfo &route,
+                                   int inport,
+                                   const PortDirection &inport_dirn)
+{
+    int my_x, my_y;
+    getMeshCoordinates(m_router->get_id(), my_x, my_y);
+
+    int src_x, src_y;
+    getMeshCoordinates(route.src_router, src_x, src_y);
+
+    int dest_x, dest_y;
+    getMeshCoordinates(route.dest_router, dest_x, dest_y);
+
+    int x_offset = dest_x - my_x;
+    int y_offset = dest_y - my_y;
+    MeshDirection y_dirn = (y_offset > 0) ? NORTH_ : SOUTH_;
+
+    MeshDirection candidates[2];
+    int num_candidates = 0;
+
+    if (x_offset == 0) {
+        assert(y_offset != 0);
+        candidates[num_candidates++] = y_dirn;
+    } else if (x_offset > 0) {
+        if (y_offset == 0) {
+            candidates[num_candidates++] = EAST_;
+        } else {
+            if (my_x % 2 == 1 || my_x == src_x)
+                candidates[num_candidates++] = y_dirn;
+            if (dest_x % 2 == 1 || x_offset != 1)
+                candidates[num_candidates++] = EAST_;
+        }
+    } else {
+        candidates[num_candidates++] = WEST_;
+        if (y_offset != 0 && my_x % 2 == 0)
+            candidates[num_candidates++] = y_dirn;
+    }
+
+    return selectOutport(candidates, num_candidates, route.vnet);
 }
 
 // Template for implementing custom routing algorithm
 // using port directions. (Example adaptive)
 int
-RoutingUnit::outportComputeCustom(RouteInfo route,
+RoutingUnit::outportComputeCustom(const RouteInfo &route,
                                  int inport,
-                                 PortDirection inport_dirn)
+                                 const PortDirection &inport_dirn)
 {
     assert(0);
     return -1;
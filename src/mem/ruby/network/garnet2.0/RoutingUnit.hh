@@ -47,32 +47,53 @@ class RoutingUnit
 {
   public:
     RoutingUnit(Router *router);
-    int outportCompute(RouteInfo route,
+    int outportCompute(const RouteInfo &route,
                       int inport,
-                      PortDirection inport_dirn);
+                      const PortDirection &inport_dirn);
 
     // Topology-agnostic Routing Table based routing (default)
     void addRoute(const NetDest& routing_table_entry);
     void addWeight(int link_weight);
 
     // get output port from routing table
-    int  lookupRoutingTable(int vnet, NetDest net_dest);
+    int  lookupRoutingTable(int vnet, const NetDest &net_dest);
 
     // Topology-specific direction based routing
     void addInDirection(PortDirection inport_dirn, int inport);
     void addOutDirection(PortDirection outport_dirn, int outport);
 
     // Routing for Mesh
-    int outportComputeXY(RouteInfo route,
+    int outportComputeXY(const RouteInfo &route,
                          int inport,
-                         PortDirection inport_dirn);
+                         const PortDirection &inport_dirn);
+
+    // Adaptive minimal routing for Mesh (turn model)
+    int outportComputeWestFirst(const RouteInfo &route,
+                                int inport,
+                                const PortDirection &inport_dirn);
+    int outportComputeOddEven(const RouteInfo &route,
+                              int inport,
+                              const PortDirection &inport_dirn);
 
     // Custom Routing Algorithm using Port Directions
-    int outportComputeCustom(RouteInfo route,
+    int outportComputeCustom(const RouteInfo &route,
                              int inport,
-                             PortDirection inport_dirn);
+                             const PortDirection &inport_dirn);
 
   private:
+    enum MeshDirection { EAST_, WEST_, NORTH_, SOUTH_,
+                         NUM_MESH_DIRECTIONS_ };
+
+    // Mesh coordinates of a router
+    void getMeshCoordinates(int router, int &x, int &y) const;
+
+    // Outport of a mesh direction
+    int getMeshOutport(MeshDirection dirn) const;
+
+    // Pick the least congested of the candidate directions
+    int selectOutport(const MeshDirection *candidates, int num_candidates,
+                      int vnet);
+
     Router *m_router;
 
     // Routing Table
@@ -84,6 +105,10 @@ class RoutingUnit
     std::map<int, PortDirection> m_inports_idx2dirn;
     std::map<int, PortDirection> m_outports_idx2dirn;
     std::map<PortDirection, int> m_outports_dirn2idx;
+
+    // Outports of the mesh directions, resolved once as ports are added
+    // so that direction based routing needs no map lookup per flit
+    int m_mesh_outports[NUM_MESH_DIRECTIONS_];
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGUNIT_HH__
@@ -85,17 +85,18 @@ SwitchAllocator::init()
  * output VC is assigned to the winning flits of each output port.
  * There is no separate VCAllocator stage like the one in garnet1.0.
  * At the end of this function, the router is rescheduled to wakeup
- * next cycle for peforming SA for any flits ready next cycle.
+ * next cycle for peforming SA for any flits ready next cycle, as long
+ * as at least one input VC was able to place a request this cycle.
  */
 
 void
 SwitchAllocator::wakeup()
 {
-    arbitrate_inports(); // First stage of allocation
+    bool requested = arbitrate_inports(); // First stage of allocation
     arbitrate_outports(); // Second stage of allocation
 
     clear_request_vector();
-    check_for_wakeup();
+    check_for_wakeup(requested);
 }
 
 /*
@@ -106,11 +107,14 @@ SwitchAllocator::wakeup()
  *    - For BODY/TAIL flits, only selects an input VC that has credits
  *      in its output VC.
  * Places a request for the output port from this input VC.
+ * Returns true if any input port placed a request.
  */
 
-void
+bool
 SwitchAllocator::arbitrate_inports()
 {
+    bool requested = false;
+
     // Select a VC from each input in a round robin manner
     // Independent arbiter at each input port
     for (int inport = 0; inport < m_num_inports; inport++) {
@@ -132,6 +136,7 @@ SwitchAllocator::arbitrate_inports()
                     send_allowed(inport, invc, outport, outvc);
 
                 if (make_request) {
+                    requested = true;
                     m_input_arbiter_activity++;
                     m_port_requests[outport][inport] = true;
                     m_vc_winners[outport][inport]= invc;
@@ -150,6 +155,8 @@ SwitchAllocator::arbitrate_inports()
                 invc = 0;
         }
     }
+
+    return requested;
 }
 
 /*
@@ -352,9 +359,16 @@ SwitchAllocator::vc_allocate(int outport, int inport, int invc)
 
 // Wakeup the router next cycle to perform SA again
 // if there are flits ready.
+// If no input VC could place a request this cycle, every flit waiting
+// for SA is blocked on a free output VC or a credit. Both arrive over
+// a credit link, which wakes the router itself, so the router is not
+// rescheduled and drops off the event queue until then.
 void
-SwitchAllocator::check_for_wakeup()
+SwitchAllocator::check_for_wakeup(bool requested)
 {
+    if (!requested)
+        return;
+
     Cycles nextCycle = m_router->curCycle() + Cycles(1);
 
     for (int i = 0; i < m_num_inports; i++) {
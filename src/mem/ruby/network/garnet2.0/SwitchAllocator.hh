@@ -51,10 +51,10 @@ class SwitchAllocator : public Consumer
     void wakeup();
     void init();
     void clear_request_vector();
-    void check_for_wakeup();
+    void check_for_wakeup(bool requested);
     int get_vnet (int invc);
     void print(std::ostream& out) const {};
-    void arbitrate_inports();
+    bool arbitrate_inports();
     void arbitrate_outports();
     bool send_allowed(int inport, int invc, int outport, int outvc);
     int vc_allocate(int outport, int inport, int invc);
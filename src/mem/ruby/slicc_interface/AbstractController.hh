@@ -116,6 +116,14 @@ class AbstractController : public MemObject, public Consumer
     virtual void enqueuePrefetch(const Addr &, const RubyRequestType&)
     { fatal("Prefetches not implemented!");}
 
+    //! Function for writing a line restored from a checkpoint straight
+    //! into this controller's caches, in place of replaying the access
+    //! that brought it in. Protocols that can do this define it; it
+    //! returns false if the line has to be replayed instead.
+    virtual bool injectCacheLine(const Addr &, const DataBlock &,
+                                 const RubyRequestType &)
+    { return false; }
+
     //! Function for collating statistics from all the controllers of this
     //! particular type. This function should only be called from the
     //! version 0 of this controller type.
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/slicc_interface/Message.hh"
+
+#include <new>
+
+namespace
+{
+
+// Messages up to maxPooledSize bytes are pooled, in size classes
+// poolGranularity bytes apart. Freed messages are chained through their
+// first word. The pools are per thread, and as a message is only ever
+// created and destroyed on the event queue of the network interfaces,
+// it always returns to the pool it came from.
+const size_t poolGranularity = 16;
+const size_t maxPooledSize = 1024;
+
+thread_local void *freeLists[maxPooledSize / poolGranularity];
+
+size_t
+sizeClass(size_t size)
+{
+    return (size - 1) / poolGranularity;
+}
+
+} // anonymous namespace
+
+void *
+Message::operator new(size_t size)
+{
+    if (size > maxPooledSize)
+        return ::operator new(size);
+
+    void *&head = freeLists[sizeClass(size)];
+    if (!head)
+        return ::operator new((sizeClass(size) + 1) * poolGranularity);
+
+    void *ptr = head;
+    head = *static_cast<void **>(ptr);
+    return ptr;
+}
+
+void
+Message::operator delete(void *ptr, size_t size)
+{
+    if (size > maxPooledSize) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    void *&head = freeLists[sizeClass(size)];
+    *static_cast<void **>(ptr) = head;
+    head = ptr;
+}
@@ -30,17 +30,26 @@
 #define __MEM_RUBY_SLICC_INTERFACE_MESSAGE_HH__
 
 #include <iostream>
-#include <memory>
 #include <stack>
 
+#include "base/refcnt.hh"
 #include "mem/packet.hh"
 #include "mem/protocol/MessageSizeType.hh"
 #include "mem/ruby/common/NetDest.hh"
 
 class Message;
-typedef std::shared_ptr<Message> MsgPtr;
-
-class Message
+typedef RefCountingPtr<Message> MsgPtr;
+
+/**
+ * Messages are reference counted intrusively. They are created and
+ * destroyed only on the event queue of the controllers and network
+ * interfaces, even when the routers run on other queues, as these move
+ * flits around without copying the message handles. A handle therefore
+ * costs no atomic operation, and the per-size pools the messages are
+ * allocated from, which in practice give each message type a free list
+ * of its own, need no locking.
+ */
+class Message : public RefCounted
 {
   public:
     Message(Tick curTime)
@@ -50,7 +59,8 @@ class Message
     { }
 
     Message(const Message &other)
-        : m_time(other.m_time),
+        : RefCounted(),
+          m_time(other.m_time),
           m_LastEnqueueTime(other.m_LastEnqueueTime),
           m_DelayedTicks(other.m_DelayedTicks),
           m_msg_counter(other.m_msg_counter)
@@ -58,6 +68,9 @@ class Message
 
     virtual ~Message() { }
 
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+
     virtual MsgPtr clone() const = 0;
     virtual void print(std::ostream& out) const = 0;
 
@@ -104,6 +117,11 @@ class Message
     void setVnet(int net) { vnet = net; }
 
   private:
+    friend class MessageBuffer;
+
+    // Next message stalled on the same line in a MessageBuffer
+    MsgPtr m_stall_next;
+
     const Tick m_time;
     Tick m_LastEnqueueTime; // my last enqueue time
     Tick m_DelayedTicks; // my delayed cycles
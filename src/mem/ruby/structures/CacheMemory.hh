@@ -31,13 +31,13 @@
 #define __MEM_RUBY_STRUCTURES_CACHEMEMORY_HH__
 
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "base/statistics.hh"
 #include "mem/protocol/CacheRequestType.hh"
 #include "mem/protocol/CacheResourceType.hh"
 #include "mem/protocol/RubyRequest.hh"
+#include "mem/ruby/common/AddrHashMap.hh"
 #include "mem/ruby/common/DataBlock.hh"
 #include "mem/ruby/slicc_interface/AbstractCacheEntry.hh"
 #include "mem/ruby/slicc_interface/RubySlicc_ComponentMapping.hh"
@@ -160,6 +160,18 @@ class CacheMemory : public SimObject
     int findTagInSet(int64_t line, Addr tag) const;
     int findTagInSetIgnorePermissions(int64_t cacheSet, Addr tag) const;
 
+    AbstractCacheEntry *&
+    entryAt(int64_t set, int way)
+    {
+        return m_cache[set * m_cache_assoc + way];
+    }
+
+    AbstractCacheEntry *
+    entryAt(int64_t set, int way) const
+    {
+        return m_cache[set * m_cache_assoc + way];
+    }
+
     // Private copy constructor and assignment operator
     CacheMemory(const CacheMemory& obj);
     CacheMemory& operator=(const CacheMemory& obj);
@@ -168,10 +180,11 @@ class CacheMemory : public SimObject
     // Data Members (m_prefix)
     bool m_is_instruction_only_cache;
 
-    // The first index is the # of cache lines.
-    // The second index is the the amount associativity.
-    std::unordered_map<Addr, int> m_tag_index;
-    std::vector<std::vector<AbstractCacheEntry*> > m_cache;
+    // Maps a line address to its way in the set it belongs to.
+    AddrHashMap<int> m_tag_index;
+    // The entry pointers of all sets, with the ways of each set stored
+    // next to each other. Use entryAt() to index it.
+    std::vector<AbstractCacheEntry*> m_cache;
 
     AbstractReplacementPolicy *m_replacementPolicy_ptr;
 
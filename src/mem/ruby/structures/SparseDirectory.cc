@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/structures/SparseDirectory.hh"
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "debug/RubyCache.hh"
+#include "mem/ruby/common/SharerSet.hh"
+#include "sim/core.hh"
+
+using namespace std;
+
+SparseDirectory::SparseDirectory(const Params *p)
+    : SimObject(p), m_num_entries(p->size), m_assoc(p->assoc),
+      m_start_index_bit(p->start_index_bit),
+      m_num_sharer_pointers(p->num_sharer_pointers), m_num_set_bits(0)
+{
+}
+
+SparseDirectory::~SparseDirectory()
+{
+    for (auto entry : m_entries)
+        delete entry;
+}
+
+void
+SparseDirectory::init()
+{
+    fatal_if(m_assoc < 1 || m_num_entries % m_assoc != 0,
+             "%s: %d entries cannot be split into %d-way sets.\n",
+             name(), m_num_entries, m_assoc);
+    int num_sets = m_num_entries / m_assoc;
+    fatal_if(!isPowerOf2(num_sets),
+             "%s: the number of sets (%d) must be a power of 2.\n",
+             name(), num_sets);
+    m_num_set_bits = floorLog2(num_sets);
+
+    m_entries.assign(m_num_entries, nullptr);
+    m_tags.assign(m_num_entries, 0);
+    m_last_touch.assign(m_num_entries, 0);
+
+    SharerSet::setNumPointers(m_num_sharer_pointers);
+}
+
+void
+SparseDirectory::regStats()
+{
+    SimObject::regStats();
+
+    m_allocations
+        .name(name() + ".allocations")
+        .desc("Number of directory entries allocated")
+        ;
+
+    m_deallocations
+        .name(name() + ".deallocations")
+        .desc("Number of directory entries deallocated")
+        ;
+
+    m_evictions
+        .name(name() + ".evictions")
+        .desc("Number of directory entries evicted to make room")
+        ;
+}
+
+int64_t
+SparseDirectory::addressToSet(Addr address) const
+{
+    if (m_num_set_bits == 0)
+        return 0;
+    return bitSelect(address, m_start_index_bit,
+                     m_start_index_bit + m_num_set_bits - 1);
+}
+
+int
+SparseDirectory::findIndex(Addr address) const
+{
+    int base = addressToSet(address) * m_assoc;
+    for (int i = base; i < base + m_assoc; i++) {
+        if (m_entries[i] != nullptr && m_tags[i] == address)
+            return i;
+    }
+    return -1;
+}
+
+bool
+SparseDirectory::isPresent(Addr address) const
+{
+    assert(address == makeLineAddress(address));
+    return findIndex(address) != -1;
+}
+
+AbstractEntry *
+SparseDirectory::lookup(Addr address)
+{
+    assert(address == makeLineAddress(address));
+    int idx = findIndex(address);
+    return idx == -1 ? nullptr : m_entries[idx];
+}
+
+AbstractEntry *
+SparseDirectory::allocate(Addr address, AbstractEntry *new_entry)
+{
+    assert(address == makeLineAddress(address));
+    assert(!isPresent(address));
+
+    int base = addressToSet(address) * m_assoc;
+    for (int i = base; i < base + m_assoc; i++) {
+        if (m_entries[i] == nullptr) {
+            DPRINTF(RubyCache, "%s: allocate set: %d way: %d for %#x\n",
+                    name(), base / m_assoc, i - base, address);
+            m_entries[i] = new_entry;
+            m_tags[i] = address;
+            m_last_touch[i] = curTick();
+            m_allocations++;
+            return new_entry;
+        }
+    }
+    panic("%s: allocate of %#x in a full set.\n", name(), address);
+}
+
+void
+SparseDirectory::deallocate(Addr address)
+{
+    assert(address == makeLineAddress(address));
+    int idx = findIndex(address);
+    assert(idx != -1);
+
+    DPRINTF(RubyCache, "%s: deallocate %#x\n", name(), address);
+    delete m_entries[idx];
+    m_entries[idx] = nullptr;
+    m_deallocations++;
+}
+
+bool
+SparseDirectory::cacheAvail(Addr address) const
+{
+    assert(address == makeLineAddress(address));
+    int base = addressToSet(address) * m_assoc;
+    for (int i = base; i < base + m_assoc; i++) {
+        if (m_entries[i] == nullptr)
+            return true;
+    }
+    return false;
+}
+
+Addr
+SparseDirectory::cacheProbe(Addr address)
+{
+    assert(address == makeLineAddress(address));
+    assert(!cacheAvail(address));
+
+    int base = addressToSet(address) * m_assoc;
+    int victim = base;
+    for (int i = base + 1; i < base + m_assoc; i++) {
+        if (m_last_touch[i] < m_last_touch[victim])
+            victim = i;
+    }
+    return m_tags[victim];
+}
+
+void
+SparseDirectory::setMRU(Addr address)
+{
+    int idx = findIndex(makeLineAddress(address));
+    if (idx != -1)
+        m_last_touch[idx] = curTick();
+}
+
+void
+SparseDirectory::recordEviction(Addr address)
+{
+    assert(isPresent(address));
+    DPRINTF(RubyCache, "%s: evict %#x\n", name(), address);
+    m_evictions++;
+}
+
+void
+SparseDirectory::print(ostream& out) const
+{
+    out << "SparseDirectory " << name() << ": " << m_num_entries
+        << " entries, " << m_assoc << "-way" << endl;
+}
+
+SparseDirectory *
+RubySparseDirectoryParams::create()
+{
+    return new SparseDirectory(this);
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_STRUCTURES_SPARSEDIRECTORY_HH__
+#define __MEM_RUBY_STRUCTURES_SPARSEDIRECTORY_HH__
+
+#include <iostream>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/ruby/common/Address.hh"
+#include "mem/ruby/slicc_interface/AbstractEntry.hh"
+#include "params/RubySparseDirectory.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * A set-associative directory cache that only holds entries for lines
+ * cached somewhere in the system, unlike DirectoryMemory which keeps an
+ * entry for every block of memory. Its capacity is fixed, so a protocol
+ * has to evict an entry, and invalidate the sharers it records, before
+ * it can allocate a new one in a full set. The interface follows that of
+ * CacheMemory: cacheAvail() tells whether a set has room, cacheProbe()
+ * names the victim, and deallocate() frees it. The protocol calls
+ * recordEviction() when it starts to evict the victim.
+ *
+ * Entries usually record their sharers in a SharerSet, which bounds the
+ * storage per entry however many caches there are.
+ */
+class SparseDirectory : public SimObject
+{
+  public:
+    typedef RubySparseDirectoryParams Params;
+    SparseDirectory(const Params *p);
+    ~SparseDirectory();
+
+    void init() override;
+    void regStats() override;
+
+    bool isPresent(Addr address) const;
+    AbstractEntry *lookup(Addr address);
+    AbstractEntry *allocate(Addr address, AbstractEntry *new_entry);
+    void deallocate(Addr address);
+
+    /** True if the set address maps to has a free way. */
+    bool cacheAvail(Addr address) const;
+    /**
+     * Return the line address of the entry to evict to make room for
+     * address. The set must be full.
+     */
+    Addr cacheProbe(Addr address);
+    /** Mark the entry of address as most recently used. */
+    void setMRU(Addr address);
+    /** Count the eviction of the entry of address to make room. */
+    void recordEviction(Addr address);
+
+    void print(std::ostream& out) const;
+
+  private:
+    SparseDirectory(const SparseDirectory& obj) = delete;
+    SparseDirectory& operator=(const SparseDirectory& obj) = delete;
+
+    int64_t addressToSet(Addr address) const;
+    // Index of the way holding address, or -1 if it is not present
+    int findIndex(Addr address) const;
+
+    const int m_num_entries;
+    const int m_assoc;
+    const int m_start_index_bit;
+    const int m_num_sharer_pointers;
+    int m_num_set_bits;
+
+    // Per-way state, indexed by set * m_assoc + way
+    std::vector<AbstractEntry *> m_entries;
+    std::vector<Addr> m_tags;
+    std::vector<Tick> m_last_touch;
+
+    Stats::Scalar m_allocations;
+    Stats::Scalar m_deallocations;
+    Stats::Scalar m_evictions;
+};
+
+inline std::ostream&
+operator<<(std::ostream& out, const SparseDirectory& obj)
+{
+    obj.print(out);
+    out << std::flush;
+    return out;
+}
+
+#endif // __MEM_RUBY_STRUCTURES_SPARSEDIRECTORY_HH__
@@ -29,9 +29,11 @@
 #ifndef __MEM_RUBY_STRUCTURES_TBETABLE_HH__
 #define __MEM_RUBY_STRUCTURES_TBETABLE_HH__
 
+#include <deque>
 #include <iostream>
-#include <unordered_map>
+#include <vector>
 
+#include "mem/ruby/common/AddrHashMap.hh"
 #include "mem/ruby/common/Address.hh"
 
 template<class ENTRY>
@@ -39,7 +41,7 @@ class TBETable
 {
   public:
     TBETable(int number_of_TBEs)
-        : m_number_of_TBEs(number_of_TBEs)
+        : m_map(number_of_TBEs), m_number_of_TBEs(number_of_TBEs)
     {
     }
 
@@ -63,7 +65,11 @@ class TBETable
     TBETable& operator=(const TBETable& obj);
 
     // Data Members (m_prefix)
-    std::unordered_map<Addr, ENTRY> m_map;
+    // Maps an address to the index of its TBE in m_entries. The TBEs
+    // themselves stay put, since protocols hold pointers to them.
+    AddrHashMap<int> m_map;
+    std::deque<ENTRY> m_entries;
+    std::vector<int> m_free_entries;
 
   private:
     int m_number_of_TBEs;
@@ -93,7 +99,13 @@ TBETable<ENTRY>::allocate(Addr address)
 {
     assert(!isPresent(address));
     assert(m_map.size() < m_number_of_TBEs);
-    m_map[address] = ENTRY();
+    if (m_free_entries.empty()) {
+        m_map[address] = m_entries.size();
+        m_entries.emplace_back();
+    } else {
+        m_map[address] = m_free_entries.back();
+        m_free_entries.pop_back();
+    }
 }
 
 template<class ENTRY>
@@ -102,7 +114,11 @@ TBETable<ENTRY>::deallocate(Addr address)
 {
     assert(isPresent(address));
     assert(m_map.size() > 0);
-    m_map.erase(address);
+    auto it = m_map.find(address);
+    // Reset the TBE so that it is released now and handed out clean
+    m_entries[it->second] = ENTRY();
+    m_free_entries.push_back(it->second);
+    m_map.erase(it);
 }
 
 // looks an address up in the cache
@@ -110,8 +126,10 @@ template<class ENTRY>
 inline ENTRY*
 TBETable<ENTRY>::lookup(Addr address)
 {
-  if (m_map.find(address) != m_map.end()) return &(m_map.find(address)->second);
-  return NULL;
+    auto it = m_map.find(address);
+    if (it != m_map.end())
+        return &m_entries[it->second];
+    return NULL;
 }
 
 
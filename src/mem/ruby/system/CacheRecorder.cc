@@ -29,12 +29,45 @@
 
 #include "mem/ruby/system/CacheRecorder.hh"
 
+#include <algorithm>
+#include <cstring>
+
 #include "debug/RubyCacheTrace.hh"
 #include "mem/ruby/system/RubySystem.hh"
 #include "mem/ruby/system/Sequencer.hh"
 
 using namespace std;
 
+namespace
+{
+
+void
+putVarint(vector<uint8_t> &buf, uint64_t val)
+{
+    while (val >= 0x80) {
+        buf.push_back((val & 0x7f) | 0x80);
+        val >>= 7;
+    }
+    buf.push_back(val);
+}
+
+uint64_t
+getVarint(const uint8_t *&pos, const uint8_t *end)
+{
+    uint64_t val = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos == end)
+            fatal("Truncated record in the Ruby cache trace\n");
+        uint8_t byte = *pos++;
+        val |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return val;
+    }
+    fatal("Malformed record in the Ruby cache trace\n");
+}
+
+} // anonymous namespace
+
 void
 TraceRecord::print(ostream& out) const
 {
@@ -44,22 +77,19 @@ TraceRecord::print(ostream& out) const
 }
 
 CacheRecorder::CacheRecorder()
-    : m_uncompressed_trace(NULL),
-      m_uncompressed_trace_size(0),
-      m_block_size_bytes(RubySystem::getBlockSizeBytes())
+    : m_block_size_bytes(RubySystem::getBlockSizeBytes())
 {
 }
 
 CacheRecorder::CacheRecorder(uint8_t* uncompressed_trace,
                              uint64_t uncompressed_trace_size,
                              std::vector<Sequencer*>& seq_map,
-                             uint64_t block_size_bytes)
-    : m_uncompressed_trace(uncompressed_trace),
-      m_uncompressed_trace_size(uncompressed_trace_size),
-      m_seq_map(seq_map),  m_bytes_read(0), m_records_read(0),
+                             uint64_t block_size_bytes,
+                             int trace_version)
+    : m_seq_map(seq_map), m_records_read(0),
       m_records_flushed(0), m_block_size_bytes(block_size_bytes)
 {
-    if (m_uncompressed_trace != NULL) {
+    if (uncompressed_trace != NULL) {
         if (m_block_size_bytes < RubySystem::getBlockSizeBytes()) {
             // Block sizes larger than when the trace was recorded are not
             // supported, as we cannot reliably turn accesses to smaller blocks
@@ -67,18 +97,101 @@ CacheRecorder::CacheRecorder(uint8_t* uncompressed_trace,
             panic("Recorded cache block size (%d) < current block size (%d) !!",
                     m_block_size_bytes, RubySystem::getBlockSizeBytes());
         }
+
+        readTrace(uncompressed_trace, uncompressed_trace_size,
+                  trace_version);
+        delete [] uncompressed_trace;
     }
 }
 
 CacheRecorder::~CacheRecorder()
 {
-    if (m_uncompressed_trace != NULL) {
-        delete [] m_uncompressed_trace;
-        m_uncompressed_trace = NULL;
+    for (auto rec : m_records) {
+        free(rec);
     }
+    m_records.clear();
     m_seq_map.clear();
 }
 
+TraceRecord*
+CacheRecorder::allocateRecord() const
+{
+    return (TraceRecord*)malloc(sizeof(TraceRecord) + m_block_size_bytes);
+}
+
+void
+CacheRecorder::readTrace(const uint8_t* trace, uint64_t trace_size,
+                         int trace_version)
+{
+    const uint8_t *pos = trace;
+    const uint8_t *end = trace + trace_size;
+
+    if (trace_version == 1) {
+        uint64_t record_size = sizeof(TraceRecord) + m_block_size_bytes;
+        for (; pos + record_size <= end; pos += record_size) {
+            TraceRecord* rec = allocateRecord();
+            memcpy(rec, pos, record_size);
+            m_records.push_back(rec);
+        }
+    } else if (trace_version == 2) {
+        Addr addr = 0;
+        while (pos < end) {
+            TraceRecord* rec = allocateRecord();
+            rec->m_cntrl_id = getVarint(pos, end);
+            rec->m_type = RubyRequestType(getVarint(pos, end));
+            // The address delta is zigzag encoded, in units of blocks
+            uint64_t delta = getVarint(pos, end);
+            addr += ((delta >> 1) ^ -(delta & 1)) * m_block_size_bytes;
+            rec->m_data_address = addr;
+            rec->m_pc_address = 0;
+            rec->m_time = 0;
+
+            if (end - pos < m_block_size_bytes)
+                fatal("Truncated record in the Ruby cache trace\n");
+            memcpy(rec->m_data, pos, m_block_size_bytes);
+            pos += m_block_size_bytes;
+
+            m_records.push_back(rec);
+        }
+    } else {
+        fatal("Unknown Ruby cache trace version %d\n", trace_version);
+    }
+
+    DPRINTF(RubyCacheTrace, "Read %d records from a version %d trace\n",
+            m_records.size(), trace_version);
+}
+
+uint64_t
+CacheRecorder::injectRecords(const std::vector<AbstractController*>& cntrls)
+{
+    // A line can only be written as a whole into a cache that uses the
+    // recorded block size.
+    if (m_block_size_bytes != RubySystem::getBlockSizeBytes())
+        return 0;
+
+    uint64_t injected = 0;
+    DataBlock data;
+    auto replay_end = m_records.begin();
+    for (auto rec : m_records) {
+        data.setData(rec->m_data, 0, m_block_size_bytes);
+        assert(rec->m_cntrl_id < cntrls.size());
+        if (cntrls[rec->m_cntrl_id]->injectCacheLine(rec->m_data_address,
+                                                     data, rec->m_type)) {
+            DPRINTF(RubyCacheTrace, "Injected %s\n", *rec);
+            free(rec);
+            injected++;
+        } else {
+            // Keep the lines to replay in their original order
+            *replay_end++ = rec;
+        }
+    }
+    m_records.erase(replay_end, m_records.end());
+
+    DPRINTF(RubyCacheTrace, "Injected %d records, %d left to fetch\n",
+            injected, m_records.size());
+    return injected;
+}
+
 void
 CacheRecorder::enqueueNextFlushRequest()
 {
@@ -104,9 +217,8 @@ CacheRecorder::enqueueNextFlushRequest()
 void
 CacheRecorder::enqueueNextFetchRequest()
 {
-    if (m_bytes_read < m_uncompressed_trace_size) {
-        TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
-                                                                m_bytes_read);
+    if (m_records_read < m_records.size()) {
+        TraceRecord* traceRecord = m_records[m_records_read];
 
         DPRINTF(RubyCacheTrace, "Issuing %s\n", *traceRecord);
 
@@ -138,7 +250,6 @@ CacheRecorder::enqueueNextFetchRequest()
             m_sequencer_ptr->makeRequest(pkt);
         }
 
-        m_bytes_read += (sizeof(TraceRecord) + m_block_size_bytes);
         m_records_read++;
     } else {
         DPRINTF(RubyCacheTrace, "Fetched all %d records\n", m_records_read);
@@ -149,8 +260,7 @@ void
 CacheRecorder::addRecord(int cntrl, Addr data_addr, Addr pc_addr,
                          RubyRequestType type, Tick time, DataBlock& data)
 {
-    TraceRecord* rec = (TraceRecord*)malloc(sizeof(TraceRecord) +
-                                            m_block_size_bytes);
+    TraceRecord* rec = allocateRecord();
     rec->m_cntrl_id     = cntrl;
     rec->m_time         = time;
     rec->m_data_address = data_addr;
@@ -167,33 +277,35 @@ CacheRecorder::aggregateRecords(uint8_t **buf, uint64_t total_size)
 {
     std::sort(m_records.begin(), m_records.end(), compareTraceRecords);
 
-    int size = m_records.size();
-    uint64_t current_size = 0;
-    int record_size = sizeof(TraceRecord) + m_block_size_bytes;
-
-    for (int i = 0; i < size; ++i) {
-        // Determine if we need to expand the buffer size
-        if (current_size + record_size > total_size) {
-            uint8_t* new_buf = new (nothrow) uint8_t[total_size * 2];
-            if (new_buf == NULL) {
-                fatal("Unable to allocate buffer of size %s\n",
-                      total_size * 2);
-            }
-            total_size = total_size * 2;
-            uint8_t* old_buf = *buf;
-            memcpy(new_buf, old_buf, current_size);
-            *buf = new_buf;
-            delete [] old_buf;
-        }
+    vector<uint8_t> trace;
+    Addr last_addr = 0;
 
-        // Copy the current record into the buffer
-        memcpy(&((*buf)[current_size]), m_records[i], record_size);
-        current_size += record_size;
+    for (auto rec : m_records) {
+        // Encode the records in the version 2 format
+        int64_t delta = (int64_t(rec->m_data_address) - int64_t(last_addr)) /
+            int64_t(m_block_size_bytes);
+        last_addr = rec->m_data_address;
 
-        free(m_records[i]);
-        m_records[i] = NULL;
-    }
+        putVarint(trace, rec->m_cntrl_id);
+        putVarint(trace, rec->m_type);
+        putVarint(trace, (uint64_t(delta) << 1) ^ uint64_t(delta >> 63));
+        trace.insert(trace.end(), rec->m_data,
+                     rec->m_data + m_block_size_bytes);
 
+        free(rec);
+    }
     m_records.clear();
-    return current_size;
+
+    // Determine if we need to expand the buffer size
+    if (trace.size() > total_size) {
+        uint8_t* new_buf = new (nothrow) uint8_t[trace.size()];
+        if (new_buf == NULL) {
+            fatal("Unable to allocate buffer of size %s\n", trace.size());
+        }
+        delete [] *buf;
+        *buf = new_buf;
+    }
+
+    memcpy(*buf, trace.data(), trace.size());
+    return trace.size();
 }
@@ -30,6 +30,13 @@
 /*
  * Recording cache requests made to a ruby cache at certain ruby
  * time. Also dump the requests to a gziped file.
+ *
+ * Two trace formats exist. Version 1 stores each TraceRecord as is,
+ * followed by its data block. Version 2 drops the fields that are not
+ * needed to restore the caches, and stores for each record the
+ * controller id and request type, and the line address as a delta
+ * from the previous record, all as variable-length integers, followed
+ * by the data block.
  */
 
 #ifndef __MEM_RUBY_SYSTEM_CACHERECORDER_HH__
@@ -43,6 +50,7 @@
 #include "mem/ruby/common/DataBlock.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 
+class AbstractController;
 class Sequencer;
 
 /*!
@@ -69,15 +77,27 @@ class CacheRecorder
     CacheRecorder();
     ~CacheRecorder();
 
+    /** The trace format written by aggregateRecords(). */
+    static const int TRACE_VERSION = 2;
+
     CacheRecorder(uint8_t* uncompressed_trace,
                   uint64_t uncompressed_trace_size,
                   std::vector<Sequencer*>& SequencerMap,
-                  uint64_t block_size_bytes);
+                  uint64_t block_size_bytes,
+                  int trace_version);
     void addRecord(int cntrl, Addr data_addr, Addr pc_addr,
                    RubyRequestType type, Tick time, DataBlock& data);
 
     uint64_t aggregateRecords(uint8_t **data, uint64_t size);
 
+    /*!
+     * Function for writing the restored cache lines straight into the
+     * caches of the controllers that recorded them, for the protocols
+     * that support it. Lines that are injected are not fetched again by
+     * enqueueNextFetchRequest(). Returns the number of lines injected.
+     */
+    uint64_t injectRecords(const std::vector<AbstractController*>& cntrls);
+
     /*!
      * Function for flushing the memory contents of the caches to the
      * main memory. It goes through the recorded contents of the caches,
@@ -102,11 +122,12 @@ class CacheRecorder
     CacheRecorder(const CacheRecorder& obj);
     CacheRecorder& operator=(const CacheRecorder& obj);
 
+    void readTrace(const uint8_t* trace, uint64_t trace_size,
+                   int trace_version);
+    TraceRecord* allocateRecord() const;
+
     std::vector<TraceRecord*> m_records;
-    uint8_t* m_uncompressed_trace;
-    uint64_t m_uncompressed_trace_size;
     std::vector<Sequencer*> m_seq_map;
-    uint64_t m_bytes_read;
     uint64_t m_records_read;
     uint64_t m_records_flushed;
     uint64_t m_block_size_bytes;
@@ -101,7 +101,8 @@ RubySystem::~RubySystem()
 void
 RubySystem::makeCacheRecorder(uint8_t *uncompressed_trace,
                               uint64_t cache_trace_size,
-                              uint64_t block_size_bytes)
+                              uint64_t block_size_bytes,
+                              int cache_trace_version)
 {
     vector<Sequencer*> sequencer_map;
     Sequencer* sequencer_ptr = NULL;
@@ -128,7 +129,8 @@ RubySystem::makeCacheRecorder(uint8_t *uncompressed_trace,
 
     // Create the CacheRecorder and record the cache trace
     m_cache_recorder = new CacheRecorder(uncompressed_trace, cache_trace_size,
-                                         sequencer_map, block_size_bytes);
+                                         sequencer_map, block_size_bytes,
+                                         cache_trace_version);
 }
 
 void
@@ -138,7 +140,8 @@ RubySystem::memWriteback()
 
     // Make the trace so we know what to write back.
     DPRINTF(RubyCacheTrace, "Recording Cache Trace\n");
-    makeCacheRecorder(NULL, 0, getBlockSizeBytes());
+    makeCacheRecorder(NULL, 0, getBlockSizeBytes(),
+                      CacheRecorder::TRACE_VERSION);
     for (int cntrl = 0; cntrl < m_abs_cntrl_vec.size(); cntrl++) {
         m_abs_cntrl_vec[cntrl]->recordCacheTrace(cntrl, m_cache_recorder);
     }
@@ -255,8 +258,10 @@ RubySystem::serialize(CheckpointOut &cp) const
     string cache_trace_file = name() + ".cache.gz";
     writeCompressedTrace(raw_data, cache_trace_file, cache_trace_size);
 
+    int cache_trace_version = CacheRecorder::TRACE_VERSION;
     SERIALIZE_SCALAR(cache_trace_file);
     SERIALIZE_SCALAR(cache_trace_size);
+    SERIALIZE_SCALAR(cache_trace_version);
 }
 
 void
@@ -319,13 +324,18 @@ RubySystem::unserialize(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(cache_trace_size);
     cache_trace_file = cp.cptDir + "/" + cache_trace_file;
 
+    // Checkpoints that predate the version field use the first format
+    int cache_trace_version = 1;
+    UNSERIALIZE_OPT_SCALAR(cache_trace_version);
+
     readCompressedTrace(cache_trace_file, uncompressed_trace,
                         cache_trace_size);
     m_warmup_enabled = true;
     m_systems_to_warmup++;
 
     // Create the cache recorder that will hang around until startup.
-    makeCacheRecorder(uncompressed_trace, cache_trace_size, block_size_bytes);
+    makeCacheRecorder(uncompressed_trace, cache_trace_size, block_size_bytes,
+                      cache_trace_version);
 }
 
 void
@@ -358,6 +368,10 @@ RubySystem::startup()
         setCurTick(0);
         resetClock();
 
+        // Write the lines the protocols can take straight into the caches
+        // and only replay the remaining ones
+        m_cache_recorder->injectRecords(m_abs_cntrl_vec);
+
         // Schedule an event to start cache warmup
         enqueueRubyEvent(curTick());
         simulate();
@@ -78,6 +78,10 @@ SimpleMemory::recvAtomic(PacketPtr pkt)
     panic_if(pkt->cacheResponding(), "Should not see packets where cache "
              "is responding");
 
+    if (pkt->isRead() || pkt->isWrite())
+        traceAccess(curTick(), pkt->cmd, pkt->getAddr(), pkt->getSize(),
+                    pkt->req->masterId());
+
     access(pkt);
     return getLatency();
 }
@@ -46,6 +46,7 @@ python_class_map = {
                     "VIPERCoalescer" : "VIPERCoalescer",
                     "DirectoryMemory": "RubyDirectoryMemory",
                     "PerfectCacheMemory": "RubyPerfectCacheMemory",
+                    "SparseDirectory": "RubySparseDirectory",
                     "MemoryControl": "MemoryControl",
                     "MessageBuffer": "MessageBuffer",
                     "DMASequencer": "DMASequencer",
@@ -44,17 +44,115 @@
 
 #include "mem/snoop_filter.hh"
 
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/SnoopFilter.hh"
 #include "sim/system.hh"
 
+SnoopFilter::SnoopFilter(const SnoopFilterParams *p)
+    : SimObject(p), reqLookupResult(nullptr), reqLookupAddr(MaxAddr),
+      retryItem{0, 0}, linesize(p->system->cacheLineSize()),
+      lookupLatency(p->lookup_latency),
+      maxEntryCount(p->max_capacity / p->system->cacheLineSize()),
+      assoc(p->assoc), numSets(assoc ? maxEntryCount / assoc : 0),
+      accessCount(0), replacedSlot(nullptr),
+      backInvMasterId(assoc ? p->system->getMasterId(name()) :
+                      MasterID(Request::invldMasterId))
+{
+    if (isBounded()) {
+        fatal_if(assoc > maxEntryCount, "Snoop filter associativity %d is "
+                 "larger than its capacity of %d entries\n", assoc,
+                 maxEntryCount);
+        fatal_if(!isPowerOf2(numSets), "Snoop filter with %d entries and "
+                 "associativity %d needs a power of 2 number of sets\n",
+                 maxEntryCount, assoc);
+
+        entries.resize(numSets * assoc, SnoopEntry{MaxAddr, {0, 0}, 0});
+    }
+}
+
+SnoopFilter::SnoopItem*
+SnoopFilter::findItem(Addr line_addr)
+{
+    if (!isBounded()) {
+        auto sf_it = cachedLocations.find(line_addr);
+        return sf_it != cachedLocations.end() ? &sf_it->second : nullptr;
+    }
+
+    const unsigned set = (line_addr / linesize) & (numSets - 1);
+    for (unsigned way = 0; way < assoc; ++way) {
+        SnoopEntry& entry = entries[set * assoc + way];
+        if (entry.lineAddr == line_addr) {
+            entry.lastTouch = ++accessCount;
+            return &entry.item;
+        }
+    }
+    return nullptr;
+}
+
+SnoopFilter::SnoopItem*
+SnoopFilter::allocateItem(Addr line_addr)
+{
+    if (!isBounded())
+        return &cachedLocations.emplace(line_addr, SnoopItem()).first->second;
+
+    // Prefer an unused entry, and otherwise replace the least
+    // recently used one among those without in-flight requests, as
+    // the requesters of the latter rely on the entry when their
+    // response comes back
+    const unsigned set = (line_addr / linesize) & (numSets - 1);
+    SnoopEntry* victim = nullptr;
+    for (unsigned way = 0; way < assoc; ++way) {
+        SnoopEntry& entry = entries[set * assoc + way];
+        if (entry.lineAddr == MaxAddr) {
+            victim = &entry;
+            break;
+        }
+        if (!entry.item.requested &&
+            (!victim || entry.lastTouch < victim->lastTouch)) {
+            victim = &entry;
+        }
+    }
+
+    fatal_if(!victim, "%s: all %d ways of snoop filter set %d have "
+             "outstanding requests, increase the associativity\n",
+             name(), assoc, set);
+
+    // The replacement only takes effect in finishRequest, as the
+    // request may still be retried
+    if (victim->lineAddr != MaxAddr) {
+        DPRINTF(SnoopFilter, "%s:   Replacing SF entry %#llx value %x.%x\n",
+                __func__, victim->lineAddr, victim->item.requested,
+                victim->item.holder);
+        assert(!replacedSlot);
+        replacedEntry = *victim;
+        replacedSlot = victim;
+    }
+
+    victim->lineAddr = line_addr;
+    victim->item = SnoopItem{0, 0};
+    victim->lastTouch = ++accessCount;
+    return &victim->item;
+}
+
 void
-SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
+SnoopFilter::eraseIfNullEntry(Addr line_addr, SnoopItem* sf_item)
 {
-    SnoopItem& sf_item = sf_it->second;
-    if (!(sf_item.requested | sf_item.holder)) {
-        cachedLocations.erase(sf_it);
+    if (!(sf_item->requested | sf_item->holder)) {
+        if (!isBounded()) {
+            cachedLocations.erase(line_addr);
+        } else {
+            const unsigned set = (line_addr / linesize) & (numSets - 1);
+            for (unsigned way = 0; way < assoc; ++way) {
+                SnoopEntry& entry = entries[set * assoc + way];
+                if (entry.lineAddr == line_addr) {
+                    assert(&entry.item == sf_item);
+                    entry.lineAddr = MaxAddr;
+                    break;
+                }
+            }
+        }
         DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
                 __func__);
     }
@@ -74,19 +172,22 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
         line_addr |= LineSecure;
     }
     SnoopMask req_port = portToMask(slave_port);
-    reqLookupResult = cachedLocations.find(line_addr);
-    bool is_hit = (reqLookupResult != cachedLocations.end());
+    reqLookupAddr = line_addr;
+    reqLookupResult = findItem(line_addr);
+    bool is_hit = (reqLookupResult != nullptr);
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
-    // portlist.
-    if (!is_hit && !allocate)
+    // portlist. A bounded filter may also have dropped the line
+    // before the eviction of the last copy reaches us, and there is
+    // no point in tracking a line that is going away.
+    if (!is_hit && (!allocate || (isBounded() && cpkt->isEviction())))
         return snoopDown(lookupLatency);
 
-    // If no hit in snoop filter create a new element and update iterator
+    // If no hit in snoop filter create a new element and update pointer
     if (!is_hit)
-        reqLookupResult = cachedLocations.emplace(line_addr, SnoopItem()).first;
-    SnoopItem& sf_item = reqLookupResult->second;
+        reqLookupResult = allocateItem(line_addr);
+    SnoopItem& sf_item = *reqLookupResult;
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
     // Store unmodified value of snoop filter item in temp storage in
@@ -133,8 +234,10 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
         }
     } else { // if (!cpkt->needsResponse())
         assert(cpkt->isEviction());
-        // make sure that the sender actually had the line
-        panic_if(!(sf_item.holder & req_port), "requester %x is not a " \
+        // make sure that the sender actually had the line, unless
+        // the entry was replaced and allocated again in the meantime
+        panic_if(!isBounded() && !(sf_item.holder & req_port),
+                 "requester %x is not a " \
                  "holder :( SF value %x.%x\n", req_port,
                  sf_item.requested, sf_item.holder);
         // CleanEvicts and Writebacks -> the sender and all caches above
@@ -152,28 +255,60 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 void
 SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
 {
-    if (reqLookupResult != cachedLocations.end()) {
+    if (reqLookupResult) {
         // since we rely on the caller, do a basic check to ensure
         // that finishRequest is being called following lookupRequest
         Addr line_addr = (addr & ~(Addr(linesize - 1)));
         if (is_secure) {
             line_addr |= LineSecure;
         }
-        assert(reqLookupResult->first == line_addr);
+        assert(reqLookupAddr == line_addr);
+        if (will_retry && replacedSlot) {
+            // Undo the replacement of another entry, which also drops
+            // the entry allocated for this request
+            *replacedSlot = replacedEntry;
+            replacedSlot = nullptr;
+
+            DPRINTF(SnoopFilter, "%s:   restored SF entry %#llx\n",
+                    __func__, replacedEntry.lineAddr);
+            reqLookupResult = nullptr;
+            return;
+        }
+
         if (will_retry) {
             // Undo any changes made in lookupRequest to the snoop filter
             // entry if the request will come again. retryItem holds
             // the previous value of the snoopfilter entry.
-            reqLookupResult->second = retryItem;
+            *reqLookupResult = retryItem;
 
             DPRINTF(SnoopFilter, "%s:   restored SF value %x.%x\n",
                     __func__,  retryItem.requested, retryItem.holder);
         }
 
-        eraseIfNullEntry(reqLookupResult);
+        if (replacedSlot) {
+            commitReplacement();
+        }
+
+        eraseIfNullEntry(reqLookupAddr, reqLookupResult);
+        reqLookupResult = nullptr;
     }
 }
 
+void
+SnoopFilter::commitReplacement()
+{
+    capacityEvictions++;
+    if (replacedEntry.item.holder) {
+        SnoopList ports = maskToPortList(replacedEntry.item.holder);
+        backInvalidatedLines++;
+        backInvalidationSnoops += ports.size();
+        backInvalidations.push_back(BackInvalidation{
+                replacedEntry.lineAddr & ~Addr(LineSecure),
+                bool(replacedEntry.lineAddr & LineSecure), ports});
+    }
+    replacedSlot = nullptr;
+}
+
 std::pair<SnoopFilter::SnoopList, Cycles>
 SnoopFilter::lookupSnoop(const Packet* cpkt)
 {
@@ -185,10 +320,11 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
+    SnoopItem* sf_it = findItem(line_addr);
+    bool is_hit = (sf_it != nullptr);
 
-    panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
+    panic_if(!is_hit && !isBounded() &&
+             (cachedLocations.size() >= maxEntryCount),
              "snoop filter exceeded capacity of %d cache blocks\n",
              maxEntryCount);
 
@@ -198,7 +334,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (!is_hit)
         return snoopDown(lookupLatency);
 
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_it;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
@@ -229,9 +365,9 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
         sf_item.holder = 0;
     }
 
-    eraseIfNullEntry(sf_it);
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x interest: %x \n",
             __func__, sf_item.requested, sf_item.holder, interested);
+    eraseIfNullEntry(line_addr, sf_it);
 
     return snoopSelected(maskToPortList(interested), lookupLatency);
 }
@@ -260,7 +396,9 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     }
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    SnoopItem* sf_it = findItem(line_addr);
+    panic_if(!sf_it, "SF has no entry for %#llx\n", line_addr);
+    SnoopItem& sf_item = *sf_it;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -306,14 +444,13 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = sf_it != cachedLocations.end();
+    SnoopItem* sf_it = findItem(line_addr);
 
     // Nothing to do if it is not a hit
-    if (!is_hit)
+    if (!sf_it)
         return;
 
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_it;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -326,8 +463,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     }
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
-    eraseIfNullEntry(sf_it);
-
+    eraseIfNullEntry(line_addr, sf_it);
 }
 
 void
@@ -348,12 +484,12 @@ SnoopFilter::updateResponse(const Packet* cpkt, const SlavePort& slave_port)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    if (sf_it == cachedLocations.end())
+    SnoopItem* sf_it = findItem(line_addr);
+    if (!sf_it)
         return;
 
     SnoopMask slave_mask = portToMask(slave_port);
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_it;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -371,7 +507,7 @@ SnoopFilter::updateResponse(const Packet* cpkt, const SlavePort& slave_port)
         if (cpkt->isInvalidate()) {
             sf_item.holder &= ~slave_mask;
         }
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_it);
     } else {
         // Any other response implies that a cache above will have the
         // block.
@@ -414,6 +550,24 @@ SnoopFilter::regStats()
         .name(name() + ".hit_multi_snoops")
         .desc("Number of snoops hitting in the snoop filter with multiple "\
               "(>1) holders of the requested data.");
+
+    capacityEvictions
+        .name(name() + ".capacity_evictions")
+        .desc("Number of entries replaced due to the limited capacity "\
+              "of a bounded snoop filter.")
+        .flags(Stats::nozero);
+
+    backInvalidatedLines
+        .name(name() + ".back_invalidated_lines")
+        .desc("Number of replaced entries that required invalidation of "\
+              "the cached copies above.")
+        .flags(Stats::nozero);
+
+    backInvalidationSnoops
+        .name(name() + ".back_invalidation_snoops")
+        .desc("Number of invalidating snoops sent due to replaced "\
+              "entries.")
+        .flags(Stats::nozero);
 }
 
 SnoopFilter *
@@ -47,6 +47,7 @@
 
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "mem/packet.hh"
 #include "mem/port.hh"
@@ -83,17 +84,34 @@
  *     upper cache dropped a line, making the snoop filter pessimistic for now
  * (4) ordering: there is no single point of order in the system.  Instead,
  *     requesting MSHRs track order between local requests and remote snoops
+ *
+ * By default the filter is an unbounded hash map, and exceeding the
+ * configured capacity is treated as an error. When an associativity
+ * is given, the filter instead becomes a set-associative structure of
+ * fixed size, with LRU replacement among the entries that have no
+ * in-flight requests. Entries that are replaced while still tracking
+ * holders are recorded as back-invalidations, and the enclosing
+ * crossbar is responsible for sending the corresponding cleaning and
+ * invalidating snoops to those holders.
  */
 class SnoopFilter : public SimObject {
   public:
     typedef std::vector<QueuedSlavePort*> SnoopList;
 
-    SnoopFilter (const SnoopFilterParams *p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()), retryItem{0, 0},
-        linesize(p->system->cacheLineSize()), lookupLatency(p->lookup_latency),
-        maxEntryCount(p->max_capacity / p->system->cacheLineSize())
-    {
-    }
+    /**
+     * A line that was dropped from a bounded snoop filter while
+     * still being tracked as present in one or more caches above.
+     */
+    struct BackInvalidation {
+        /** Block-aligned address of the line */
+        Addr addr;
+        /** Whether the line is from the secure memory space */
+        bool isSecure;
+        /** Ports that have to be snooped to remove the line */
+        SnoopList ports;
+    };
+
+    SnoopFilter (const SnoopFilterParams *p);
 
     /**
      * Init a new snoop filter and tell it about all the slave ports
@@ -192,6 +210,26 @@ class SnoopFilter : public SimObject {
      */
     void updateResponse(const Packet *cpkt, const SlavePort& slave_port);
 
+    /**
+     * Get the back-invalidations caused by entries that were replaced
+     * since the last call. Replacements are only final once
+     * finishRequest is called for a request that is not retried. The
+     * caller is expected to send the invalidating snoops and then
+     * clear the list.
+     *
+     * @return List of pending back-invalidations.
+     */
+    std::vector<BackInvalidation>& getBackInvalidations()
+    {
+        return backInvalidations;
+    }
+
+    /**
+     * Master id used for the back-invalidation snoops issued on
+     * behalf of this snoop filter.
+     */
+    MasterID backInvalidationMasterId() const { return backInvMasterId; }
+
     virtual void regStats();
 
   protected:
@@ -253,18 +291,58 @@ class SnoopFilter : public SimObject {
 
   private:
 
+    /**
+     * An entry of the bounded, set-associative filter storage. The
+     * line address of an unused entry is MaxAddr.
+     */
+    struct SnoopEntry {
+        Addr lineAddr;
+        SnoopItem item;
+        uint64_t lastTouch;
+    };
+
+    /** Is the filter limited to a fixed number of entries? */
+    bool isBounded() const { return assoc != 0; }
+
+    /**
+     * Find the item tracking a line, if any.
+     *
+     * @param line_addr Line address, including the status bits.
+     * @return Pointer to the item, or nullptr on a miss.
+     */
+    SnoopItem* findItem(Addr line_addr);
+
+    /**
+     * Create a new, empty item for a line that is not yet tracked. In
+     * a bounded filter this may replace another entry, which is kept
+     * aside until finishRequest either restores or drops it.
+     *
+     * @param line_addr Line address, including the status bits.
+     * @return Pointer to the new item.
+     */
+    SnoopItem* allocateItem(Addr line_addr);
+
+    /**
+     * Drop the entry replaced by the last lookupRequest for good, and
+     * record its holders as a back-invalidation.
+     */
+    void commitReplacement();
+
     /**
      * Removes snoop filter items which have no requesters and no holders.
      */
-    void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
+    void eraseIfNullEntry(Addr line_addr, SnoopItem* sf_item);
 
-    /** Simple hash set of cached addresses. */
+    /** Simple hash set of cached addresses, for the unbounded filter. */
     SnoopFilterCache cachedLocations;
+    /** Entry storage for the bounded filter, organised as [set][way]. */
+    std::vector<SnoopEntry> entries;
     /**
-     * Iterator used to store the result from lookupRequest until we
-     * call finishRequest.
+     * Item and line address used to store the result from
+     * lookupRequest until we call finishRequest.
      */
-    SnoopFilterCache::iterator reqLookupResult;
+    SnoopItem* reqLookupResult;
+    Addr reqLookupAddr;
     /**
      * Variable to temporarily store value of snoopfilter entry
      * incase finishRequest needs to undo changes made in lookupRequest
@@ -281,6 +359,22 @@ class SnoopFilter : public SimObject {
     const Cycles lookupLatency;
     /** Max capacity in terms of cache blocks tracked, for sanity checking */
     const unsigned maxEntryCount;
+    /** Associativity of the bounded filter, 0 if unbounded */
+    const unsigned assoc;
+    /** Number of sets of the bounded filter */
+    const unsigned numSets;
+    /** Timestamp source for the LRU replacement of bounded entries */
+    uint64_t accessCount;
+    /**
+     * Entry replaced by the allocation in lookupRequest, and the slot
+     * it was in, or nullptr if nothing was replaced.
+     */
+    SnoopEntry replacedEntry;
+    SnoopEntry* replacedSlot;
+    /** Master id used for back-invalidation snoops */
+    const MasterID backInvMasterId;
+    /** Replaced lines that still need to be invalidated above */
+    std::vector<BackInvalidation> backInvalidations;
 
     /**
      * Use the lower bits of the address to keep track of the line status
@@ -298,6 +392,10 @@ class SnoopFilter : public SimObject {
     Stats::Scalar totSnoops;
     Stats::Scalar hitSingleSnoops;
     Stats::Scalar hitMultiSnoops;
+
+    Stats::Scalar capacityEvictions;
+    Stats::Scalar backInvalidatedLines;
+    Stats::Scalar backInvalidationSnoops;
 };
 
 inline SnoopFilter::SnoopMask
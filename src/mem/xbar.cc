@@ -54,6 +54,7 @@
 #include "debug/AddrRanges.hh"
 #include "debug/Drain.hh"
 #include "debug/XBar.hh"
+#include "debug/XBarLayer.hh"
 
 BaseXBar::BaseXBar(const BaseXBarParams *p)
     : MemObject(p),
@@ -61,6 +62,7 @@ BaseXBar::BaseXBar(const BaseXBarParams *p)
       forwardLatency(p->forward_latency),
       responseLatency(p->response_latency),
       width(p->width),
+      retryBatch(p->retry_batch),
       gotAddrRanges(p->port_default_connection_count +
                           p->port_master_connection_count, false),
       gotAllAddrRanges(false), defaultPortID(InvalidPortID),
@@ -147,7 +149,8 @@ template <typename SrcType, typename DstType>
 BaseXBar::Layer<SrcType,DstType>::Layer(DstType& _port, BaseXBar& _xbar,
                                        const std::string& _name) :
     port(_port), xbar(_xbar), _name(_name), state(IDLE),
-    waitingForPeer(NULL), releaseEvent([this]{ releaseLayer(); }, name())
+    waitingForPeer(NULL), releaseEvent([this]{ releaseLayer(); }, name()),
+    peerStallStart(0)
 {
 }
 
@@ -169,6 +172,9 @@ void BaseXBar::Layer<SrcType,DstType>::occupyLayer(Tick until)
 
     DPRINTF(BaseXBar, "The crossbar layer is now busy from tick %d to %d\n",
             curTick(), until);
+    DPRINTF(XBarLayer, "%s: busy %d ticks, %d waiting%s\n", name(),
+            until - curTick(), waitingForLayer.size(),
+            waitingForPeer ? ", stalled on peer" : "");
 }
 
 template <typename SrcType, typename DstType>
@@ -194,6 +200,7 @@ BaseXBar::Layer<SrcType,DstType>::tryTiming(SrcType* src_port)
         // that transaction to go through, and then the layer to free
         // up)
         waitingForLayer.push_back(src_port);
+        waitingPorts = waitingForLayer.size();
         return false;
     }
 
@@ -227,6 +234,8 @@ BaseXBar::Layer<SrcType,DstType>::failedTiming(SrcType* src_port,
     // failed in forwarding and should track that we are now waiting
     // for the peer to send a retry
     waitingForPeer = src_port;
+    peerStallStart = curTick();
+    peerStalls++;
 
     // we should have gone from idle or retry to busy in the tryTiming
     // test
@@ -270,28 +279,47 @@ BaseXBar::Layer<SrcType,DstType>::retryWaiting()
     // we always go to retrying from idle
     assert(state == IDLE);
 
-    // update the state
-    state = RETRY;
-
-    // set the retrying port to the front of the retry list and pop it
-    // off the list
-    SrcType* retryingPort = waitingForLayer.front();
-    waitingForLayer.pop_front();
-
-    // tell the port to retry, which in some cases ends up calling the
-    // layer again
-    sendRetry(retryingPort);
+    for (unsigned granted = 1; ; ++granted) {
+        // update the state
+        state = RETRY;
+
+        // set the retrying port to the front of the retry list and pop
+        // it off the list
+        SrcType* retryingPort = waitingForLayer.front();
+        waitingForLayer.pop_front();
+        waitingPorts = waitingForLayer.size();
+        retries++;
+
+        // tell the port to retry, which in some cases ends up calling
+        // the layer again
+        sendRetry(retryingPort);
+
+        // If the layer is no longer in the retry state, sendTiming was
+        // called in zero time and we are done
+        if (state != RETRY)
+            return;
+
+        // sendTiming wasn't called in zero time (e.g. the cache does
+        // this when a writeback is squashed)
+        ignoredRetries++;
+        Tick until = xbar.clockEdge();
+
+        // if the layer would be released in this very tick, with
+        // someone else waiting, we may as well retry the next port
+        // straight away, as the release event would do the same
+        if (until == curTick() && granted < xbar.retryBatch &&
+            !waitingForLayer.empty()) {
+            state = IDLE;
+            continue;
+        }
 
-    // If the layer is still in the retry state, sendTiming wasn't
-    // called in zero time (e.g. the cache does this when a writeback
-    // is squashed)
-    if (state == RETRY) {
         // update the state to busy and reset the retrying port, we
         // have done our bit and sent the retry
         state = BUSY;
 
         // occupy the crossbar layer until the next clock edge
-        occupyLayer(xbar.clockEdge());
+        occupyLayer(until);
+        return;
     }
 }
 
@@ -307,9 +335,13 @@ BaseXBar::Layer<SrcType,DstType>::recvRetry()
     // the waiting ports for the layer, this allows us to call retry
     // on the port immediately if the crossbar layer is idle
     waitingForLayer.push_front(waitingForPeer);
+    waitingPorts = waitingForLayer.size();
 
     // we are no longer waiting for the peer
     waitingForPeer = NULL;
+    peerStallTicks += curTick() - peerStallStart;
+    DPRINTF(XBarLayer, "%s: peer stall of %d ticks over\n", name(),
+            curTick() - peerStallStart);
 
     // if the layer is idle, retry this port straight away, if we
     // are busy, then simply let the port wait for its turn
@@ -620,6 +652,32 @@ BaseXBar::Layer<SrcType,DstType>::regStats()
         .flags(nozero);
 
     utilization = 100 * occupancy / simTicks;
+
+    retries
+        .name(name() + ".retries")
+        .desc("Number of retries sent to ports waiting for the layer")
+        .flags(nozero);
+
+    ignoredRetries
+        .name(name() + ".ignored_retries")
+        .desc("Number of retries not taken up in zero time")
+        .flags(nozero);
+
+    peerStalls
+        .name(name() + ".peer_stalls")
+        .desc("Number of packets refused by the destination port")
+        .flags(nozero);
+
+    peerStallTicks
+        .name(name() + ".peer_stall_ticks")
+        .desc("Time spent waiting for a retry from the destination port "
+              "(ticks)")
+        .flags(nozero);
+
+    waitingPorts
+        .name(name() + ".waiting_ports")
+        .desc("Average number of ports waiting for the layer")
+        .flags(nozero);
 }
 
 /**
@@ -159,7 +159,12 @@ class BaseXBar : public MemObject
 
         /**
          * Send a retry to the port at the head of waitingForLayer. The
-         * caller must ensure that the list is not empty.
+         * caller must ensure that the list is not empty. If the port
+         * does not take up the retry in zero time, and the layer would
+         * be released again in the current tick, further waiting ports
+         * are retried directly, up to the retry batch size of the
+         * crossbar, rather than by scheduling a release event for each
+         * of them.
          */
         void retryWaiting();
 
@@ -239,6 +244,9 @@ class BaseXBar : public MemObject
         /** event used to schedule a release of the layer */
         EventFunctionWrapper releaseEvent;
 
+        /** Tick at which the layer started waiting for the peer */
+        Tick peerStallStart;
+
         /**
          * Stats for occupancy and utilization. These stats capture
          * the time the layer spends in the busy state and are thus only
@@ -247,6 +255,17 @@ class BaseXBar : public MemObject
         Stats::Scalar occupancy;
         Stats::Formula utilization;
 
+        /**
+         * Stats for the back pressure seen by the layer, i.e. ports
+         * waiting for the layer, and the layer waiting for the
+         * destination port.
+         */
+        Stats::Scalar retries;
+        Stats::Scalar ignoredRetries;
+        Stats::Scalar peerStalls;
+        Stats::Scalar peerStallTicks;
+        Stats::Average waitingPorts;
+
     };
 
     class ReqLayer : public Layer<SlavePort,MasterPort>
@@ -318,6 +337,11 @@ class BaseXBar : public MemObject
     const Cycles responseLatency;
     /** the width of the xbar in bytes */
     const uint32_t width;
+    /**
+     * Maximum number of waiting ports a layer retries within one
+     * tick before falling back to a release event
+     */
+    const unsigned retryBatch;
 
     AddrRangeMap<PortID> portMap;
 
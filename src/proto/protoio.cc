@@ -44,7 +44,8 @@
 using namespace std;
 using namespace google::protobuf;
 
-ProtoOutputStream::ProtoOutputStream(const string& filename) :
+ProtoOutputStream::ProtoOutputStream(const string& filename,
+                                     int block_size) :
     fileStream(filename.c_str(), ios::out | ios::binary | ios::trunc),
     wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL)
 {
@@ -57,7 +58,11 @@ ProtoOutputStream::ProtoOutputStream(const string& filename) :
     wrappedFileStream = new io::OstreamOutputStream(&fileStream);
     if (filename.find_last_of('.') != string::npos &&
         filename.substr(filename.find_last_of('.') + 1) == "gz") {
-        gzipStream = new io::GzipOutputStream(wrappedFileStream);
+        // larger blocks compress better and call zlib less often
+        io::GzipOutputStream::Options options;
+        if (block_size > 0)
+            options.buffer_size = block_size;
+        gzipStream = new io::GzipOutputStream(wrappedFileStream, options);
         zeroCopyStream = gzipStream;
     } else {
         zeroCopyStream = wrappedFileStream;
@@ -99,8 +99,9 @@ class ProtoOutputStream : public ProtoStream
      * ends with .gz then the file will be compressed accordinly.
      *
      * @param filename Path to the file to create or truncate
+     * @param block_size Size of the compressed blocks, zero for default
      */
-    ProtoOutputStream(const std::string& filename);
+    ProtoOutputStream(const std::string& filename, int block_size = 0);
 
     /**
      * Destruct the output stream, and also flush and close the
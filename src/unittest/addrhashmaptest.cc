@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <map>
+#include <random>
+#include <vector>
+
+#include "mem/ruby/common/AddrHashMap.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+
+// The home slot of a key in a table of 2^bits slots, as computed by
+// AddrHashMap, used to build probe runs that wrap around the table
+static size_t
+home(Addr key, int bits)
+{
+    return (key * 0x9e3779b97f4a7c15ULL) >> (64 - bits);
+}
+
+// Line addresses whose home is the last slot of the initial table
+static vector<Addr>
+lastSlotKeys(unsigned n)
+{
+    vector<Addr> keys;
+    for (Addr line = 0; keys.size() < n; ++line) {
+        if (home(line << 6, 3) == 7)
+            keys.push_back(line << 6);
+    }
+    return keys;
+}
+
+int
+main(int argc, char *argv[])
+{
+    UnitTest::setCase("Insert and find");
+    {
+        AddrHashMap<int> m;
+        EXPECT_TRUE(m.empty());
+        EXPECT_TRUE(m.find(0x40) == m.end());
+
+        auto res = m.insert(make_pair(0x40, 1));
+        EXPECT_TRUE(res.second);
+        EXPECT_EQ(res.first->first, 0x40);
+        EXPECT_EQ(res.first->second, 1);
+
+        // A second insert of the same key keeps the first value
+        res = m.insert(make_pair(0x40, 2));
+        EXPECT_FALSE(res.second);
+        EXPECT_EQ(res.first->second, 1);
+
+        m[0x80] = 3;
+        EXPECT_EQ(m.size(), 2);
+        EXPECT_EQ(m.count(0x80), 1);
+        EXPECT_EQ(m.find(0x80)->second, 3);
+        EXPECT_EQ(m.count(0xc0), 0);
+    }
+
+    UnitTest::setCase("Probe runs that wrap around");
+    {
+        // Three keys with the same home, the last slot, so two of them
+        // are placed at the start of the table
+        vector<Addr> keys = lastSlotKeys(3);
+        AddrHashMap<int> m;
+        for (int i = 0; i < 3; ++i)
+            m[keys[i]] = i;
+
+        for (int i = 0; i < 3; ++i) {
+            auto it = m.find(keys[i]);
+            EXPECT_TRUE(it != m.end());
+            EXPECT_EQ(it->second, i);
+        }
+
+        // Erasing the head of the run shifts the others back across
+        // the end of the table
+        EXPECT_EQ(m.erase(keys[0]), 1);
+        EXPECT_EQ(m.erase(keys[0]), 0);
+        EXPECT_EQ(m.size(), 2);
+        EXPECT_TRUE(m.find(keys[0]) == m.end());
+        EXPECT_EQ(m.find(keys[1])->second, 1);
+        EXPECT_EQ(m.find(keys[2])->second, 2);
+
+        // Erase the middle of the run through an iterator
+        m[keys[0]] = 0;
+        m.erase(m.find(keys[2]));
+        EXPECT_EQ(m.size(), 2);
+        EXPECT_EQ(m.find(keys[0])->second, 0);
+        EXPECT_EQ(m.find(keys[1])->second, 1);
+        EXPECT_TRUE(m.find(keys[2]) == m.end());
+
+        // Iteration visits every entry once
+        int sum = 0;
+        for (auto &kv : m)
+            sum += kv.second + 1;
+        EXPECT_EQ(sum, 3);
+    }
+
+    UnitTest::setCase("Growth");
+    {
+        // Fill past the load factor of the initial table, including a
+        // wrapped run, so that the entries are rehashed several times
+        vector<Addr> keys = lastSlotKeys(4);
+        AddrHashMap<int> m;
+        for (int i = 0; i < 4; ++i)
+            m[keys[i]] = i;
+        for (int i = 0; i < 1000; ++i)
+            m[Addr(i + 1) << 12] = i;
+
+        EXPECT_EQ(m.size(), 1004);
+        for (int i = 0; i < 4; ++i)
+            EXPECT_EQ(m.find(keys[i])->second, i);
+        bool all_found = true;
+        for (int i = 0; i < 1000; ++i) {
+            auto it = m.find(Addr(i + 1) << 12);
+            all_found &= it != m.end() && it->second == i;
+        }
+        EXPECT_TRUE(all_found);
+
+        size_t n = 0;
+        for (auto it = m.begin(); it != m.end(); ++it)
+            ++n;
+        EXPECT_EQ(n, 1004);
+
+        m.clear();
+        EXPECT_TRUE(m.empty());
+        EXPECT_TRUE(m.find(keys[0]) == m.end());
+        EXPECT_TRUE(m.begin() == m.end());
+    }
+
+    UnitTest::setCase("Random operations against std::map");
+    {
+        mt19937_64 rng(1);
+        AddrHashMap<int> m;
+        map<Addr, int> ref;
+        bool match = true;
+        for (int i = 0; i < 200000 && match; ++i) {
+            Addr key = (rng() % 3000) << 6;
+            switch (rng() % 4) {
+              case 0:
+                match &= m.insert(make_pair(key, i)).second ==
+                    ref.insert(make_pair(key, i)).second;
+                break;
+              case 1:
+                match &= m.erase(key) == ref.erase(key);
+                break;
+              case 2:
+                {
+                    auto it = m.find(key);
+                    match &= (it != m.end()) == (ref.count(key) == 1);
+                    if (it != m.end()) {
+                        match &= it->second == ref[key];
+                        m.erase(it);
+                        ref.erase(key);
+                    }
+                }
+                break;
+              default:
+                m[key] += 1;
+                ref[key] += 1;
+                break;
+            }
+            match &= m.size() == ref.size();
+        }
+
+        size_t n = 0;
+        for (const auto &kv : m) {
+            ++n;
+            auto it = ref.find(kv.first);
+            match &= it != ref.end() && it->second == kv.second;
+        }
+        EXPECT_TRUE(match);
+        EXPECT_EQ(n, ref.size());
+    }
+
+    return UnitTest::printResults();
+}
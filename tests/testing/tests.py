@@ -151,9 +151,11 @@ generic_configs = (
     'o3-timing-mp',
 
     'rubytest',
+    'rubytest-sparse',
     'memcheck',
     'memtest',
     'memtest-filter',
+    'memtest-sector',
     'tgen-simple-mem',
     'tgen-dram-ctrl',
     'dram-lowp',
@@ -102,9 +102,12 @@ def main():
             ascii_out.write('%s,%s,%s,%s' % (cmd, packet.addr, packet.size,
                                            packet.tick))
         if packet.HasField('pc'):
-            ascii_out.write(',%s\n' % (packet.pc))
-        else:
-            ascii_out.write('\n')
+            ascii_out.write(',%s' % (packet.pc))
+        # traces captured by a DRAM controller have the burst location
+        if packet.HasField('bank'):
+            ascii_out.write(',%s,%s,%s' % (packet.rank, packet.bank,
+                                           packet.row))
+        ascii_out.write('\n')
 
     print "Parsed packets:", num_packets
 
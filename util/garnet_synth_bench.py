@@ -0,0 +1,263 @@
+#!/usr/bin/env python2
+
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script benchmarks the garnet network with synthetic traffic. For
+# every topology in configs/topologies and every traffic pattern, it
+# sweeps the injection rate of garnet_synth_traffic.py, and then
+# bisects between the last unsaturated and the first saturated rate to
+# find the saturation throughput. The network is deemed saturated once
+# the average packet latency exceeds a multiple of the zero-load
+# latency. Each point is a separate gem5 run, and the latency-throughput
+# curves are written to a JSON file together with the host simulation
+# speed in flits per second, for regression testing of the network
+# model and of its performance.
+
+from __future__ import print_function
+
+import argparse
+import json
+import multiprocessing
+import os
+import re
+import subprocess
+import sys
+
+gem5_root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+config = os.path.join(gem5_root, "configs", "example",
+                      "garnet_synth_traffic.py")
+topology_dir = os.path.join(gem5_root, "configs", "topologies")
+
+def find_topologies():
+    """All topologies a garnet_synth_traffic.py run can build"""
+    topologies = []
+    for name in sorted(os.listdir(topology_dir)):
+        base, ext = os.path.splitext(name)
+        if ext != ".py":
+            continue
+        with open(os.path.join(topology_dir, name)) as f:
+            if re.search(r"^class %s\(SimpleTopology\)" % base, f.read(),
+                         re.MULTILINE):
+                topologies.append(base)
+    return topologies
+
+parser = argparse.ArgumentParser(
+  formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+
+parser.add_argument("--gem5",
+                    default=os.path.join(gem5_root, "build",
+                                         "Garnet_standalone", "gem5.opt"),
+                    help="gem5 binary built with the Garnet_standalone "
+                    "protocol")
+
+parser.add_argument("--topologies", default="all",
+                    help="space-separated list of topologies, or \"all\" "
+                    "for: %s" % " ".join(find_topologies()))
+
+parser.add_argument("--traffic",
+                    default="uniform_random transpose bit_complement "
+                    "hotspot tornado",
+                    help="space-separated list of traffic patterns")
+
+parser.add_argument("--num-cpus", type=int, default=16,
+                    help="number of traffic injectors")
+
+parser.add_argument("--mesh-rows", type=int, default=4,
+                    help="rows of the mesh topologies")
+
+parser.add_argument("--sim-cycles", type=int, default=10000,
+                    help="cycles simulated per point")
+
+parser.add_argument("--rate-step", type=float, default=0.05,
+                    help="step of the injection rate sweep, in packets "
+                    "per node per cycle")
+
+parser.add_argument("--precision", type=int, default=3,
+                    help="digits after the decimal point of the "
+                    "saturation rate")
+
+parser.add_argument("--saturation-factor", type=float, default=3.0,
+                    help="latency, relative to the zero-load latency, "
+                    "beyond which the network is saturated")
+
+parser.add_argument("--jobs", type=int, default=1,
+                    help="number of topology and traffic pairs to "
+                    "benchmark concurrently, note that this affects "
+                    "the host speed that is measured")
+
+parser.add_argument("--outdir", default="garnet_bench",
+                    help="directory for the gem5 runs and the results")
+
+parser.add_argument("--json", default="garnet_bench.json",
+                    help="name of the results file in the output directory")
+
+parser.add_argument("extra", nargs=argparse.REMAINDER,
+                    help="further options passed on to "
+                    "garnet_synth_traffic.py, after a --")
+
+args = parser.parse_args()
+
+if args.topologies == "all":
+    topologies = find_topologies()
+else:
+    topologies = args.topologies.split()
+
+traffic_patterns = args.traffic.split()
+extra = [a for a in args.extra if a != "--"]
+
+def run_point(topology, traffic, rate):
+    """Simulate one injection rate and return its point of the curve"""
+
+    outdir = os.path.join(args.outdir, topology, traffic,
+                          "%.*f" % (args.precision, rate))
+    # The directories sit in the corners of a MeshDirCorners mesh
+    num_dirs = 4 if topology == "MeshDirCorners_XY" else args.num_cpus
+
+    cmd = [args.gem5, "-d", outdir, config,
+           "--network=garnet2.0",
+           "--topology=%s" % topology,
+           "--num-cpus=%d" % args.num_cpus,
+           "--num-dirs=%d" % num_dirs,
+           "--mesh-rows=%d" % args.mesh_rows,
+           "--synthetic=%s" % traffic,
+           "--injectionrate=%.*f" % (args.precision, rate),
+           "--precision=%d" % args.precision,
+           "--sim-cycles=%d" % args.sim_cycles] + extra
+
+    with open(os.devnull, "w") as devnull:
+        subprocess.check_call(cmd, stdout=devnull, stderr=devnull)
+
+    stats = {}
+    with open(os.path.join(outdir, "stats.txt")) as f:
+        for line in f:
+            if line.startswith("---------- End Simulation Statistics"):
+                break
+            fields = line.split()
+            if len(fields) >= 2:
+                stats[fields[0]] = fields[1]
+
+    def stat(name):
+        return float(stats.get(name, "0").replace("nan", "0"))
+
+    net = "system.ruby.network."
+    packets = stat(net + "packets_received::total")
+    flits = stat(net + "flits_received::total")
+    host_seconds = stat("host_seconds")
+
+    return {
+        "injection_rate": rate,
+        "reception_rate": packets / args.num_cpus / args.sim_cycles,
+        "packet_latency": stat(net + "average_packet_latency"),
+        "network_latency": stat(net + "average_packet_network_latency"),
+        "queueing_latency": stat(net + "average_packet_queueing_latency"),
+        "hops": stat(net + "average_hops"),
+        "flits": flits,
+        "host_seconds": host_seconds,
+        "flits_per_host_second": flits / host_seconds if host_seconds else 0,
+    }
+
+def benchmark(pair):
+    """Sweep and bisect the injection rate of one topology and traffic"""
+
+    topology, traffic = pair
+    resolution = 10 ** -args.precision
+    points = []
+
+    def point(rate):
+        p = run_point(topology, traffic, rate)
+        points.append(p)
+        print("%s %s rate %.*f latency %.1f" %
+              (topology, traffic, args.precision, rate, p["packet_latency"]))
+        return p
+
+    zero_load = point(resolution)["packet_latency"]
+
+    def saturated(p):
+        return p["packet_latency"] > args.saturation_factor * zero_load or \
+            p["reception_rate"] == 0
+
+    # Coarse sweep up to the first saturated rate
+    low, high = resolution, None
+    rate = args.rate_step
+    while rate <= 1.0:
+        if saturated(point(rate)):
+            high = rate
+            break
+        low = rate
+        rate = round(rate + args.rate_step, args.precision)
+
+    # Bisect to the resolution of the injection rate
+    if high is not None:
+        while high - low > resolution * 1.5:
+            mid = round((low + high) / 2, args.precision)
+            if saturated(point(mid)):
+                high = mid
+            else:
+                low = mid
+
+    points.sort(key=lambda p: p["injection_rate"])
+    flits = sum(p["flits"] for p in points)
+    host_seconds = sum(p["host_seconds"] for p in points)
+
+    return topology, traffic, {
+        "zero_load_latency": zero_load,
+        "saturation_rate": low,
+        "saturated": high is not None,
+        "flits_per_host_second": flits / host_seconds if host_seconds else 0,
+        "curve": points,
+    }
+
+if not os.path.isfile(args.gem5):
+    sys.exit("gem5 binary %s not found" % args.gem5)
+
+pairs = [(t, p) for t in topologies for p in traffic_patterns]
+if args.jobs > 1:
+    pool = multiprocessing.Pool(args.jobs)
+    outcome = pool.map(benchmark, pairs)
+    pool.close()
+else:
+    outcome = map(benchmark, pairs)
+
+results = {}
+for topology, traffic, result in outcome:
+    results.setdefault(topology, {})[traffic] = result
+
+if not os.path.isdir(args.outdir):
+    os.makedirs(args.outdir)
+with open(os.path.join(args.outdir, args.json), "w") as f:
+    json.dump(results, f, indent=2, sort_keys=True)
+
+print()
+print("%-20s %-16s %12s %12s %14s" % ("topology", "traffic", "zero-load",
+                                     "saturation", "flits/s"))
+for topology in sorted(results):
+    for traffic in sorted(results[topology]):
+        r = results[topology][traffic]
+        print("%-20s %-16s %12.1f %11.*f%s %14.0f" %
+              (topology, traffic, r["zero_load_latency"], args.precision,
+               r["saturation_rate"], "" if r["saturated"] else "+",
+               r["flits_per_host_second"]))
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Microbenchmark of the lookups of Ruby's AddrHashMap against
+ * std::unordered_map. Each table holds n random line addresses and is
+ * queried with a fixed stream of addresses of which half are present.
+ *
+ * Build from the top of the gem5 tree with:
+ *   g++ -std=c++11 -O2 -I src -o addrhashmap_bench \
+ *       util/ruby_addrhashmap_bench.cc
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "mem/ruby/common/AddrHashMap.hh"
+
+using namespace std;
+
+static const int repeats = 20;
+static const size_t queries = 1000000;
+
+template <class Map>
+static double
+lookupTime(Map &m, const vector<Addr> &keys, const vector<Addr> &q,
+           long &sum)
+{
+    for (size_t i = 0; i < keys.size(); ++i)
+        m[keys[i]] = i;
+
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        for (Addr a : q) {
+            auto it = m.find(a);
+            if (it != m.end())
+                sum += it->second;
+        }
+    }
+    auto stop = chrono::steady_clock::now();
+
+    return chrono::duration<double, nano>(stop - start).count() /
+        (repeats * q.size());
+}
+
+int
+main()
+{
+    printf("%10s %16s %16s\n", "entries", "unordered_map", "AddrHashMap");
+
+    for (size_t n : {512, 32768, 262144}) {
+        mt19937_64 rng(1);
+        auto line = [&rng]() { return Addr(rng() % (1ULL << 34)) << 6; };
+
+        vector<Addr> keys, q;
+        for (size_t i = 0; i < n; ++i)
+            keys.push_back(line());
+        for (size_t i = 0; i < queries; ++i)
+            q.push_back(rng() % 2 ? keys[rng() % n] : line());
+
+        // Keep the sum live so that the lookups are not optimised away
+        long sum = 0;
+        unordered_map<Addr, int> u;
+        AddrHashMap<int> a(n);
+        double tu = lookupTime(u, keys, q, sum);
+        double ta = lookupTime(a, keys, q, sum);
+        printf("%10zu %13.1f ns %13.1f ns\n", n, tu, ta);
+        if (sum == 0)
+            printf("no hits\n");
+    }
+
+    return 0;
+}
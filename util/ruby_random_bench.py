@@ -0,0 +1,116 @@
+#!/usr/bin/env python2
+
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script measures the host speed of the Ruby random tester. It runs
+# configs/example/ruby_random_test.py on one or more gem5 binaries, for
+# instance one built before and one after a change to the Ruby core,
+# takes the fastest of a number of repetitions of each, and reports the
+# host seconds and the speedup of every binary relative to the first
+# one. The binaries should be built with the same protocol, by default
+# MESI_Two_Level.
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+gem5_root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+config = os.path.join(gem5_root, "configs", "example",
+                      "ruby_random_test.py")
+
+parser = argparse.ArgumentParser(
+  formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+
+parser.add_argument("gem5", nargs="*",
+                    default=[os.path.join(gem5_root, "build",
+                                          "MESI_Two_Level", "gem5.opt")],
+                    help="gem5 binaries to compare, the first one is the "
+                    "baseline")
+
+parser.add_argument("--num-cpus", type=int, default=8,
+                    help="number of testers")
+
+parser.add_argument("--maxloads", type=int, default=100000,
+                    help="loads to complete per run")
+
+parser.add_argument("--repeat", type=int, default=3,
+                    help="runs per binary, the fastest one is reported")
+
+parser.add_argument("--outdir", default="ruby_random_bench",
+                    help="directory for the gem5 runs and the results")
+
+parser.add_argument("--json", default="ruby_random_bench.json",
+                    help="name of the results file in the output directory")
+
+args = parser.parse_args()
+
+def run(index, gem5, repetition):
+    """Run the tester once and return its host seconds"""
+
+    outdir = os.path.join(args.outdir, str(index), str(repetition))
+    cmd = [gem5, "-d", outdir, config,
+           "--num-cpus=%d" % args.num_cpus,
+           "--maxloads=%d" % args.maxloads]
+
+    with open(os.devnull, "w") as devnull:
+        subprocess.check_call(cmd, stdout=devnull, stderr=devnull)
+
+    with open(os.path.join(outdir, "stats.txt")) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) >= 2 and fields[0] == "host_seconds":
+                return float(fields[1])
+    sys.exit("no host_seconds in %s" % outdir)
+
+for gem5 in args.gem5:
+    if not os.path.isfile(gem5):
+        sys.exit("gem5 binary %s not found" % gem5)
+
+results = []
+for index, gem5 in enumerate(args.gem5):
+    times = [run(index, gem5, r) for r in range(args.repeat)]
+    results.append({
+        "gem5": gem5,
+        "host_seconds": min(times),
+        "runs": times,
+    })
+
+for r in results:
+    r["speedup"] = results[0]["host_seconds"] / r["host_seconds"]
+
+if not os.path.isdir(args.outdir):
+    os.makedirs(args.outdir)
+with open(os.path.join(args.outdir, args.json), "w") as f:
+    json.dump(results, f, indent=2)
+
+print("%-50s %12s %8s" % ("gem5", "host s", "speedup"))
+for r in results:
+    print("%-50s %12.2f %7.2fx" % (r["gem5"], r["host_seconds"], r["speedup"]))